@@ -0,0 +1,110 @@
+/**
+ * @file        buffer_pool.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef BUFFER_POOL_H
+#define BUFFER_POOL_H
+
+#include <iostream>
+#include <vector>
+#include <map>
+#include <string>
+#include <mutex>
+#include <limits>
+
+#include <libKitsunemimiCommon/logger.h>
+
+#define __CL_ENABLE_EXCEPTIONS
+#include <CL/cl2.hpp>
+
+namespace Kitsunemimi
+{
+
+class BufferPool
+{
+public:
+    BufferPool();
+    ~BufferPool();
+
+    bool getPinnedMemory(const cl::Context &context,
+                         const cl::CommandQueue &queue,
+                         const uint64_t numberOfBytes,
+                         cl::Buffer &pinnedBuffer,
+                         void* &data,
+                         ErrorContainer &error);
+    void releasePinnedMemory(const cl::Buffer &pinnedBuffer,
+                             const cl::CommandQueue &queue,
+                             void* data,
+                             const uint64_t numberOfBytes);
+
+    bool getDeviceBuffer(const cl::Context &context,
+                         const uint64_t numberOfBytes,
+                         cl::Buffer &deviceBuffer,
+                         ErrorContainer &error);
+    void releaseDeviceBuffer(const cl::Buffer &deviceBuffer,
+                             const uint64_t numberOfBytes);
+
+    void* getHostMemory(const uint64_t numberOfBytes);
+    void releaseHostMemory(void* data,
+                           const uint64_t numberOfBytes);
+
+    bool clear(const cl::CommandQueue &queue);
+
+    void setLimits(const uint64_t maxHostBytes,
+                   const uint64_t maxDeviceBytes);
+    void trim(const uint64_t maxHostBytes = 0,
+              const uint64_t maxDeviceBytes = 0);
+
+    uint64_t getNumberOfPooledPinnedBuffers() const;
+    uint64_t getNumberOfPooledDeviceBuffers() const;
+    uint64_t getNumberOfPooledHostBuffers() const;
+    uint64_t getNumberOfPooledHostBytes() const;
+    uint64_t getNumberOfPooledDeviceBytes() const;
+
+private:
+    struct PinnedEntry
+    {
+        cl::Buffer buffer;
+        cl::CommandQueue queue;
+        void* data = nullptr;
+    };
+
+    std::multimap<uint64_t, PinnedEntry> m_pinnedMemory;
+    std::multimap<uint64_t, cl::Buffer> m_deviceBuffers;
+    std::multimap<uint64_t, void*> m_hostMemory;
+
+    // pinned memory and host-memory are counted together as host-bytes
+    uint64_t m_hostBytes = 0;
+    uint64_t m_deviceBytes = 0;
+
+    uint64_t m_maxHostBytes = std::numeric_limits<uint64_t>::max();
+    uint64_t m_maxDeviceBytes = std::numeric_limits<uint64_t>::max();
+
+    void evict(const uint64_t maxHostBytes,
+               const uint64_t maxDeviceBytes);
+
+    // the pool is shared by all threads, which are using the interface
+    mutable std::mutex m_lock;
+};
+
+}
+
+#endif // BUFFER_POOL_H
@@ -0,0 +1,110 @@
+/**
+ * @file        gpu_command_graph.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef GPU_COMMAND_GRAPH_H
+#define GPU_COMMAND_GRAPH_H
+
+#include <iostream>
+#include <vector>
+#include <string>
+
+#include <libKitsunemimiOpencl/gpu_data.h>
+#include <libKitsunemimiOpencl/gpu_event.h>
+#include <libKitsunemimiCommon/logger.h>
+
+#define __CL_ENABLE_EXCEPTIONS
+#include <CL/cl2.hpp>
+
+namespace Kitsunemimi
+{
+class GpuInterface;
+
+class GpuCommandGraph
+{
+public:
+    static constexpr uint32_t INVALID_STEP = 0xFFFFFFFF;
+
+    GpuCommandGraph(GpuInterface* gpuInterface,
+                    GpuData* data);
+
+    // recording
+    uint32_t addUpdate(const std::string &bufferName,
+                       ErrorContainer &error,
+                       const std::vector<uint32_t> &dependencies = {},
+                       uint64_t numberOfObjects = 0,
+                       const uint64_t offset = 0);
+    uint32_t addRun(const std::string &kernelName,
+                    ErrorContainer &error,
+                    const std::vector<uint32_t> &dependencies = {});
+    uint32_t addCopyFromDevice(const std::string &bufferName,
+                               ErrorContainer &error,
+                               const std::vector<uint32_t> &dependencies = {},
+                               uint64_t numberOfObjects = 0,
+                               const uint64_t offset = 0);
+    void clear();
+
+    // replay
+    bool launch(GpuEvent &event,
+                ErrorContainer &error);
+    bool launchAndWait(ErrorContainer &error);
+
+    uint64_t getNumberOfSteps() const;
+
+private:
+    enum StepType
+    {
+        UPDATE_STEP,
+        RUN_STEP,
+        COPY_FROM_DEVICE_STEP,
+    };
+
+    struct Step
+    {
+        StepType type = RUN_STEP;
+        GpuData::WorkerBuffer* buffer = nullptr;
+        GpuData::KernelDef* kernel = nullptr;
+        uint64_t offset = 0;
+        uint64_t size = 0;
+        std::vector<uint32_t> dependencies;
+        std::vector<cl::Event> waitList;
+        cl::Event event;
+        bool hasEvent = false;
+    };
+
+    GpuInterface* m_interface = nullptr;
+    GpuData* m_data = nullptr;
+    std::vector<Step> m_steps;
+    std::vector<cl::Event> m_finalWaitList;
+
+    bool checkDependencies(const std::vector<uint32_t> &dependencies,
+                           ErrorContainer &error);
+    bool prepareTransferStep(Step &step,
+                             const std::string &bufferName,
+                             uint64_t numberOfObjects,
+                             const uint64_t offset,
+                             ErrorContainer &error);
+    const std::vector<cl::Event>* prepareWaitList(Step &step);
+};
+
+}
+
+#endif // GPU_COMMAND_GRAPH_H
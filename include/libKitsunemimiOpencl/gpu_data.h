@@ -27,6 +27,8 @@
 #include <vector>
 #include <map>
 #include <string>
+#include <mutex>
+#include <shared_mutex>
 
 #include <libKitsunemimiCommon/buffer/data_buffer.h>
 
@@ -36,6 +38,11 @@
 namespace Kitsunemimi
 {
 class GpuInterface;
+class BufferPool;
+class GpuCommandGraph;
+class GpuStreamExecutor;
+class GpuWorkSplitter;
+class GpuJobScheduler;
 
 struct WorkerDim
 {
@@ -44,13 +51,66 @@ struct WorkerDim
     uint64_t z = 1;
 };
 
+enum MapMode
+{
+    MAP_READ,
+    MAP_WRITE,
+    MAP_WRITE_INVALIDATE,
+};
+
+struct BufferRegion
+{
+    // position and size in number of objects in x-direction and in number of rows and slices
+    // in y- and z-direction
+    WorkerDim origin = {0, 0, 0};
+    WorkerDim size = {1, 1, 1};
+
+    // number of objects of a row and of a slice (0 = calculate from the size of the region)
+    uint64_t rowPitch = 0;
+    uint64_t slicePitch = 0;
+};
+
+struct ArenaEntry
+{
+    std::string name = "";
+    uint64_t numberOfObjects = 0;
+    uint64_t objectSize = 0;
+};
+
+struct KernelBuildOptions
+{
+    // preprocessor-defines, which are given as -D name=value to the compiler (empty value = only
+    // -D name)
+    std::map<std::string, std::string> defines;
+    // additional compiler-flags like -cl-fast-relaxed-math, which are used in the given order
+    std::vector<std::string> flags;
+};
+
+struct BufferHandle
+{
+    uint32_t id = 0xFFFFFFFF;
+    uint32_t generation = 0;
+};
+
+struct KernelHandle
+{
+    uint32_t id = 0xFFFFFFFF;
+    uint32_t generation = 0;
+};
+
 class GpuData
 {
 public:
     WorkerDim numberOfWg;
     WorkerDim threadsPerWg;
+    WorkerDim globalOffset = {0, 0, 0};
+
+    GpuData(BufferPool* bufferPool = nullptr);
 
-    GpuData();
+    // handles and bindings are pointers into the own maps, so a copy would point into the
+    // original object
+    GpuData(const GpuData &) = delete;
+    GpuData& operator=(const GpuData &) = delete;
 
     bool addBuffer(const std::string &name,
                    const uint64_t numberOfObjects,
@@ -60,36 +120,84 @@ public:
     bool containsBuffer(const std::string &name);
     void* getBufferData(const std::string &name);
 
+    BufferHandle getBufferHandle(const std::string &name);
+    KernelHandle getKernelHandle(const std::string &name);
+
 private:
     friend GpuInterface;
+    friend GpuCommandGraph;
+    friend GpuStreamExecutor;
+    friend GpuWorkSplitter;
+    friend GpuJobScheduler;
 
     struct WorkerBuffer
     {
+        std::string name = "";
         void* data = nullptr;
         uint64_t numberOfBytes = 0;
         uint64_t numberOfObjects = 0;
+        uint64_t objectSize = 0;
         bool useHostPtr = false;
+        bool usePinnedMemory = false;
         bool allowBufferDeleteAfterClose = true;
+        // pool, from which the host-memory was taken (nullptr = allocated with alignedMalloc)
+        BufferPool* hostMemoryPool = nullptr;
         cl::Buffer clBuffer;
+        cl::Buffer pinnedBuffer;
+        void* mappedData = nullptr;
+        WorkerBuffer* arena = nullptr;
+        uint64_t arenaOffset = 0;
+        cl::Event lastEvent;
+        bool hasLastEvent = false;
     };
 
     struct KernelDef
     {
         std::string id = "";
         std::string kernelCode = "";
+        std::string buildOptions = "";
+        cl::Program program;
         cl::Kernel kernel;
         std::map<std::string, uint32_t> arguments;
+        std::map<std::string, uint64_t> valueSizes;
+        std::vector<WorkerBuffer*> boundBuffers;
         uint32_t localBufferSize = 0;
         uint32_t argumentCounter = 0;
+        // hash of the kernel for the work-group tuning (0 = not calculated yet)
+        uint64_t tuningHash = 0;
+    };
+
+    // lock for the maps and handles
+    struct DataLock
+    {
+        std::shared_mutex mutex;
     };
 
     std::map<std::string, WorkerBuffer> m_buffer;
     std::map<std::string, KernelDef> m_kernel;
+    mutable DataLock m_lock;
+    BufferPool* m_bufferPool = nullptr;
+
+    std::vector<WorkerBuffer*> m_bufferHandles;
+    std::vector<KernelDef*> m_kernelHandles;
+    uint32_t m_bufferHandleGeneration = 0;
+    uint32_t m_kernelHandleGeneration = 0;
 
     WorkerBuffer* getBuffer(const std::string &name);
+    WorkerBuffer* getBuffer(const BufferHandle &handle);
+    WorkerBuffer* insertBuffer(const std::string &name,
+                               const WorkerBuffer &buffer);
+    void clearBuffer();
 
     bool containsKernel(const std::string &name);
     KernelDef* getKernel(const std::string &name);
+    KernelDef* getKernel(const KernelHandle &handle);
+    KernelDef* insertKernel(const std::string &name,
+                            const KernelDef &kernelDef);
+    void clearKernel();
+
+    WorkerBuffer* findBuffer(const std::string &name);
+    KernelDef* findKernel(const std::string &name);
 
     uint32_t getArgPosition(KernelDef* kernelDef,
                             const std::string &bufferName);
@@ -0,0 +1,59 @@
+/**
+ * @file        gpu_event.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef GPU_EVENT_H
+#define GPU_EVENT_H
+
+#include <iostream>
+#include <vector>
+#include <string>
+
+#define __CL_ENABLE_EXCEPTIONS
+#include <CL/cl2.hpp>
+
+namespace Kitsunemimi
+{
+class GpuInterface;
+class GpuCommandGraph;
+
+class GpuEvent
+{
+public:
+    GpuEvent();
+
+    bool wait();
+    bool isFinished();
+    bool isActive() const;
+
+    static bool waitForAll(std::vector<GpuEvent> &events);
+
+private:
+    friend GpuInterface;
+    friend GpuCommandGraph;
+
+    cl::Event m_event;
+    bool m_isActive = false;
+};
+
+}
+
+#endif // GPU_EVENT_H
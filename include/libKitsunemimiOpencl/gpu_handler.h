@@ -37,11 +37,27 @@ namespace Kitsunemimi
 {
 class GpuInterface;
 
+struct DeviceFilter
+{
+    // bit-mask of allowed device-types
+    cl_device_type deviceType = CL_DEVICE_TYPE_ALL;
+    // part of the device-name (empty = all names)
+    std::string name = "";
+    uint64_t minGlobalMemory = 0;
+    uint64_t minComputeUnits = 0;
+    // maximum number of interfaces, which are created for the best devices (0 = all)
+    uint64_t maxNumberOfDevices = 0;
+};
+
 class GpuHandler
 {
 public:
     GpuHandler();
-    bool initDevice(ErrorContainer &error);
+    bool initDevice(ErrorContainer &error,
+                    const bool sharedContext = false);
+    bool initDevice(const DeviceFilter &filter,
+                    ErrorContainer &error,
+                    const bool sharedContext = false);
 
     std::vector<GpuInterface*> m_interfaces;
 
@@ -49,7 +65,12 @@ private:
     bool m_isInit = false;
     std::vector<cl::Platform> m_platform;
 
-    void collectDevices();
+    void collectDevices(const DeviceFilter &filter,
+                        const bool sharedContext);
+    bool matchFilter(const cl::Device &device,
+                     const DeviceFilter &filter);
+    bool isBetterDevice(const cl::Device &first,
+                        const cl::Device &second);
 };
 
 }
@@ -27,23 +27,52 @@
 #include <vector>
 #include <map>
 #include <string>
+#include <future>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <atomic>
+#include <type_traits>
 
 #define __CL_ENABLE_EXCEPTIONS
 #include <CL/cl2.hpp>
 
 #include <libKitsunemimiOpencl/gpu_data.h>
+#include <libKitsunemimiOpencl/gpu_event.h>
+#include <libKitsunemimiOpencl/buffer_pool.h>
+#include <libKitsunemimiOpencl/gpu_profiler.h>
 #include <libKitsunemimiCommon/logger.h>
 
 namespace Kitsunemimi
 {
+class ProgramCache;
+class GpuTracer;
+class WorkGroupTuner;
+class GpuCommandGraph;
 
 class GpuInterface
 {
 public:
-    GpuInterface(const cl::Device &device);
+    GpuInterface(const cl::Device &device,
+                 const bool lazyInit = false);
+    GpuInterface(const cl::Device &device,
+                 const cl::Context &context,
+                 const bool lazyInit = false);
     ~GpuInterface();
 
+    bool initContext(ErrorContainer &error);
+    bool isInitialized() const;
+
     // initializing
+    bool addPinnedBuffer(GpuData &data,
+                         const std::string &name,
+                         const uint64_t numberOfObjects,
+                         const uint64_t objectSize,
+                         ErrorContainer &error);
+    bool addArena(GpuData &data,
+                  const std::string &arenaName,
+                  const std::vector<ArenaEntry> &entries,
+                  ErrorContainer &error);
     bool initCopyToDevice(GpuData &data,
                           ErrorContainer &error);
 
@@ -51,6 +80,29 @@ public:
                    const std::string &kernelName,
                    const std::string &kernelCode,
                    ErrorContainer &error);
+    bool addKernel(GpuData &data,
+                   const std::string &kernelName,
+                   const std::string &kernelCode,
+                   const KernelBuildOptions &options,
+                   ErrorContainer &error);
+    bool addKernels(GpuData &data,
+                    const std::string &kernelCode,
+                    ErrorContainer &error);
+    bool addKernels(GpuData &data,
+                    const std::string &kernelCode,
+                    const KernelBuildOptions &options,
+                    ErrorContainer &error);
+    bool addKernelAsync(GpuData &data,
+                        const std::string &kernelName,
+                        const std::string &kernelCode,
+                        ErrorContainer &error);
+    bool addKernelAsync(GpuData &data,
+                        const std::string &kernelName,
+                        const std::string &kernelCode,
+                        const KernelBuildOptions &options,
+                        ErrorContainer &error);
+    bool waitForKernels(GpuData &data,
+                        ErrorContainer &error);
     bool bindKernelToBuffer(GpuData &data,
                             const std::string &kernelName,
                             const std::string &bufferName,
@@ -59,24 +111,266 @@ public:
                         const std::string &kernelName,
                         const uint32_t localMemorySize,
                         ErrorContainer &error);
+    bool setKernelArgument(GpuData &data,
+                           const std::string &kernelName,
+                           const std::string &argName,
+                           const void* value,
+                           const uint64_t valueSize,
+                           ErrorContainer &error);
+    bool setKernelArgument(GpuData &data,
+                           const KernelHandle &handle,
+                           const std::string &argName,
+                           const void* value,
+                           const uint64_t valueSize,
+                           ErrorContainer &error);
+
+    /**
+     * @brief set a scalar or a POD-struct as value-argument of a kernel. See the untyped variant
+     *        for the handling of the argument-position.
+     *
+     * @param data object with all data
+     * @param kernelName name of the kernel
+     * @param argName name of the argument
+     * @param value value, which is copied into the argument
+     * @param error reference for error-output
+     *
+     * @return true, if successful, else false
+     */
+    template<typename T>
+    bool setKernelArgument(GpuData &data,
+                           const std::string &kernelName,
+                           const std::string &argName,
+                           const T &value,
+                           ErrorContainer &error)
+    {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "kernel-arguments must be trivially copyable");
+        static_assert(std::is_pointer<T>::value == false,
+                      "host-pointer can not be used as kernel-argument");
+
+        return setKernelArgument(data, kernelName, argName, &value, sizeof(T), error);
+    }
+
+    /**
+     * @brief set a scalar or a POD-struct as value-argument of a kernel by the handle of the kernel
+     *
+     * @param data object with all data
+     * @param handle handle of the kernel
+     * @param argName name of the argument
+     * @param value value to set
+     * @param error reference for error-output
+     *
+     * @return true, if successful, else false
+     */
+    template<typename T>
+    bool setKernelArgument(GpuData &data,
+                           const KernelHandle &handle,
+                           const std::string &argName,
+                           const T &value,
+                           ErrorContainer &error)
+    {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "kernel-arguments must be trivially copyable");
+        static_assert(std::is_pointer<T>::value == false,
+                      "host-pointer can not be used as kernel-argument");
+
+        return setKernelArgument(data, handle, argName, &value, sizeof(T), error);
+    }
 
     bool closeDevice(GpuData &data);
 
+    // queue-handling
+    bool enableSeparateQueues(const uint32_t numberOfComputeQueues,
+                              ErrorContainer &error);
+    bool useSeparateQueues() const;
+    bool enablePerThreadQueues(ErrorContainer &error);
+    bool usePerThreadQueues() const;
+    uint64_t getNumberOfThreadQueues();
+    bool releaseThreadQueue();
+
+    // profiling
+    bool enableProfiling(ErrorContainer &error);
+    bool getProfilingStats(const ProfilingType type,
+                           const std::string &name,
+                           ProfilingStats &stats,
+                           ErrorContainer &error);
+    void resetProfiling();
+
+    // tracing
+    bool enableTracing(ErrorContainer &error);
+    bool writeTrace(const std::string &filePath,
+                    ErrorContainer &error);
+
+    // program-cache
+    bool enableProgramCache(const std::string &cacheDirectory,
+                            ErrorContainer &error);
+    uint64_t getNumberOfProgramCacheHits();
+    uint64_t getNumberOfProgramCacheMisses();
+    uint64_t getNumberOfProgramVariants();
+
+    // work-group tuning
+    bool enableWorkGroupTuning(const std::string &resultDirectory,
+                               ErrorContainer &error);
+    bool tuneWorkGroupSize(GpuData &data,
+                           const std::string &kernelName,
+                           ErrorContainer &error,
+                           const uint32_t numberOfRuns = 5);
+    bool calculateRange(GpuData &data,
+                        const std::string &kernelName,
+                        const WorkerDim &problemSize,
+                        ErrorContainer &error,
+                        const WorkerDim &offset = {0, 0, 0});
+
     // runtime
     bool updateBufferOnDevice(GpuData &data,
                               const std::string &bufferName,
                               ErrorContainer &error,
                               uint64_t numberOfObjects = 0,
                               const uint64_t offset = 0);
+    bool updateBufferOnDevice(GpuData &data,
+                              const BufferHandle &handle,
+                              ErrorContainer &error,
+                              uint64_t numberOfObjects = 0,
+                              const uint64_t offset = 0);
+    bool updateBuffersOnDevice(GpuData &data,
+                               const std::vector<std::string> &bufferNames,
+                               ErrorContainer &error);
     bool run(GpuData &data,
              const std::string &kernelName,
              ErrorContainer &error);
+    bool run(GpuData &data,
+             const KernelHandle &handle,
+             ErrorContainer &error);
+    bool launch(GpuData &data,
+                const std::string &kernelName,
+                const WorkerDim &problemSize,
+                ErrorContainer &error,
+                const WorkerDim &offset = {0, 0, 0});
     bool copyFromDevice(GpuData &data,
                         const std::string &bufferName,
-                        ErrorContainer &error);
+                        ErrorContainer &error,
+                        uint64_t numberOfObjects = 0,
+                        const uint64_t offset = 0);
+    bool copyFromDevice(GpuData &data,
+                        const BufferHandle &handle,
+                        ErrorContainer &error,
+                        uint64_t numberOfObjects = 0,
+                        const uint64_t offset = 0);
+    bool updateRegionOnDevice(GpuData &data,
+                              const std::string &bufferName,
+                              const BufferRegion &region,
+                              ErrorContainer &error);
+    bool updateRegionOnDevice(GpuData &data,
+                              const BufferHandle &handle,
+                              const BufferRegion &region,
+                              ErrorContainer &error);
+    bool copyRegionFromDevice(GpuData &data,
+                              const std::string &bufferName,
+                              const BufferRegion &region,
+                              ErrorContainer &error);
+    bool copyRegionFromDevice(GpuData &data,
+                              const BufferHandle &handle,
+                              const BufferRegion &region,
+                              ErrorContainer &error);
+
+    // mapping
+    void* mapBuffer(GpuData &data,
+                    const std::string &bufferName,
+                    const MapMode mode,
+                    ErrorContainer &error);
+    void* mapBuffer(GpuData &data,
+                    const BufferHandle &handle,
+                    const MapMode mode,
+                    ErrorContainer &error);
+    bool unmapBuffer(GpuData &data,
+                     const std::string &bufferName,
+                     ErrorContainer &error);
+    bool unmapBuffer(GpuData &data,
+                     const BufferHandle &handle,
+                     ErrorContainer &error);
+
+    // asynchronous runtime
+    bool updateBufferOnDeviceAsync(GpuData &data,
+                                   const std::string &bufferName,
+                                   GpuEvent &event,
+                                   ErrorContainer &error,
+                                   uint64_t numberOfObjects = 0,
+                                   const uint64_t offset = 0);
+    bool updateBufferOnDeviceAsync(GpuData &data,
+                                   const BufferHandle &handle,
+                                   GpuEvent &event,
+                                   ErrorContainer &error,
+                                   uint64_t numberOfObjects = 0,
+                                   const uint64_t offset = 0);
+    bool updateBuffersOnDeviceAsync(GpuData &data,
+                                    const std::vector<std::string> &bufferNames,
+                                    GpuEvent &event,
+                                    ErrorContainer &error);
+    bool runAsync(GpuData &data,
+                  const std::string &kernelName,
+                  GpuEvent &event,
+                  ErrorContainer &error);
+    bool runAsync(GpuData &data,
+                  const KernelHandle &handle,
+                  GpuEvent &event,
+                  ErrorContainer &error);
+    bool launchAsync(GpuData &data,
+                     const std::string &kernelName,
+                     const WorkerDim &problemSize,
+                     GpuEvent &event,
+                     ErrorContainer &error,
+                     const WorkerDim &offset = {0, 0, 0});
+    bool copyFromDeviceAsync(GpuData &data,
+                             const std::string &bufferName,
+                             GpuEvent &event,
+                             ErrorContainer &error,
+                             uint64_t numberOfObjects = 0,
+                             const uint64_t offset = 0);
+    bool copyFromDeviceAsync(GpuData &data,
+                             const BufferHandle &handle,
+                             GpuEvent &event,
+                             ErrorContainer &error,
+                             uint64_t numberOfObjects = 0,
+                             const uint64_t offset = 0);
+    bool updateRegionOnDeviceAsync(GpuData &data,
+                                   const std::string &bufferName,
+                                   const BufferRegion &region,
+                                   GpuEvent &event,
+                                   ErrorContainer &error);
+    bool updateRegionOnDeviceAsync(GpuData &data,
+                                   const BufferHandle &handle,
+                                   const BufferRegion &region,
+                                   GpuEvent &event,
+                                   ErrorContainer &error);
+    bool copyRegionFromDeviceAsync(GpuData &data,
+                                   const std::string &bufferName,
+                                   const BufferRegion &region,
+                                   GpuEvent &event,
+                                   ErrorContainer &error);
+    bool copyRegionFromDeviceAsync(GpuData &data,
+                                   const BufferHandle &handle,
+                                   const BufferRegion &region,
+                                   GpuEvent &event,
+                                   ErrorContainer &error);
+
+    bool copyBufferOnDeviceAsync(GpuData &data,
+                                 const std::string &sourceBufferName,
+                                 const std::string &targetBufferName,
+                                 GpuEvent &event,
+                                 ErrorContainer &error);
+
+    // transfer between devices
+    bool copyToInterface(GpuData &data,
+                         const std::string &bufferName,
+                         GpuInterface &target,
+                         GpuData &targetData,
+                         const std::string &targetBufferName,
+                         ErrorContainer &error);
 
     // common getter
     const std::string getDeviceName();
+    bool sharesContext(const GpuInterface &other) const;
+    BufferPool* getBufferPool();
 
     // getter for memory information
     uint64_t getLocalMemorySize();
@@ -93,6 +387,185 @@ public:
     cl::CommandQueue m_queue;
 
 private:
+    friend GpuCommandGraph;
+
+    std::atomic<bool> m_isInit = false;
+    std::mutex m_initLock;
+    ProgramCache* m_programCache = nullptr;
+    WorkGroupTuner* m_workGroupTuner = nullptr;
+    GpuProfiler* m_profiler = nullptr;
+    GpuTracer* m_tracer = nullptr;
+    bool m_recordOperations = false;
+    std::mutex m_recordLock;
+    cl::Event m_profilingEvent;
+    cl_command_queue_properties m_queueProperties = 0;
+    BufferPool m_bufferPool;
+
+    struct BuildResult
+    {
+        bool success = false;
+        cl::Program program;
+        std::string errorMessage = "";
+    };
+
+    struct PendingBuild
+    {
+        GpuData* data = nullptr;
+        std::string kernelName = "";
+        std::string kernelCode = "";
+        std::string buildOptions = "";
+        std::shared_future<BuildResult> result;
+        uint64_t id = 0;
+    };
+
+    std::vector<PendingBuild> m_pendingBuilds;
+    uint64_t m_nextBuildId = 0;
+    std::mutex m_pendingBuildLock;
+
+    // compiled programs for each combination of source-code and build-options and the programs,
+    // which are still compiled, so another thread waits for them instead of compiling them again
+    std::map<std::string, cl::Program> m_programVariants;
+    std::map<std::string, std::shared_future<BuildResult>> m_runningVariantBuilds;
+    std::mutex m_programVariantLock;
+
+    bool m_useSeparateQueues = false;
+    cl::CommandQueue m_uploadQueue;
+    cl::CommandQueue m_downloadQueue;
+    std::vector<cl::CommandQueue> m_computeQueues;
+    uint32_t m_nextComputeQueue = 0;
+    std::vector<cl::Event> m_waitList;
+
+    struct ThreadQueue
+    {
+        cl::CommandQueue queue;
+        cl::Event profilingEvent;
+    };
+
+    // queues of the host-threads, if per-thread queues are enabled
+    bool m_usePerThreadQueues = false;
+    std::map<std::thread::id, ThreadQueue> m_threadQueues;
+    std::shared_mutex m_threadQueueLock;
+
+    ThreadQueue* getThreadQueue();
+    cl::CommandQueue& getQueue();
+    cl::Event* getProfilingEvent();
+
+    bool buildProgram(cl::Program &program,
+                      const std::string &kernelCode,
+                      const std::string &buildOptions,
+                      ErrorContainer &error);
+    bool compileProgram(cl::Program &program,
+                        const std::string &kernelCode,
+                        const std::string &buildOptions,
+                        ErrorContainer &error);
+    bool convertBuildOptions(const KernelBuildOptions &options,
+                             std::string &result,
+                             ErrorContainer &error);
+
+    bool convertRegion(const GpuData::WorkerBuffer &buffer,
+                       const BufferRegion &input,
+                       BufferRegion &output,
+                       ErrorContainer &error);
+
+    bool enqueueUpdate(GpuData::WorkerBuffer &buffer,
+                       GpuEvent &event,
+                       ErrorContainer &error,
+                       uint64_t numberOfObjects,
+                       const uint64_t offset);
+    bool enqueueCopy(GpuData::WorkerBuffer &buffer,
+                     GpuEvent &event,
+                     ErrorContainer &error,
+                     uint64_t numberOfObjects,
+                     const uint64_t offset);
+    bool enqueueUpdateRegion(GpuData::WorkerBuffer &buffer,
+                             const BufferRegion &region,
+                             GpuEvent &event,
+                             ErrorContainer &error);
+    bool enqueueCopyRegion(GpuData::WorkerBuffer &buffer,
+                           const BufferRegion &region,
+                           GpuEvent &event,
+                           ErrorContainer &error);
+    void* enqueueMap(GpuData::WorkerBuffer &buffer,
+                     const MapMode mode,
+                     ErrorContainer &error);
+    bool enqueueUnmap(GpuData::WorkerBuffer &buffer,
+                      ErrorContainer &error);
+    bool enqueueWrite(GpuData::WorkerBuffer &buffer,
+                      const uint64_t offset,
+                      const uint64_t size,
+                      const std::vector<cl::Event>* waitList,
+                      cl::Event* event,
+                      ErrorContainer &error);
+    bool enqueueArenaWrite(GpuData::WorkerBuffer &arena,
+                           const std::vector<GpuData::WorkerBuffer*> &parts,
+                           cl::Event* event,
+                           ErrorContainer &error);
+    bool enqueueRead(GpuData::WorkerBuffer &buffer,
+                     const uint64_t offset,
+                     const uint64_t size,
+                     const std::vector<cl::Event>* waitList,
+                     cl::Event* event,
+                     ErrorContainer &error);
+    bool enqueueWriteRect(GpuData::WorkerBuffer &buffer,
+                          const BufferRegion &region,
+                          const std::vector<cl::Event>* waitList,
+                          cl::Event* event,
+                          ErrorContainer &error);
+    bool enqueueReadRect(GpuData::WorkerBuffer &buffer,
+                         const BufferRegion &region,
+                         const std::vector<cl::Event>* waitList,
+                         cl::Event* event,
+                         ErrorContainer &error);
+    bool enqueueMapSync(GpuData::WorkerBuffer &buffer,
+                        const uint64_t offset,
+                        const uint64_t size,
+                        const cl_map_flags flags,
+                        cl::Event* event,
+                        ErrorContainer &error);
+    bool enableQueueProfiling(ErrorContainer &error);
+    void recordOperation(const char* operation,
+                         const ProfilingType type,
+                         const std::string &name,
+                         const uint64_t numberOfBytes,
+                         const cl::Event* event);
+    cl::CommandQueue& prepareTransfer(GpuData::WorkerBuffer &buffer,
+                                      const bool upload,
+                                      const std::vector<cl::Event>* &waitList,
+                                      cl::Event* &event);
+    void finishTransfer(cl::CommandQueue &queue,
+                        GpuData::WorkerBuffer &buffer,
+                        cl::Event* event);
+    bool enqueueKernel(GpuData &data,
+                       GpuData::KernelDef &def,
+                       const std::vector<cl::Event>* waitList,
+                       cl::Event* event,
+                       ErrorContainer &error);
+    bool setKernelArgument(GpuData::KernelDef &def,
+                           const std::string &argName,
+                           const void* value,
+                           const uint64_t valueSize,
+                           ErrorContainer &error);
+    void convertRanges(const GpuData &data,
+                       cl::NDRange &globalRange,
+                       cl::NDRange &localRange,
+                       cl::NDRange &offsetRange);
+    const std::vector<cl::Event>* prepareWaitList(const std::vector<cl::Event>* waitList,
+                                                  GpuData::WorkerBuffer* const* buffers,
+                                                  const uint64_t numberOfBuffers);
+    bool benchmarkKernel(GpuData &data,
+                         GpuData::KernelDef &def,
+                         cl::CommandQueue &queue,
+                         const uint32_t numberOfRuns,
+                         uint64_t &duration,
+                         ErrorContainer &error);
+    bool flushQueues();
+    bool finishQueues();
+    bool finishOwnQueue();
+
+    bool applyTunedWorkGroupSize(GpuData &data,
+                                 GpuData::KernelDef &def,
+                                 std::string &key);
+
     bool validateWorkerGroupSize(const GpuData &data,
                                  ErrorContainer &error);
 };
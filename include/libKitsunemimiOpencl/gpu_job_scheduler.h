@@ -0,0 +1,108 @@
+/**
+ * @file        gpu_job_scheduler.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef GPU_JOB_SCHEDULER_H
+#define GPU_JOB_SCHEDULER_H
+
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <map>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include <libKitsunemimiOpencl/gpu_data.h>
+#include <libKitsunemimiCommon/logger.h>
+
+namespace Kitsunemimi
+{
+class GpuInterface;
+
+class GpuJobScheduler
+{
+public:
+    GpuJobScheduler(const std::vector<GpuInterface*> &interfaces);
+    ~GpuJobScheduler();
+
+    bool init(const std::string &kernelName,
+              const std::string &kernelCode,
+              const std::vector<std::string> &inputNames,
+              const std::vector<std::string> &outputNames,
+              ErrorContainer &error);
+    bool submit(GpuData &data,
+                ErrorContainer &error);
+    bool waitForAll(ErrorContainer &error);
+    bool close();
+
+    int64_t getDeviceOfJob(GpuData &data);
+    uint64_t getNumberOfProcessedJobs(const uint64_t deviceId);
+    uint64_t getNumberOfStolenJobs();
+
+private:
+    struct Job
+    {
+        GpuData* data = nullptr;
+        // device, where the buffer of the job are resident (-1 = not on any device)
+        int64_t deviceId = -1;
+        bool isPending = false;
+        bool success = true;
+        ErrorContainer error;
+    };
+
+    struct Device
+    {
+        GpuInterface* interface = nullptr;
+        // data-object, which only holds the compiled kernel for the jobs of the device
+        GpuData kernelData;
+        std::deque<Job*> queue;
+        std::thread thread;
+        uint64_t numberOfProcessedJobs = 0;
+    };
+
+    // the data-objects can not be copied or moved, so the list is created with its final size
+    std::vector<Device> m_devices;
+    std::map<GpuData*, Job> m_jobs;
+    std::string m_kernelName = "";
+    std::vector<std::string> m_inputNames;
+    std::vector<std::string> m_outputNames;
+
+    std::mutex m_lock;
+    std::condition_variable m_workAvailable;
+    std::condition_variable m_jobFinished;
+    uint64_t m_numberOfPendingJobs = 0;
+    uint64_t m_numberOfStolenJobs = 0;
+    bool m_stop = false;
+    bool m_isInit = false;
+
+    void runWorker(const uint64_t deviceId);
+    Job* takeJob(const uint64_t deviceId);
+    bool processJob(const uint64_t deviceId,
+                    Job &job);
+    bool placeJob(const uint64_t deviceId,
+                  Job &job);
+};
+
+}
+
+#endif // GPU_JOB_SCHEDULER_H
@@ -0,0 +1,108 @@
+/**
+ * @file        gpu_profiler.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef GPU_PROFILER_H
+#define GPU_PROFILER_H
+
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <map>
+#include <string>
+
+#define __CL_ENABLE_EXCEPTIONS
+#include <CL/cl2.hpp>
+
+namespace Kitsunemimi
+{
+
+enum ProfilingType
+{
+    PROFILE_KERNEL = 0,
+    PROFILE_WRITE = 1,
+    PROFILE_READ = 2,
+};
+
+struct ProfilingStats
+{
+    uint64_t count = 0;
+    uint64_t numberOfBytes = 0;
+
+    // execution-time on the device from start to end in microseconds
+    double minTime = 0.0;
+    double meanTime = 0.0;
+    double p50Time = 0.0;
+    double p99Time = 0.0;
+
+    // mean time from enqueue until submit to the device and until start on the device
+    // in microseconds
+    double meanSubmitDelay = 0.0;
+    double meanStartDelay = 0.0;
+
+    // transfered bytes per second of execution-time on the device
+    double bytesPerSecond = 0.0;
+};
+
+class GpuProfiler
+{
+public:
+    GpuProfiler();
+
+    void addEvent(const ProfilingType type,
+                  const std::string &name,
+                  const uint64_t numberOfBytes,
+                  const cl::Event &event);
+    void update();
+
+    bool getStats(const ProfilingType type,
+                  const std::string &name,
+                  ProfilingStats &stats) const;
+    const std::vector<std::string> getNames(const ProfilingType type) const;
+    void reset();
+
+private:
+    struct PendingEvent
+    {
+        ProfilingType type = PROFILE_KERNEL;
+        std::string name = "";
+        uint64_t numberOfBytes = 0;
+        cl::Event event;
+    };
+
+    struct Measurements
+    {
+        std::vector<uint64_t> durations;
+        uint64_t submitDelaySum = 0;
+        uint64_t startDelaySum = 0;
+        uint64_t numberOfBytes = 0;
+    };
+
+    std::deque<PendingEvent> m_pendingEvents;
+    std::map<std::string, Measurements> m_measurements[3];
+
+    void addMeasurement(const PendingEvent &pendingEvent,
+                        const cl_int status);
+};
+
+}
+
+#endif // GPU_PROFILER_H
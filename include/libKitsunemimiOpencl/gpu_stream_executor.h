@@ -0,0 +1,94 @@
+/**
+ * @file        gpu_stream_executor.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef GPU_STREAM_EXECUTOR_H
+#define GPU_STREAM_EXECUTOR_H
+
+#include <iostream>
+#include <vector>
+#include <string>
+
+#include <libKitsunemimiOpencl/gpu_data.h>
+#include <libKitsunemimiCommon/logger.h>
+
+namespace Kitsunemimi
+{
+class GpuInterface;
+
+class GpuStreamExecutor
+{
+public:
+    GpuStreamExecutor(GpuInterface* gpuInterface);
+    ~GpuStreamExecutor();
+
+    bool addInput(const std::string &name,
+                  const void* data,
+                  const uint64_t numberOfObjects,
+                  const uint64_t objectSize);
+    bool addOutput(const std::string &name,
+                   void* data,
+                   const uint64_t numberOfObjects,
+                   const uint64_t objectSize);
+
+    bool init(const std::string &kernelName,
+              const std::string &kernelCode,
+              ErrorContainer &error,
+              const uint64_t chunkSize = 0);
+    bool run(ErrorContainer &error);
+    bool close();
+
+    uint64_t getChunkSize() const;
+    uint64_t getNumberOfChunks() const;
+
+private:
+    struct StreamBuffer
+    {
+        std::string name = "";
+        uint8_t* data = nullptr;
+        uint64_t objectSize = 0;
+        bool isOutput = false;
+    };
+
+    GpuInterface* m_interface = nullptr;
+    std::vector<StreamBuffer> m_buffers;
+    uint64_t m_numberOfObjects = 0;
+    uint64_t m_chunkSize = 0;
+    uint64_t m_localSize = 0;
+    std::string m_kernelName = "";
+
+    // two data-objects to process one chunk, while the next one is transfered
+    GpuData m_slots[2];
+    bool m_isInit = false;
+
+    bool addBuffer(const std::string &name,
+                   void* data,
+                   const uint64_t numberOfObjects,
+                   const uint64_t objectSize,
+                   const bool isOutput);
+    bool uploadChunk(const uint64_t chunk,
+                     ErrorContainer &error);
+    uint64_t calculateChunkSize();
+};
+
+}
+
+#endif // GPU_STREAM_EXECUTOR_H
@@ -0,0 +1,86 @@
+/**
+ * @file        gpu_tracer.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef GPU_TRACER_H
+#define GPU_TRACER_H
+
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <string>
+#include <chrono>
+
+#include <libKitsunemimiOpencl/gpu_profiler.h>
+#include <libKitsunemimiCommon/logger.h>
+
+#define __CL_ENABLE_EXCEPTIONS
+#include <CL/cl2.hpp>
+
+namespace Kitsunemimi
+{
+
+class GpuTracer
+{
+public:
+    GpuTracer();
+
+    void addEvent(const char* operation,
+                  const ProfilingType type,
+                  const std::string &name,
+                  const uint64_t numberOfBytes,
+                  const cl::Event &event);
+    void update();
+
+    uint64_t getNumberOfEvents() const;
+    bool writeTrace(const std::string &filePath,
+                    ErrorContainer &error);
+    void clear();
+
+private:
+    struct TraceEvent
+    {
+        const char* operation = "";
+        ProfilingType type = PROFILE_KERNEL;
+        std::string name = "";
+        uint64_t numberOfBytes = 0;
+        cl::Event event;
+
+        // host-time of the enqueue and device-times relative to the enqueue in nanoseconds
+        uint64_t enqueueTime = 0;
+        uint64_t submitDelay = 0;
+        uint64_t startDelay = 0;
+        uint64_t duration = 0;
+        bool failed = false;
+    };
+
+    std::chrono::steady_clock::time_point m_startTime;
+    std::deque<TraceEvent> m_pendingEvents;
+    std::vector<TraceEvent> m_finishedEvents;
+
+    void finishEvent(TraceEvent &traceEvent,
+                     const cl_int status);
+    const std::string escape(const std::string &input) const;
+};
+
+}
+
+#endif // GPU_TRACER_H
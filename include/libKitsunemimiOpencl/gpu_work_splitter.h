@@ -0,0 +1,112 @@
+/**
+ * @file        gpu_work_splitter.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef GPU_WORK_SPLITTER_H
+#define GPU_WORK_SPLITTER_H
+
+#include <iostream>
+#include <vector>
+#include <string>
+
+#include <libKitsunemimiOpencl/gpu_data.h>
+#include <libKitsunemimiCommon/logger.h>
+
+namespace Kitsunemimi
+{
+class GpuInterface;
+
+class GpuWorkSplitter
+{
+public:
+    GpuWorkSplitter(const std::vector<GpuInterface*> &interfaces);
+    ~GpuWorkSplitter();
+
+    bool addInput(const std::string &name,
+                  const void* data,
+                  const uint64_t numberOfObjects,
+                  const uint64_t objectSize);
+    bool addOutput(const std::string &name,
+                   void* data,
+                   const uint64_t numberOfObjects,
+                   const uint64_t objectSize);
+
+    bool init(const std::string &kernelName,
+              const std::string &kernelCode,
+              ErrorContainer &error,
+              const uint64_t calibrationSize = 1 << 16);
+    bool run(ErrorContainer &error);
+    bool rebalance(ErrorContainer &error);
+    bool close();
+
+    uint64_t getNumberOfDevices() const;
+    uint64_t getPartitionSize(const uint64_t deviceId) const;
+    double getThroughput(const uint64_t deviceId) const;
+
+private:
+    struct SplitBuffer
+    {
+        std::string name = "";
+        uint8_t* data = nullptr;
+        uint64_t objectSize = 0;
+        bool isOutput = false;
+    };
+
+    struct DevicePart
+    {
+        GpuInterface* interface = nullptr;
+        GpuData data;
+        uint64_t offset = 0;
+        uint64_t numberOfObjects = 0;
+        uint64_t localSize = 0;
+        // measured number of objects per second
+        double throughput = 0.0;
+        bool success = true;
+        ErrorContainer error;
+    };
+
+    // the data-objects can not be copied or moved, so the list is created with its final size
+    std::vector<DevicePart> m_parts;
+    std::vector<SplitBuffer> m_buffers;
+    uint64_t m_numberOfObjects = 0;
+    std::string m_kernelName = "";
+    bool m_isInit = false;
+
+    bool addBuffer(const std::string &name,
+                   void* data,
+                   const uint64_t numberOfObjects,
+                   const uint64_t objectSize,
+                   const bool isOutput);
+    bool preparePart(DevicePart &part,
+                     const uint64_t offset,
+                     const uint64_t numberOfObjects,
+                     ErrorContainer &error);
+    bool preparePartitions(ErrorContainer &error);
+    void releasePart(DevicePart &part);
+    bool runAllParts(const bool copyOutput,
+                     ErrorContainer &error);
+    void runPart(DevicePart &part,
+                 const bool copyOutput);
+};
+
+}
+
+#endif // GPU_WORK_SPLITTER_H
@@ -0,0 +1,72 @@
+/**
+ * @file        program_cache.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef PROGRAM_CACHE_H
+#define PROGRAM_CACHE_H
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <atomic>
+
+#include <libKitsunemimiCommon/logger.h>
+
+#define __CL_ENABLE_EXCEPTIONS
+#include <CL/cl2.hpp>
+
+namespace Kitsunemimi
+{
+
+class ProgramCache
+{
+public:
+    ProgramCache(const std::string &cacheDirectory);
+
+    const std::string createKey(const cl::Device &device,
+                                const std::string &kernelCode,
+                                const std::string &buildOptions);
+
+    bool loadProgram(cl::Program &program,
+                     const cl::Context &context,
+                     const cl::Device &device,
+                     const std::string &key,
+                     const std::string &buildOptions);
+    bool storeProgram(const cl::Program &program,
+                      const cl::Device &device,
+                      const std::string &key,
+                      ErrorContainer &error);
+
+    uint64_t getNumberOfHits() const;
+    uint64_t getNumberOfMisses() const;
+
+private:
+    std::string m_cacheDirectory = "";
+    // counter are atomic, because programs can be built by multiple threads at the same time
+    std::atomic<uint64_t> m_hits = 0;
+    std::atomic<uint64_t> m_misses = 0;
+
+    const std::string getFilePath(const std::string &key);
+};
+
+}
+
+#endif // PROGRAM_CACHE_H
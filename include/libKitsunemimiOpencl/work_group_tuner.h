@@ -0,0 +1,72 @@
+/**
+ * @file        work_group_tuner.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef WORK_GROUP_TUNER_H
+#define WORK_GROUP_TUNER_H
+
+#include <iostream>
+#include <vector>
+#include <map>
+#include <string>
+#include <mutex>
+
+#include <libKitsunemimiOpencl/gpu_data.h>
+#include <libKitsunemimiCommon/logger.h>
+
+#define __CL_ENABLE_EXCEPTIONS
+#include <CL/cl2.hpp>
+
+namespace Kitsunemimi
+{
+
+class WorkGroupTuner
+{
+public:
+    WorkGroupTuner(const std::string &directory);
+
+    uint64_t createKernelHash(const cl::Device &device,
+                              const std::string &kernelCode,
+                              const std::string &kernelName);
+    const std::string createKey(const uint64_t kernelHash,
+                                const WorkerDim &globalSize,
+                                const WorkerDim &localSize);
+
+    bool loadResult(const std::string &key,
+                    uint64_t &localSizeX);
+    bool storeResult(const std::string &key,
+                     const uint64_t localSizeX,
+                     ErrorContainer &error);
+
+private:
+    std::string m_directory = "";
+
+    // results, which were already loaded or tuned in this process, where 0 marks keys without
+    // result, so the disc is only checked once per key
+    std::map<std::string, uint64_t> m_results;
+    std::mutex m_lock;
+
+    const std::string getFilePath(const std::string &key);
+};
+
+}
+
+#endif // WORK_GROUP_TUNER_H
@@ -0,0 +1,438 @@
+/**
+ * @file        buffer_pool.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include <libKitsunemimiOpencl/buffer_pool.h>
+
+#include <limits>
+#include <iterator>
+
+#include <libKitsunemimiCommon/logger.h>
+#include <libKitsunemimiCommon/buffer/data_buffer.h>
+
+namespace Kitsunemimi
+{
+
+BufferPool::BufferPool() {}
+
+/**
+ * @brief destructor. All pooled memory must be already cleared with the queue of its device.
+ */
+BufferPool::~BufferPool()
+{
+    if(m_pinnedMemory.size() > 0) {
+        LOG_WARNING("buffer-pool destroyed with " + std::to_string(m_pinnedMemory.size())
+                    + " still mapped pinned buffers");
+    }
+
+    for(auto& [size, data] : m_hostMemory) {
+        Kitsunemimi::alignedFree(data, size);
+    }
+}
+
+/**
+ * @brief get pinned host-memory, which is allocated by the driver and can be transfered with the
+ *        full DMA-bandwidth. Memory of the same size is reused from the pool, if available.
+ *
+ * @param context context of the device
+ * @param queue queue, which is used to map the memory into the host-address-space
+ * @param numberOfBytes size of the requested memory
+ * @param pinnedBuffer reference for the buffer-object, which holds the memory
+ * @param data reference for the pointer to the mapped memory
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+BufferPool::getPinnedMemory(const cl::Context &context,
+                            const cl::CommandQueue &queue,
+                            const uint64_t numberOfBytes,
+                            cl::Buffer &pinnedBuffer,
+                            void* &data,
+                            ErrorContainer &error)
+{
+    // reuse existing memory
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        std::multimap<uint64_t, PinnedEntry>::iterator it;
+        it = m_pinnedMemory.find(numberOfBytes);
+        if(it != m_pinnedMemory.end())
+        {
+            pinnedBuffer = it->second.buffer;
+            data = it->second.data;
+            m_pinnedMemory.erase(it);
+            m_hostBytes -= numberOfBytes;
+
+            return true;
+        }
+    }
+
+    // allocate new memory and keep it mapped for the whole lifetime
+    try
+    {
+        pinnedBuffer = cl::Buffer(context,
+                                  CL_MEM_READ_WRITE | CL_MEM_ALLOC_HOST_PTR,
+                                  numberOfBytes);
+        data = queue.enqueueMapBuffer(pinnedBuffer,
+                                      CL_TRUE,
+                                      CL_MAP_READ | CL_MAP_WRITE,
+                                      0,
+                                      numberOfBytes);
+    }
+    catch(const cl::Error &err)
+    {
+        error.addMeesage("OpenCL error while allocating pinned memory: "
+                         + std::string(err.what())
+                         + "("
+                         + std::to_string(err.err())
+                         + ")");
+        LOG_ERROR(error);
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief give pinned memory back to the pool. If the pool becomes bigger than its limit, the
+ *        biggest entries are unmapped and freed.
+ *
+ * @param pinnedBuffer buffer-object, which holds the memory
+ * @param queue queue, which was used to map the memory and is used to unmap it at eviction
+ * @param data pointer to the mapped memory
+ * @param numberOfBytes size of the memory
+ */
+void
+BufferPool::releasePinnedMemory(const cl::Buffer &pinnedBuffer,
+                                const cl::CommandQueue &queue,
+                                void* data,
+                                const uint64_t numberOfBytes)
+{
+    PinnedEntry entry;
+    entry.buffer = pinnedBuffer;
+    entry.queue = queue;
+    entry.data = data;
+
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_pinnedMemory.insert(std::make_pair(numberOfBytes, entry));
+    m_hostBytes += numberOfBytes;
+    evict(m_maxHostBytes, m_maxDeviceBytes);
+}
+
+/**
+ * @brief get a buffer on the device. A buffer of the same size is reused from the pool, if
+ *        available, so no new allocation on the device is necessary.
+ *
+ * @param context context of the device
+ * @param numberOfBytes size of the requested buffer
+ * @param deviceBuffer reference for the buffer-object
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+BufferPool::getDeviceBuffer(const cl::Context &context,
+                            const uint64_t numberOfBytes,
+                            cl::Buffer &deviceBuffer,
+                            ErrorContainer &error)
+{
+    // reuse existing buffer
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        std::multimap<uint64_t, cl::Buffer>::iterator it;
+        it = m_deviceBuffers.find(numberOfBytes);
+        if(it != m_deviceBuffers.end())
+        {
+            deviceBuffer = it->second;
+            m_deviceBuffers.erase(it);
+            m_deviceBytes -= numberOfBytes;
+
+            return true;
+        }
+    }
+
+    // allocate new buffer
+    try
+    {
+        deviceBuffer = cl::Buffer(context, CL_MEM_READ_WRITE, numberOfBytes);
+    }
+    catch(const cl::Error &err)
+    {
+        error.addMeesage("OpenCL error while allocating buffer on device: "
+                         + std::string(err.what())
+                         + "("
+                         + std::to_string(err.err())
+                         + ")");
+        LOG_ERROR(error);
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief give buffer on the device back to the pool. If the pool becomes bigger than its limit,
+ *        the biggest buffer are freed.
+ *
+ * @param deviceBuffer buffer-object to keep
+ * @param numberOfBytes size of the buffer
+ */
+void
+BufferPool::releaseDeviceBuffer(const cl::Buffer &deviceBuffer,
+                                const uint64_t numberOfBytes)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_deviceBuffers.insert(std::make_pair(numberOfBytes, deviceBuffer));
+    m_deviceBytes += numberOfBytes;
+    evict(m_maxHostBytes, m_maxDeviceBytes);
+}
+
+/**
+ * @brief get aligned host-memory. Memory of the same size is reused from the pool, if available.
+ *
+ * @param numberOfBytes size of the requested memory, which must be a multiple of 4096
+ *
+ * @return pointer to the memory
+ */
+void*
+BufferPool::getHostMemory(const uint64_t numberOfBytes)
+{
+    // reuse existing memory
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        std::multimap<uint64_t, void*>::iterator it;
+        it = m_hostMemory.find(numberOfBytes);
+        if(it != m_hostMemory.end())
+        {
+            void* data = it->second;
+            m_hostMemory.erase(it);
+            m_hostBytes -= numberOfBytes;
+
+            return data;
+        }
+    }
+
+    return Kitsunemimi::alignedMalloc(4096, numberOfBytes);
+}
+
+/**
+ * @brief give host-memory, which was taken by getHostMemory, back to the pool. If the pool becomes
+ *        bigger than its limit, the biggest memory-blocks are freed.
+ *
+ * @param data pointer to the memory
+ * @param numberOfBytes size of the memory
+ */
+void
+BufferPool::releaseHostMemory(void* data,
+                              const uint64_t numberOfBytes)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_hostMemory.insert(std::make_pair(numberOfBytes, data));
+    m_hostBytes += numberOfBytes;
+    evict(m_maxHostBytes, m_maxDeviceBytes);
+}
+
+/**
+ * @brief unmap and free all memory within the pool
+ *
+ * @param queue queue of the device, which was used to map the pinned memory
+ *
+ * @return true, if successful, else false
+ */
+bool
+BufferPool::clear(const cl::CommandQueue &queue)
+{
+    bool result = true;
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    try
+    {
+        for(auto& [size, entry] : m_pinnedMemory) {
+            queue.enqueueUnmapMemObject(entry.buffer, entry.data);
+        }
+        queue.finish();
+    }
+    catch(const cl::Error &)
+    {
+        result = false;
+    }
+
+    m_pinnedMemory.clear();
+    m_deviceBuffers.clear();
+
+    for(auto& [size, data] : m_hostMemory) {
+        Kitsunemimi::alignedFree(data, size);
+    }
+    m_hostMemory.clear();
+
+    m_hostBytes = 0;
+    m_deviceBytes = 0;
+
+    return result;
+}
+
+/**
+ * @brief set the maximum number of bytes, which are kept by the pool. Memory, which is given back
+ *        to the full pool, is freed instead of kept. Already pooled memory above the new limits is
+ *        freed immediately.
+ *
+ * @param maxHostBytes limit for pooled host-memory and pinned memory (0 = no limit)
+ * @param maxDeviceBytes limit for pooled buffer on the device (0 = no limit)
+ */
+void
+BufferPool::setLimits(const uint64_t maxHostBytes,
+                      const uint64_t maxDeviceBytes)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    m_maxHostBytes = maxHostBytes;
+    if(m_maxHostBytes == 0) {
+        m_maxHostBytes = std::numeric_limits<uint64_t>::max();
+    }
+
+    m_maxDeviceBytes = maxDeviceBytes;
+    if(m_maxDeviceBytes == 0) {
+        m_maxDeviceBytes = std::numeric_limits<uint64_t>::max();
+    }
+
+    evict(m_maxHostBytes, m_maxDeviceBytes);
+}
+
+/**
+ * @brief free pooled memory until the pool is not bigger than the given sizes. Without arguments
+ *        the whole pool is freed. Pinned memory is unmapped with the queue, which was used to
+ *        map it.
+ *
+ * @param maxHostBytes number of bytes of host-memory and pinned memory to keep
+ * @param maxDeviceBytes number of bytes of buffer on the device to keep
+ */
+void
+BufferPool::trim(const uint64_t maxHostBytes,
+                 const uint64_t maxDeviceBytes)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    evict(maxHostBytes, maxDeviceBytes);
+}
+
+/**
+ * @brief free the biggest pooled entries until the pool is not bigger than the given sizes. The
+ *        caller must already hold the lock.
+ *
+ * @param maxHostBytes number of bytes of host-memory and pinned memory to keep
+ * @param maxDeviceBytes number of bytes of buffer on the device to keep
+ */
+void
+BufferPool::evict(const uint64_t maxHostBytes,
+                  const uint64_t maxDeviceBytes)
+{
+    while(m_hostBytes > maxHostBytes
+          && m_hostMemory.size() > 0)
+    {
+        std::multimap<uint64_t, void*>::iterator it = std::prev(m_hostMemory.end());
+        Kitsunemimi::alignedFree(it->second, it->first);
+        m_hostBytes -= it->first;
+        m_hostMemory.erase(it);
+    }
+
+    while(m_hostBytes > maxHostBytes
+          && m_pinnedMemory.size() > 0)
+    {
+        std::multimap<uint64_t, PinnedEntry>::iterator it = std::prev(m_pinnedMemory.end());
+        try {
+            it->second.queue.enqueueUnmapMemObject(it->second.buffer, it->second.data);
+        }
+        catch(const cl::Error &) {
+            LOG_WARNING("failed to unmap pinned memory, which is removed from the buffer-pool");
+        }
+        m_hostBytes -= it->first;
+        m_pinnedMemory.erase(it);
+    }
+
+    while(m_deviceBytes > maxDeviceBytes
+          && m_deviceBuffers.size() > 0)
+    {
+        std::multimap<uint64_t, cl::Buffer>::iterator it = std::prev(m_deviceBuffers.end());
+        m_deviceBytes -= it->first;
+        m_deviceBuffers.erase(it);
+    }
+}
+
+/**
+ * @brief get number of unused pinned buffer within the pool
+ *
+ * @return number of buffer
+ */
+uint64_t
+BufferPool::getNumberOfPooledPinnedBuffers() const
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    return m_pinnedMemory.size();
+}
+
+/**
+ * @brief get number of unused buffer on the device within the pool
+ *
+ * @return number of buffer
+ */
+uint64_t
+BufferPool::getNumberOfPooledDeviceBuffers() const
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    return m_deviceBuffers.size();
+}
+
+/**
+ * @brief get number of unused host-memory-blocks within the pool
+ *
+ * @return number of memory-blocks
+ */
+uint64_t
+BufferPool::getNumberOfPooledHostBuffers() const
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    return m_hostMemory.size();
+}
+
+/**
+ * @brief get number of bytes of unused host-memory and pinned memory within the pool
+ *
+ * @return number of bytes
+ */
+uint64_t
+BufferPool::getNumberOfPooledHostBytes() const
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    return m_hostBytes;
+}
+
+/**
+ * @brief get number of bytes of unused buffer on the device within the pool
+ *
+ * @return number of bytes
+ */
+uint64_t
+BufferPool::getNumberOfPooledDeviceBytes() const
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    return m_deviceBytes;
+}
+
+}
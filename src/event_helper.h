@@ -0,0 +1,106 @@
+/**
+ * @file        event_helper.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef EVENT_HELPER_H
+#define EVENT_HELPER_H
+
+#include <deque>
+#include <stdint.h>
+
+#define __CL_ENABLE_EXCEPTIONS
+#include <CL/cl2.hpp>
+
+namespace Kitsunemimi
+{
+
+/**
+ * @brief get execution-status of an event
+ *
+ * @param event event to check
+ *
+ * @return CL_COMPLETE for finished operations, a positive value for still running operations and
+ *         a negative error-code for failed operations
+ */
+inline cl_int
+getEventStatus(const cl::Event &event)
+{
+    try {
+        return event.getInfo<CL_EVENT_COMMAND_EXECUTION_STATUS>();
+    }
+    catch(const cl::Error &err) {
+        return err.err() < 0 ? err.err() : CL_INVALID_EVENT;
+    }
+}
+
+/**
+ * @brief evaluate the pending events of the profiler or tracer, which have to contain the event
+ *        in the member 'event'. Each finished or failed entry is given to the process-function
+ *        together with its status and removed from the pending events.
+ *
+ * @param pendingEvents list of pending entries in the order of the enqueue
+ * @param onlyOldest true to only evaluate the oldest entries until the first unfinished one. The
+ *                   operations finish mostly in the order of the enqueue, so this is enough to
+ *                   limit the number of pending events while adding new ones, without checking
+ *                   the same unfinished events again and again.
+ * @param process function, which is called for each finished entry
+ */
+template<typename T, typename F>
+inline void
+evaluatePendingEvents(std::deque<T> &pendingEvents,
+                      const bool onlyOldest,
+                      F process)
+{
+    if(onlyOldest)
+    {
+        while(pendingEvents.size() > 0)
+        {
+            const cl_int status = getEventStatus(pendingEvents.front().event);
+            if(status > CL_COMPLETE) {
+                return;
+            }
+
+            process(pendingEvents.front(), status);
+            pendingEvents.pop_front();
+        }
+
+        return;
+    }
+
+    std::deque<T> stillPending;
+    for(T &entry : pendingEvents)
+    {
+        const cl_int status = getEventStatus(entry.event);
+        if(status > CL_COMPLETE)
+        {
+            stillPending.push_back(entry);
+            continue;
+        }
+
+        process(entry, status);
+    }
+
+    pendingEvents.swap(stillPending);
+}
+
+}
+
+#endif // EVENT_HELPER_H
@@ -0,0 +1,120 @@
+/**
+ * @file        file_helper.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef FILE_HELPER_H
+#define FILE_HELPER_H
+
+#include <string>
+#include <vector>
+#include <errno.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include <libKitsunemimiCommon/logger.h>
+
+namespace Kitsunemimi
+{
+
+/**
+ * @brief write a file atomically. The data are written into a temporary file in the same
+ *        directory first, which is renamed to the target afterwards, so other threads and
+ *        processes, which use the same directory, never read an incomplete file. The name of the
+ *        temporary file is created by mkstemp, so it is unique over all processes.
+ *
+ * @param filePath path of the file to write
+ * @param data pointer to the data to write
+ * @param dataSize number of bytes to write
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+inline bool
+writeFileAtomic(const std::string &filePath,
+                const void* data,
+                const uint64_t dataSize,
+                ErrorContainer &error)
+{
+    // create temporary file with unique name
+    std::vector<char> tempName(filePath.begin(), filePath.end());
+    const std::string suffix = ".tmpXXXXXX";
+    tempName.insert(tempName.end(), suffix.begin(), suffix.end());
+    tempName.push_back('\0');
+
+    const int fd = mkstemp(tempName.data());
+    if(fd < 0)
+    {
+        error.addMeesage("failed to create temporary file for '" + filePath + "'");
+        return false;
+    }
+    const std::string tempFilePath(tempName.data());
+
+    // mkstemp only allows the owner to read the file, but other users can share the directory
+    fchmod(fd, 0644);
+
+    // write data, where a single write-call can write less than requested
+    const char* pos = static_cast<const char*>(data);
+    uint64_t remaining = dataSize;
+    bool success = true;
+    while(remaining > 0)
+    {
+        const ssize_t ret = write(fd, pos, remaining);
+        if(ret < 0)
+        {
+            if(errno == EINTR) {
+                continue;
+            }
+            success = false;
+            break;
+        }
+
+        pos += ret;
+        remaining -= static_cast<uint64_t>(ret);
+    }
+
+    if(close(fd) != 0) {
+        success = false;
+    }
+
+    if(success == false)
+    {
+        error.addMeesage("failed to write file '" + tempFilePath + "'");
+        unlink(tempFilePath.c_str());
+        return false;
+    }
+
+    // replace the target-file in one step
+    if(rename(tempFilePath.c_str(), filePath.c_str()) != 0)
+    {
+        error.addMeesage("failed to move file '" + tempFilePath + "' to '" + filePath + "'");
+        unlink(tempFilePath.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+}
+
+#endif // FILE_HELPER_H
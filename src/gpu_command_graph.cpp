@@ -0,0 +1,377 @@
+/**
+ * @file        gpu_command_graph.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include <libKitsunemimiOpencl/gpu_command_graph.h>
+
+#include <libKitsunemimiOpencl/gpu_interface.h>
+#include <libKitsunemimiCommon/logger.h>
+
+namespace Kitsunemimi
+{
+
+/**
+ * @brief constructor
+ *
+ * @param gpuInterface interface of the device, where the graph should be executed
+ * @param data data-object with all buffer and kernel, which are used by the graph. It must be
+ *             already initialized on the device and must not be closed while the graph is used.
+ */
+GpuCommandGraph::GpuCommandGraph(GpuInterface* gpuInterface,
+                                 GpuData* data)
+{
+    m_interface = gpuInterface;
+    m_data = data;
+}
+
+/**
+ * @brief record update of a buffer on the device
+ *
+ * @param bufferName name of the buffer to update
+ * @param error reference for error-output
+ * @param dependencies ids of steps, which have to be finished before this step
+ * @param numberOfObjects number of objects to copy (0 = all)
+ * @param offset offset in buffer on device
+ *
+ * @return id of the new step, or INVALID_STEP if failed
+ */
+uint32_t
+GpuCommandGraph::addUpdate(const std::string &bufferName,
+                           ErrorContainer &error,
+                           const std::vector<uint32_t> &dependencies,
+                           uint64_t numberOfObjects,
+                           const uint64_t offset)
+{
+    if(checkDependencies(dependencies, error) == false) {
+        return INVALID_STEP;
+    }
+
+    Step step;
+    step.type = UPDATE_STEP;
+    step.dependencies = dependencies;
+    if(prepareTransferStep(step, bufferName, numberOfObjects, offset, error) == false) {
+        return INVALID_STEP;
+    }
+
+    m_steps.push_back(step);
+
+    return static_cast<uint32_t>(m_steps.size() - 1);
+}
+
+/**
+ * @brief record run of a kernel
+ *
+ * @param kernelName name of the kernel to run
+ * @param error reference for error-output
+ * @param dependencies ids of steps, which have to be finished before this step
+ *
+ * @return id of the new step, or INVALID_STEP if failed
+ */
+uint32_t
+GpuCommandGraph::addRun(const std::string &kernelName,
+                        ErrorContainer &error,
+                        const std::vector<uint32_t> &dependencies)
+{
+    if(checkDependencies(dependencies, error) == false) {
+        return INVALID_STEP;
+    }
+
+    Step step;
+    step.type = RUN_STEP;
+    step.dependencies = dependencies;
+    step.kernel = m_data->getKernel(kernelName);
+    if(step.kernel == nullptr)
+    {
+        error.addMeesage("no kernel with name '" + kernelName + "' found");
+        return INVALID_STEP;
+    }
+
+    m_steps.push_back(step);
+
+    return static_cast<uint32_t>(m_steps.size() - 1);
+}
+
+/**
+ * @brief record copy of a buffer from the device back to the host
+ *
+ * @param bufferName name of the buffer to copy
+ * @param error reference for error-output
+ * @param dependencies ids of steps, which have to be finished before this step
+ * @param numberOfObjects number of objects to copy (0 = all)
+ * @param offset offset in buffer on device
+ *
+ * @return id of the new step, or INVALID_STEP if failed
+ */
+uint32_t
+GpuCommandGraph::addCopyFromDevice(const std::string &bufferName,
+                                   ErrorContainer &error,
+                                   const std::vector<uint32_t> &dependencies,
+                                   uint64_t numberOfObjects,
+                                   const uint64_t offset)
+{
+    if(checkDependencies(dependencies, error) == false) {
+        return INVALID_STEP;
+    }
+
+    Step step;
+    step.type = COPY_FROM_DEVICE_STEP;
+    step.dependencies = dependencies;
+    if(prepareTransferStep(step, bufferName, numberOfObjects, offset, error) == false) {
+        return INVALID_STEP;
+    }
+
+    m_steps.push_back(step);
+
+    return static_cast<uint32_t>(m_steps.size() - 1);
+}
+
+/**
+ * @brief remove all recorded steps
+ */
+void
+GpuCommandGraph::clear()
+{
+    m_steps.clear();
+    m_finalWaitList.clear();
+}
+
+/**
+ * @brief enqueue all recorded steps with their dependencies and submit them together to the
+ *        device, without waiting for the result
+ *
+ * @param event reference for the event, which is finished, when all steps are finished
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuCommandGraph::launch(GpuEvent &event,
+                        ErrorContainer &error)
+{
+    m_finalWaitList.clear();
+
+    for(Step &step : m_steps)
+    {
+        const std::vector<cl::Event>* waitList = prepareWaitList(step);
+        bool success = true;
+        step.hasEvent = false;
+
+        switch(step.type)
+        {
+            case UPDATE_STEP:
+                // host-pointer-buffer are read by the device directly. The wait-list of the
+                // skipped step is given to the steps, which depend on it
+                if(step.buffer->useHostPtr || step.size == 0) {
+                    continue;
+                }
+                success = m_interface->enqueueWrite(*step.buffer,
+                                                    step.offset,
+                                                    step.size,
+                                                    waitList,
+                                                    &step.event,
+                                                    error);
+                break;
+            case RUN_STEP:
+                success = m_interface->enqueueKernel(*m_data,
+                                                     *step.kernel,
+                                                     waitList,
+                                                     &step.event,
+                                                     error);
+                break;
+            case COPY_FROM_DEVICE_STEP:
+                success = m_interface->enqueueRead(*step.buffer,
+                                                   step.offset,
+                                                   step.size,
+                                                   waitList,
+                                                   &step.event,
+                                                   error);
+                break;
+        }
+
+        if(success == false)
+        {
+            error.addMeesage("failed to launch command-graph");
+            return false;
+        }
+
+        step.hasEvent = true;
+        m_finalWaitList.push_back(step.event);
+    }
+
+    // create one event for the whole graph and submit all commands together
+    try
+    {
+        if(m_finalWaitList.size() > 0)
+        {
+            m_interface->getQueue().enqueueMarkerWithWaitList(&m_finalWaitList, &event.m_event);
+            event.m_isActive = true;
+        }
+        m_interface->flushQueues();
+    }
+    catch(const cl::Error &err)
+    {
+        error.addMeesage("OpenCL error while submitting command-graph: "
+                         + std::string(err.what())
+                         + "("
+                         + std::to_string(err.err())
+                         + ")");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief launch all recorded steps and block until they are finished
+ *
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuCommandGraph::launchAndWait(ErrorContainer &error)
+{
+    GpuEvent event;
+    if(launch(event, error) == false) {
+        return false;
+    }
+
+    if(event.wait() == false)
+    {
+        error.addMeesage("execution of command-graph failed");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief get number of recorded steps
+ *
+ * @return number of steps
+ */
+uint64_t
+GpuCommandGraph::getNumberOfSteps() const
+{
+    return m_steps.size();
+}
+
+/**
+ * @brief check if all dependencies are refering to already recorded steps
+ *
+ * @param dependencies list of step-ids to check
+ * @param error reference for error-output
+ *
+ * @return true, if valid, else false
+ */
+bool
+GpuCommandGraph::checkDependencies(const std::vector<uint32_t> &dependencies,
+                                   ErrorContainer &error)
+{
+    for(const uint32_t id : dependencies)
+    {
+        if(id >= m_steps.size())
+        {
+            error.addMeesage("dependency to unknown step with id " + std::to_string(id));
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief resolve buffer and byte-range of a transfer-step
+ *
+ * @param step step to fill
+ * @param bufferName name of the buffer
+ * @param numberOfObjects number of objects to copy (0 = all)
+ * @param offset offset in buffer on device
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuCommandGraph::prepareTransferStep(Step &step,
+                                     const std::string &bufferName,
+                                     uint64_t numberOfObjects,
+                                     const uint64_t offset,
+                                     ErrorContainer &error)
+{
+    step.buffer = m_data->getBuffer(bufferName);
+    if(step.buffer == nullptr)
+    {
+        error.addMeesage("no buffer with name '" + bufferName + "' found");
+        return false;
+    }
+
+    // set size with value of the buffer, if size not explitely set
+    if(numberOfObjects == 0) {
+        numberOfObjects = step.buffer->numberOfObjects;
+    }
+
+    // check size
+    if(offset + numberOfObjects > step.buffer->numberOfObjects)
+    {
+        error.addMeesage("position within buffer '" + bufferName + "' invalid");
+        return false;
+    }
+
+    const uint64_t objectSize = step.buffer->objectSize;
+    step.offset = offset * objectSize;
+    step.size = numberOfObjects * objectSize;
+
+    return true;
+}
+
+/**
+ * @brief fill wait-list of a step with the events of its dependencies from the current launch.
+ *        A skipped step has no event, so its own wait-list is taken instead, which keeps the
+ *        dependencies of the skipped step for all following steps.
+ *
+ * @param step step to prepare
+ *
+ * @return pointer to the wait-list, or nullptr if there is nothing to wait for
+ */
+const std::vector<cl::Event>*
+GpuCommandGraph::prepareWaitList(Step &step)
+{
+    step.waitList.clear();
+    for(const uint32_t id : step.dependencies)
+    {
+        const Step &dependency = m_steps[id];
+        if(dependency.hasEvent) {
+            step.waitList.push_back(dependency.event);
+        } else {
+            step.waitList.insert(step.waitList.end(),
+                                 dependency.waitList.begin(),
+                                 dependency.waitList.end());
+        }
+    }
+
+    if(step.waitList.size() == 0) {
+        return nullptr;
+    }
+
+    return &step.waitList;
+}
+
+}
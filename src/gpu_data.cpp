@@ -21,11 +21,22 @@
  */
 
 #include <libKitsunemimiOpencl/gpu_data.h>
+#include <libKitsunemimiOpencl/buffer_pool.h>
 
 namespace Kitsunemimi
 {
 
-GpuData::GpuData() {}
+/**
+ * @brief constructor
+ *
+ * @param bufferPool optional pool of a gpu-interface, which is used to reuse the host-memory of
+ *                   the data-objects, which were already closed by the interface. The pool must
+ *                   exist as long as the data-object.
+ */
+GpuData::GpuData(BufferPool* bufferPool)
+{
+    m_bufferPool = bufferPool;
+}
 
 /**
  * @brief register new buffer
@@ -47,15 +58,19 @@ GpuData::addBuffer(const std::string &name,
                    const bool useHostPtr,
                    void* data)
 {
+    std::unique_lock<std::shared_mutex> guard(m_lock.mutex);
+
     // precheck
-    if(containsBuffer(name)) {
+    if(findBuffer(name) != nullptr) {
         return false;
     }
 
     // prepare worker-buffer
     WorkerBuffer newBuffer;
+    newBuffer.name = name;
     newBuffer.numberOfBytes = numberOfObjects * objectSize;
     newBuffer.numberOfObjects = numberOfObjects;
+    newBuffer.objectSize = objectSize;
     newBuffer.useHostPtr = useHostPtr;
 
     // allocate or set memory
@@ -66,7 +81,15 @@ GpuData::addBuffer(const std::string &name,
             newBuffer.numberOfBytes += 4096 - (newBuffer.numberOfBytes % 4096);
         }
 
-        newBuffer.data = Kitsunemimi::alignedMalloc(4096, newBuffer.numberOfBytes);
+        if(m_bufferPool != nullptr)
+        {
+            newBuffer.data = m_bufferPool->getHostMemory(newBuffer.numberOfBytes);
+            newBuffer.hostMemoryPool = m_bufferPool;
+        }
+        else
+        {
+            newBuffer.data = Kitsunemimi::alignedMalloc(4096, newBuffer.numberOfBytes);
+        }
     }
     else
     {
@@ -89,13 +112,123 @@ GpuData::addBuffer(const std::string &name,
 GpuData::WorkerBuffer*
 GpuData::getBuffer(const std::string &name)
 {
-    std::map<std::string, WorkerBuffer>::iterator it;
-    it = m_buffer.find(name);
-    if(it != m_buffer.end()) {
-        return &it->second;
+    std::shared_lock<std::shared_mutex> guard(m_lock.mutex);
+    return findBuffer(name);
+}
+
+/**
+ * @brief get worker-buffer by handle without any string-comparison
+ *
+ * @param handle handle of the buffer
+ *
+ * @return pointer to worker-buffer, if handle is valid, else nullptr
+ */
+GpuData::WorkerBuffer*
+GpuData::getBuffer(const BufferHandle &handle)
+{
+    std::shared_lock<std::shared_mutex> guard(m_lock.mutex);
+
+    if(handle.id >= m_bufferHandles.size()
+            || handle.generation != m_bufferHandleGeneration)
+    {
+        return nullptr;
     }
 
-    return nullptr;
+    return m_bufferHandles[handle.id];
+}
+
+/**
+ * @brief register a new buffer, which was already prepared by the interface
+ *
+ * @param name name of the buffer
+ * @param buffer buffer to insert
+ *
+ * @return pointer to the inserted buffer, or nullptr if the name already exist
+ */
+GpuData::WorkerBuffer*
+GpuData::insertBuffer(const std::string &name,
+                      const WorkerBuffer &buffer)
+{
+    std::unique_lock<std::shared_mutex> guard(m_lock.mutex);
+
+    auto ret = m_buffer.insert(std::make_pair(name, buffer));
+    if(ret.second == false) {
+        return nullptr;
+    }
+
+    return &ret.first->second;
+}
+
+/**
+ * @brief remove all buffer and invalidate all existing buffer-handles
+ */
+void
+GpuData::clearBuffer()
+{
+    std::unique_lock<std::shared_mutex> guard(m_lock.mutex);
+
+    m_buffer.clear();
+    m_bufferHandles.clear();
+    m_bufferHandleGeneration++;
+}
+
+/**
+ * @brief get a handle of a buffer, which can be used instead of the name for the runtime-functions
+ *        of the interface to avoid the lookup of the name. The handle stays valid until the buffer
+ *        are removed by closing the device.
+ *
+ * @param name name of the buffer
+ *
+ * @return handle of the buffer, which is invalid if the name doesn't exist
+ */
+BufferHandle
+GpuData::getBufferHandle(const std::string &name)
+{
+    BufferHandle handle;
+
+    // reuse existing handle of the buffer, which only requires reading
+    {
+        std::shared_lock<std::shared_mutex> guard(m_lock.mutex);
+
+        handle.generation = m_bufferHandleGeneration;
+        WorkerBuffer* buffer = findBuffer(name);
+        if(buffer == nullptr) {
+            return handle;
+        }
+
+        for(uint32_t i = 0; i < m_bufferHandles.size(); i++)
+        {
+            if(m_bufferHandles[i] == buffer)
+            {
+                handle.id = i;
+                return handle;
+            }
+        }
+    }
+
+    // register new handle, where the check has to be repeated, because another thread could
+    // have registered the same buffer in the meantime
+    std::unique_lock<std::shared_mutex> guard(m_lock.mutex);
+
+    handle.generation = m_bufferHandleGeneration;
+    WorkerBuffer* buffer = findBuffer(name);
+    if(buffer == nullptr) {
+        return handle;
+    }
+
+    for(uint32_t i = 0; i < m_bufferHandles.size(); i++)
+    {
+        if(m_bufferHandles[i] == buffer)
+        {
+            handle.id = i;
+            return handle;
+        }
+    }
+
+    handle.id = static_cast<uint32_t>(m_bufferHandles.size());
+    m_bufferHandles.push_back(buffer);
+
+    return handle;
 }
 
 /**
@@ -108,13 +241,8 @@ GpuData::getBuffer(const std::string &name)
 bool
 GpuData::containsBuffer(const std::string &name)
 {
-    std::map<std::string, WorkerBuffer>::const_iterator it;
-    it = m_buffer.find(name);
-    if(it != m_buffer.end()) {
-        return true;
-    }
-
-    return false;
+    std::shared_lock<std::shared_mutex> guard(m_lock.mutex);
+    return findBuffer(name) != nullptr;
 }
 
 /**
@@ -127,10 +255,11 @@ GpuData::containsBuffer(const std::string &name)
 void*
 GpuData::getBufferData(const std::string &name)
 {
-    std::map<std::string, WorkerBuffer>::iterator it;
-    it = m_buffer.find(name);
-    if(it != m_buffer.end()) {
-        return it->second.data;
+    std::shared_lock<std::shared_mutex> guard(m_lock.mutex);
+
+    WorkerBuffer* buffer = findBuffer(name);
+    if(buffer != nullptr) {
+        return buffer->data;
     }
 
     return nullptr;
@@ -146,13 +275,8 @@ GpuData::getBufferData(const std::string &name)
 bool
 GpuData::containsKernel(const std::string &name)
 {
-    std::map<std::string, KernelDef>::const_iterator it;
-    it = m_kernel.find(name);
-    if(it != m_kernel.end()) {
-        return true;
-    }
-
-    return false;
+    std::shared_lock<std::shared_mutex> guard(m_lock.mutex);
+    return findKernel(name) != nullptr;
 }
 
 /**
@@ -164,6 +288,153 @@ GpuData::containsKernel(const std::string &name)
  */
 GpuData::KernelDef*
 GpuData::getKernel(const std::string &name)
+{
+    std::shared_lock<std::shared_mutex> guard(m_lock.mutex);
+    return findKernel(name);
+}
+
+/**
+ * @brief get kernel def object by handle without any string-comparison
+ *
+ * @param handle handle of the kernel
+ *
+ * @return nullptr if handle is invalid, else pointer to requested object
+ */
+GpuData::KernelDef*
+GpuData::getKernel(const KernelHandle &handle)
+{
+    std::shared_lock<std::shared_mutex> guard(m_lock.mutex);
+
+    if(handle.id >= m_kernelHandles.size()
+            || handle.generation != m_kernelHandleGeneration)
+    {
+        return nullptr;
+    }
+
+    return m_kernelHandles[handle.id];
+}
+
+/**
+ * @brief get a handle of a kernel, which can be used instead of the name for running the kernel
+ *        to avoid the lookup of the name. The handle stays valid until the kernels are removed
+ *        from the data-object.
+ *
+ * @param name name of the kernel
+ *
+ * @return handle of the kernel, which is invalid if the name doesn't exist
+ */
+KernelHandle
+GpuData::getKernelHandle(const std::string &name)
+{
+    KernelHandle handle;
+
+    // reuse existing handle of the kernel, which only requires reading
+    {
+        std::shared_lock<std::shared_mutex> guard(m_lock.mutex);
+
+        handle.generation = m_kernelHandleGeneration;
+        KernelDef* def = findKernel(name);
+        if(def == nullptr) {
+            return handle;
+        }
+
+        for(uint32_t i = 0; i < m_kernelHandles.size(); i++)
+        {
+            if(m_kernelHandles[i] == def)
+            {
+                handle.id = i;
+                return handle;
+            }
+        }
+    }
+
+    // register new handle and repeat the check, like for the buffer-handles
+    std::unique_lock<std::shared_mutex> guard(m_lock.mutex);
+
+    handle.generation = m_kernelHandleGeneration;
+    KernelDef* def = findKernel(name);
+    if(def == nullptr) {
+        return handle;
+    }
+
+    for(uint32_t i = 0; i < m_kernelHandles.size(); i++)
+    {
+        if(m_kernelHandles[i] == def)
+        {
+            handle.id = i;
+            return handle;
+        }
+    }
+
+    handle.id = static_cast<uint32_t>(m_kernelHandles.size());
+    m_kernelHandles.push_back(def);
+
+    return handle;
+}
+
+/**
+ * @brief register a new kernel, which was already prepared by the interface
+ *
+ * @param name name of the kernel
+ * @param kernelDef kernel to insert
+ *
+ * @return pointer to the inserted kernel, or nullptr if the name already exist
+ */
+GpuData::KernelDef*
+GpuData::insertKernel(const std::string &name,
+                      const KernelDef &kernelDef)
+{
+    std::unique_lock<std::shared_mutex> guard(m_lock.mutex);
+
+    auto ret = m_kernel.insert(std::make_pair(name, kernelDef));
+    if(ret.second == false) {
+        return nullptr;
+    }
+
+    return &ret.first->second;
+}
+
+/**
+ * @brief remove all kernel and invalidate all existing kernel-handles
+ */
+void
+GpuData::clearKernel()
+{
+    std::unique_lock<std::shared_mutex> guard(m_lock.mutex);
+
+    m_kernel.clear();
+    m_kernelHandles.clear();
+    m_kernelHandleGeneration++;
+}
+
+/**
+ * @brief get worker-buffer without locking, so the caller must already hold the lock
+ *
+ * @param name name of the buffer
+ *
+ * @return pointer to worker-buffer, if name found, else nullptr
+ */
+GpuData::WorkerBuffer*
+GpuData::findBuffer(const std::string &name)
+{
+    std::map<std::string, WorkerBuffer>::iterator it;
+    it = m_buffer.find(name);
+    if(it != m_buffer.end()) {
+        return &it->second;
+    }
+
+    return nullptr;
+}
+
+/**
+ * @brief get kernel without locking, so the caller must already hold the lock
+ *
+ * @param name name of the kernel
+ *
+ * @return nullptr if name not exist, else pointer to requested object
+ */
+GpuData::KernelDef*
+GpuData::findKernel(const std::string &name)
 {
     std::map<std::string, KernelDef>::iterator it;
     it = m_kernel.find(name);
@@ -0,0 +1,136 @@
+/**
+ * @file        gpu_event.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include <libKitsunemimiOpencl/gpu_event.h>
+
+namespace Kitsunemimi
+{
+
+GpuEvent::GpuEvent() {}
+
+/**
+ * @brief block until the related operation on the device is finished
+ *
+ * @return false, if the operation failed, else true
+ */
+bool
+GpuEvent::wait()
+{
+    // event was not used for any operation, so there is nothing to wait for
+    if(m_isActive == false) {
+        return true;
+    }
+
+    try
+    {
+        if(m_event.wait() != CL_SUCCESS) {
+            return false;
+        }
+    }
+    catch(const cl::Error &)
+    {
+        return false;
+    }
+
+    m_isActive = false;
+
+    return true;
+}
+
+/**
+ * @brief check without blocking, if the related operation on the device is finished
+ *
+ * @return true, if finished or failed, else false
+ */
+bool
+GpuEvent::isFinished()
+{
+    if(m_isActive == false) {
+        return true;
+    }
+
+    try
+    {
+        // negative values are error-codes and mark also the end of the operation
+        const cl_int status = m_event.getInfo<CL_EVENT_COMMAND_EXECUTION_STATUS>();
+        if(status > CL_COMPLETE) {
+            return false;
+        }
+    }
+    catch(const cl::Error &) {}
+
+    return true;
+}
+
+/**
+ * @brief check if the event is related to an enqueued operation, which was not waited for
+ *
+ * @return true, if active, else false
+ */
+bool
+GpuEvent::isActive() const
+{
+    return m_isActive;
+}
+
+/**
+ * @brief block until all given operations on the device are finished
+ *
+ * @param events list of events to wait for
+ *
+ * @return false, if at least one of the operations failed, else true
+ */
+bool
+GpuEvent::waitForAll(std::vector<GpuEvent> &events)
+{
+    // collect all events, which are still in use, to wait for all of them with one call
+    std::vector<cl::Event> activeEvents;
+    for(GpuEvent &event : events)
+    {
+        if(event.m_isActive) {
+            activeEvents.push_back(event.m_event);
+        }
+    }
+
+    if(activeEvents.size() == 0) {
+        return true;
+    }
+
+    try
+    {
+        if(cl::Event::waitForEvents(activeEvents) != CL_SUCCESS) {
+            return false;
+        }
+    }
+    catch(const cl::Error &)
+    {
+        return false;
+    }
+
+    for(GpuEvent &event : events) {
+        event.m_isActive = false;
+    }
+
+    return true;
+}
+
+}
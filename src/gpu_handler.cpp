@@ -31,15 +31,40 @@ namespace Kitsunemimi
 GpuHandler::GpuHandler() {}
 
 /**
- * @brief initialize opencl
+ * @brief initialize opencl with all available devices
  *
- * @param config object with config-parameter
  * @param error reference for error-output
+ * @param sharedContext true to create one context for all devices of a platform, which is
+ *                      shared by their interfaces, so buffer can be copied directly between
+ *                      these devices
  *
  * @return true, if creation was successful, else false
  */
 bool
-GpuHandler::initDevice(ErrorContainer &error)
+GpuHandler::initDevice(ErrorContainer &error,
+                       const bool sharedContext)
+{
+    const DeviceFilter filter;
+    return initDevice(filter, error, sharedContext);
+}
+
+/**
+ * @brief initialize opencl with all devices, which match the filter. The interfaces are sorted
+ *        from the best to the worst device and the context and queue of each interface are
+ *        created not before its first use, so unused devices cost nearly nothing.
+ *
+ * @param filter filter to select the devices
+ * @param error reference for error-output
+ * @param sharedContext true to create one context for all selected devices of a platform, which
+ *                      is shared by their interfaces, so buffer can be copied directly between
+ *                      these devices
+ *
+ * @return true, if creation was successful, else false
+ */
+bool
+GpuHandler::initDevice(const DeviceFilter &filter,
+                       ErrorContainer &error,
+                       const bool sharedContext)
 {
     if(m_isInit) {
         return true;
@@ -60,7 +85,14 @@ GpuHandler::initDevice(ErrorContainer &error)
 
         LOG_DEBUG("number of OpenCL platforms: " + std::to_string(m_platform.size()));
 
-        collectDevices();
+        collectDevices(filter, sharedContext);
+        if(m_interfaces.empty())
+        {
+            error.addMeesage("No OpenCL device matches the filter.");
+            LOG_ERROR(error);
+            return false;
+        }
+
         m_isInit = true;
     }
     catch(const cl::Error &err)
@@ -78,26 +110,32 @@ GpuHandler::initDevice(ErrorContainer &error)
 }
 
 /**
- * @brief collect all available devices
+ * @brief collect all available devices, which match the filter
  *
- * @param config object with config-parameter
+ * @param filter filter to select the devices
+ * @param sharedContext true to create one context for all selected devices of a platform
  */
 void
-GpuHandler::collectDevices()
+GpuHandler::collectDevices(const DeviceFilter &filter,
+                           const bool sharedContext)
 {
+    std::vector<cl::Device> selectedDevices;
+    std::vector<uint64_t> platformIds;
+
     // get available platforms
-    for(cl::Platform &platform : m_platform)
+    for(uint64_t platformId = 0; platformId < m_platform.size(); platformId++)
     {
         // get available devices of the selected platform
         std::vector<cl::Device> pldev;
-        platform.getDevices(CL_DEVICE_TYPE_ALL, &pldev);
+        m_platform[platformId].getDevices(CL_DEVICE_TYPE_ALL, &pldev);
         LOG_DEBUG("number of OpenCL devices: " + std::to_string(pldev.size()));
 
         // select devices within the platform
         for(cl::Device &device : pldev)
         {
             // check if device is available
-            if(device.getInfo<CL_DEVICE_AVAILABLE>())
+            if(device.getInfo<CL_DEVICE_AVAILABLE>()
+                    && matchFilter(device, filter))
             {
                 /*if(false)
                 {
@@ -111,10 +149,131 @@ GpuHandler::collectDevices()
                     }
                 }*/
 
-                m_interfaces.push_back(new GpuInterface(device));
+                selectedDevices.push_back(device);
+                platformIds.push_back(platformId);
+            }
+        }
+    }
+
+    // sort devices from best to worst with a stable insertion-sort, to keep the order of the
+    // platforms for equal devices
+    for(uint64_t i = 1; i < selectedDevices.size(); i++)
+    {
+        for(uint64_t j = i;
+            j > 0 && isBetterDevice(selectedDevices[j], selectedDevices[j - 1]);
+            j--)
+        {
+            std::swap(selectedDevices[j], selectedDevices[j - 1]);
+            std::swap(platformIds[j], platformIds[j - 1]);
+        }
+    }
+
+    if(filter.maxNumberOfDevices != 0
+            && selectedDevices.size() > filter.maxNumberOfDevices)
+    {
+        selectedDevices.resize(filter.maxNumberOfDevices);
+        platformIds.resize(filter.maxNumberOfDevices);
+    }
+
+    // create one context for the selected devices of each platform
+    std::vector<cl::Context> contexts(m_platform.size());
+    if(sharedContext)
+    {
+        for(uint64_t platformId = 0; platformId < m_platform.size(); platformId++)
+        {
+            std::vector<cl::Device> platformDevices;
+            for(uint64_t i = 0; i < selectedDevices.size(); i++)
+            {
+                if(platformIds[i] == platformId) {
+                    platformDevices.push_back(selectedDevices[i]);
+                }
+            }
+
+            if(platformDevices.size() > 0) {
+                contexts[platformId] = cl::Context(platformDevices);
             }
         }
     }
+
+    for(uint64_t i = 0; i < selectedDevices.size(); i++)
+    {
+        GpuInterface* interface = nullptr;
+        if(sharedContext) {
+            interface = new GpuInterface(selectedDevices[i], contexts[platformIds[i]], true);
+        } else {
+            interface = new GpuInterface(selectedDevices[i], true);
+        }
+        m_interfaces.push_back(interface);
+    }
+}
+
+/**
+ * @brief check if a device matches the filter
+ *
+ * @param device device to check
+ * @param filter filter to select the devices
+ *
+ * @return true, if the device matches, else false
+ */
+bool
+GpuHandler::matchFilter(const cl::Device &device,
+                        const DeviceFilter &filter)
+{
+    if((device.getInfo<CL_DEVICE_TYPE>() & filter.deviceType) == 0) {
+        return false;
+    }
+
+    if(filter.name != ""
+            && device.getInfo<CL_DEVICE_NAME>().find(filter.name) == std::string::npos)
+    {
+        return false;
+    }
+
+    if(device.getInfo<CL_DEVICE_GLOBAL_MEM_SIZE>() < filter.minGlobalMemory) {
+        return false;
+    }
+
+    if(device.getInfo<CL_DEVICE_MAX_COMPUTE_UNITS>() < filter.minComputeUnits) {
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief compare two devices for the ranking. GPUs and accelerators are preferred over all
+ *        other devices, because a single compute-unit of them processes many work-items at
+ *        the same time. Within the same class the device with the higher product of compute-units
+ *        and clock-frequency is better and at last the one with more global memory.
+ *
+ * @param first first device
+ * @param second second device
+ *
+ * @return true, if the first device is better than the second one, else false
+ */
+bool
+GpuHandler::isBetterDevice(const cl::Device &first,
+                           const cl::Device &second)
+{
+    const cl_device_type parallelTypes = CL_DEVICE_TYPE_GPU | CL_DEVICE_TYPE_ACCELERATOR;
+    const bool firstParallel = (first.getInfo<CL_DEVICE_TYPE>() & parallelTypes) != 0;
+    const bool secondParallel = (second.getInfo<CL_DEVICE_TYPE>() & parallelTypes) != 0;
+    if(firstParallel != secondParallel) {
+        return firstParallel;
+    }
+
+    const uint64_t firstPower =
+            static_cast<uint64_t>(first.getInfo<CL_DEVICE_MAX_COMPUTE_UNITS>())
+            * first.getInfo<CL_DEVICE_MAX_CLOCK_FREQUENCY>();
+    const uint64_t secondPower =
+            static_cast<uint64_t>(second.getInfo<CL_DEVICE_MAX_COMPUTE_UNITS>())
+            * second.getInfo<CL_DEVICE_MAX_CLOCK_FREQUENCY>();
+    if(firstPower != secondPower) {
+        return firstPower > secondPower;
+    }
+
+    return first.getInfo<CL_DEVICE_GLOBAL_MEM_SIZE>()
+           > second.getInfo<CL_DEVICE_GLOBAL_MEM_SIZE>();
 }
 
 }
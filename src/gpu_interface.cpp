@@ -21,6 +21,14 @@
  */
 
 #include <libKitsunemimiOpencl/gpu_interface.h>
+#include <libKitsunemimiOpencl/program_cache.h>
+#include <libKitsunemimiOpencl/gpu_profiler.h>
+#include <libKitsunemimiOpencl/gpu_tracer.h>
+#include <libKitsunemimiOpencl/work_group_tuner.h>
+
+#include <filesystem>
+#include <algorithm>
+#include <set>
 
 #include <libKitsunemimiCommon/logger.h>
 
@@ -31,189 +39,122 @@ namespace Kitsunemimi
  * @brief constructor
  *
  * @param device opencl-device
+ * @param lazyInit true to create context and queue not before the first use of the interface
  */
-GpuInterface::GpuInterface(const cl::Device &device)
+GpuInterface::GpuInterface(const cl::Device &device,
+                           const bool lazyInit)
 {
     LOG_DEBUG("created new gpu-interface for OpenCL device: " + device.getInfo<CL_DEVICE_NAME>());
 
     m_device = device;
-    m_context = cl::Context(m_device);
-    m_queue = cl::CommandQueue(m_context, m_device);
-}
 
-/**
- * @brief destructor to close at least the device-connection
- */
-GpuInterface::~GpuInterface()
-{
-    GpuData emptyData;
-    closeDevice(emptyData);
+    if(lazyInit == false)
+    {
+        ErrorContainer error;
+        initContext(error);
+    }
 }
 
 /**
- * @brief copy data from host to device
- *
- * @param data object with all data
- * @param error reference for error-output
+ * @brief constructor for a device within an existing context, which can be shared with the
+ *        interfaces of other devices of the same platform
  *
- * @return true, if successful, else false
+ * @param device opencl-device
+ * @param context context, which contains the device
+ * @param lazyInit true to create the queue not before the first use of the interface
  */
-bool
-GpuInterface::initCopyToDevice(GpuData &data,
-                               ErrorContainer &error)
+GpuInterface::GpuInterface(const cl::Device &device,
+                           const cl::Context &context,
+                           const bool lazyInit)
 {
-    LOG_DEBUG("initial data transfer to OpenCL device");
+    LOG_DEBUG("created new gpu-interface with shared context for OpenCL device: "
+              + device.getInfo<CL_DEVICE_NAME>());
 
-    // precheck
-    if(validateWorkerGroupSize(data, error) == false) {
-        return false;
-    }
+    m_device = device;
+    m_context = context;
 
-    // send input to device
-    for(auto& [name, workerBuffer] : data.m_buffer)
+    if(lazyInit == false)
     {
-        LOG_DEBUG("copy data to device: "
-                  + std::to_string(workerBuffer.numberOfBytes)
-                  + " Bytes");
-
-        // check buffer
-        if(workerBuffer.numberOfBytes == 0
-                || workerBuffer.numberOfObjects == 0
-                || workerBuffer.data == nullptr)
-        {
-            error.addMeesage("failed to copy data to device, because buffer with name '"
-                             + name
-                             + "' has size 0 or is not initialized.");
-            LOG_ERROR(error);
-            return false;
-        }
-
-        // create flag for memory handling
-        cl_mem_flags flags = 0;
-        if(workerBuffer.useHostPtr) {
-            flags = CL_MEM_READ_ONLY | CL_MEM_USE_HOST_PTR;
-        } else {
-            flags = CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR;
-        }
-
-        // send data or reference to device
-        workerBuffer.clBuffer = cl::Buffer(m_context,
-                                           flags,
-                                           workerBuffer.numberOfBytes,
-                                           workerBuffer.data);
+        ErrorContainer error;
+        initContext(error);
     }
-
-    return true;
 }
 
 /**
- * @brief add kernel to device
- *
- * @param data object with all data
- * @param kernelName name of the kernel
- * @param kernelCode kernel source-code as string
- * @param error reference for error-output
- *
- * @return true, if successful, else false
+ * @brief destructor to close at least the device-connection
  */
-bool
-GpuInterface::addKernel(GpuData &data,
-                        const std::string &kernelName,
-                        const std::string &kernelCode,
-                        ErrorContainer &error)
+GpuInterface::~GpuInterface()
 {
-    LOG_DEBUG("add kernel with id: " + kernelName);
+    // running builds are using the program-cache
+    {
+        std::lock_guard<std::mutex> guard(m_pendingBuildLock);
+        for(PendingBuild &build : m_pendingBuilds) {
+            build.result.wait();
+        }
+        m_pendingBuilds.clear();
+    }
 
-    // compile opencl program for found device.
-    cl::Program::Sources source;
-    source.push_back(kernelCode);
-    cl::Program program(m_context, source);
+    // closeDevice only finishes the queue of the calling thread
+    finishQueues();
 
-    try
-    {
-        std::vector<cl::Device> devices = {m_device};
-        program.build(devices);
+    GpuData emptyData;
+    closeDevice(emptyData);
+    if(m_isInit) {
+        m_bufferPool.clear(m_queue);
     }
-    catch(const cl::Error&err)
-    {
-        error.addMeesage("OpenCL compilation error\n    "
-                         + program.getBuildInfo<CL_PROGRAM_BUILD_LOG>(m_device));
-        return false;
+
+    if(m_programCache != nullptr) {
+        delete m_programCache;
     }
 
-    GpuData::KernelDef def;
-    def.id = kernelName;
-    def.kernelCode = kernelCode;
-    def.kernel = cl::Kernel(program, kernelName.c_str());
+    if(m_workGroupTuner != nullptr) {
+        delete m_workGroupTuner;
+    }
 
-    data.m_kernel.insert(std::make_pair(kernelName, def));
+    if(m_profiler != nullptr) {
+        delete m_profiler;
+    }
 
-    return true;
+    if(m_tracer != nullptr) {
+        delete m_tracer;
+    }
 }
 
 /**
- * @brief bind a buffer to a kernel
+ * @brief create context and queue of the device, if not already done. This is called by all
+ *        functions, which need them, so it is only necessary to call it explicitly, before
+ *        m_context or m_queue are used directly.
  *
- * @param data data-object with the buffer to bind
- * @param kernelName, name of the kernel, which should be used
- * @param bufferName name of buffer, which should be bind to the kernel
  * @param error reference for error-output
  *
  * @return true, if successful, else false
  */
 bool
-GpuInterface::bindKernelToBuffer(GpuData &data,
-                                 const std::string &kernelName,
-                                 const std::string &bufferName,
-                                 ErrorContainer &error)
+GpuInterface::initContext(ErrorContainer &error)
 {
-    LOG_DEBUG("bind buffer with name '" + bufferName + "' kernel with name: '" + kernelName + "'");
-
-    // get kernel-data
-    if(data.containsKernel(kernelName) == false)
-    {
-        error.addMeesage("no kernel with name '" + kernelName + "' found");
-        return false;
-    }
-
-    // check if buffer-name exist
-    if(data.containsBuffer(bufferName) == false)
-    {
-        ErrorContainer error;
-        error.addMeesage("no buffer with name '" + bufferName + "' found");
-        return false;
+    if(m_isInit) {
+        return true;
     }
 
-    // get kernel
-    GpuData::KernelDef* def = data.getKernel(kernelName);
-    if(def == nullptr)
-    {
-        error.addMeesage("Kernel with name '" + kernelName + "' not found.");
-        return false;
-    }
-
-    // get buffer to bind to kernel
-    GpuData::WorkerBuffer* buffer = &data.m_buffer[bufferName];
-    if(buffer == nullptr)
-    {
-        error.addMeesage("Buffer with name '" + bufferName + "' not found.");
-        return false;
+    // the context of a lazy interface can be requested by multiple threads at the same time
+    std::lock_guard<std::mutex> guard(m_initLock);
+    if(m_isInit) {
+        return true;
     }
 
-    // register arguments in opencl
-    const uint32_t argNumber = static_cast<uint32_t>(def->arguments.size());
+    LOG_DEBUG("create context and queue for OpenCL device: "
+              + m_device.getInfo<CL_DEVICE_NAME>());
 
-    LOG_DEBUG("bind buffer with name '"
-              + bufferName
-              + "' to argument number "
-              + std::to_string(argNumber));
     try
     {
-        def->kernel.setArg(argNumber, buffer->clBuffer);
+        if(m_context() == nullptr) {
+            m_context = cl::Context(m_device);
+        }
+        m_queue = cl::CommandQueue(m_context, m_device, m_queueProperties);
     }
-    catch(const cl::Error&err)
+    catch(const cl::Error &err)
     {
-        error.addMeesage("OpenCL error while binding buffer to kernel: "
+        error.addMeesage("OpenCL error while creating context and queue: "
                          + std::string(err.what())
                          + "("
                          + std::to_string(err.err())
@@ -222,345 +163,4421 @@ GpuInterface::bindKernelToBuffer(GpuData &data,
         return false;
     }
 
-    // register on which argument-position the buffer was binded
-    def->arguments.insert(std::make_pair(bufferName, argNumber));
+    // unused buffer in the pool should not block new allocations, so by default the pool keeps
+    // not more than a quarter of the device-memory (can be changed with getBufferPool)
+    const uint64_t poolLimit = m_device.getInfo<CL_DEVICE_GLOBAL_MEM_SIZE>() / 4;
+    m_bufferPool.setLimits(poolLimit, poolLimit);
+
+    m_isInit = true;
 
     return true;
 }
 
 /**
- * @brief setLocalMemory
+ * @brief check if context and queue of the device are already created
  *
- * @param data object with all data
- * @param kernelName, name of the kernel, which should be executed
- * @param localMemorySize size of the local mamory
- * @param error reference for error-output
- *
- * @return true, if successful, else false
+ * @return true, if initialized, else false
  */
 bool
-GpuInterface::setLocalMemory(GpuData &data,
-                             const std::string &kernelName,
-                             const uint32_t localMemorySize,
-                             ErrorContainer &error)
+GpuInterface::isInitialized() const
 {
-    // get kernel-data
-    if(data.containsKernel(kernelName) == false)
-    {
-        error.addMeesage("no kernel with name '" + kernelName + "' found");
-        return false;
-    }
-
-    // set arguments
-    GpuData::KernelDef* def = data.getKernel(kernelName);
-    def->kernel.setArg(static_cast<uint32_t>(def->arguments.size()), localMemorySize, nullptr);
-
-    return true;
+    return m_isInit;
 }
 
-
 /**
- * @brief update data inside the buffer on the device
+ * @brief register new buffer with pinned host-memory. The memory is allocated by the driver, so
+ *        transfers between host and device don't need an additional copy within the driver and
+ *        can use the full DMA-bandwidth. The memory is taken from the pool of the interface and
+ *        given back to the pool by closeDevice, so it can be reused by the next data-object.
  *
- * @param data object with all data
- * @param bufferName name of the buffer in the kernel
+ * @param data data-object, where the buffer should be added
+ * @param name name of the new buffer
+ * @param numberOfObjects number of objects, which have to be allocated
+ * @param objectSize number of bytes of a single object to allocate
  * @param error reference for error-output
- * @param numberOfObjects number of objects to copy
- * @param offset offset in buffer on device
  *
- * @return false, if copy failed of buffer is output-buffer, else true
+ * @return false, if name already is registered or allocation failed, else true
  */
 bool
-GpuInterface::updateBufferOnDevice(GpuData &data,
-                                   const std::string &bufferName,
-                                   ErrorContainer &error,
-                                   uint64_t numberOfObjects,
-                                   const uint64_t offset)
+GpuInterface::addPinnedBuffer(GpuData &data,
+                              const std::string &name,
+                              const uint64_t numberOfObjects,
+                              const uint64_t objectSize,
+                              ErrorContainer &error)
 {
-    // check id
-    if(data.containsBuffer(bufferName) == false)
+    if(initContext(error) == false) {
+        return false;
+    }
+
+    // precheck
+    if(data.containsBuffer(name))
     {
-        error.addMeesage("no buffer with name '" + bufferName + "' found");
+        error.addMeesage("buffer with name '" + name + "' already exist");
         return false;
     }
 
-    GpuData::WorkerBuffer* buffer = data.getBuffer(bufferName);
-    const uint64_t objectSize = buffer->numberOfBytes / buffer->numberOfObjects;
+    // prepare worker-buffer
+    GpuData::WorkerBuffer newBuffer;
+    newBuffer.name = name;
+    newBuffer.numberOfBytes = numberOfObjects * objectSize;
+    newBuffer.numberOfObjects = numberOfObjects;
+    newBuffer.objectSize = objectSize;
+    newBuffer.usePinnedMemory = true;
+    newBuffer.allowBufferDeleteAfterClose = false;
 
-    // set size with value of the buffer, if size not explitely set
-    if(numberOfObjects == 0) {
-        numberOfObjects = buffer->numberOfObjects;
+    // fix size of the bytes to allocate, if necessary by round up to a multiple of 4096 bytes
+    if(newBuffer.numberOfBytes % 4096 != 0) {
+        newBuffer.numberOfBytes += 4096 - (newBuffer.numberOfBytes % 4096);
     }
 
-    // check size
-    if(offset + numberOfObjects > buffer->numberOfObjects)
+    if(m_bufferPool.getPinnedMemory(m_context,
+                                    m_queue,
+                                    newBuffer.numberOfBytes,
+                                    newBuffer.pinnedBuffer,
+                                    newBuffer.data,
+                                    error) == false)
     {
-        error.addMeesage("write-position invalid");
         return false;
     }
 
-    // update buffer
-    if(buffer->useHostPtr == false
-            && numberOfObjects != 0)
-    {
-        // write data into the buffer on the device
-        if(m_queue.enqueueWriteBuffer(buffer->clBuffer,
-                                      CL_FALSE,
-                                      offset * objectSize,
-                                      numberOfObjects * objectSize,
-                                      buffer->data) != CL_SUCCESS)
-        {
-            error.addMeesage("Update buffer with name '" + bufferName + "' on gpu failed");
-            return false;
-        }
-    }
+    data.insertBuffer(name, newBuffer);
 
     return true;
 }
 
 /**
- * @brief run kernel with input
+ * @brief register many small buffer, which share one buffer on the device. The buffer are placed
+ *        with the base-address-alignment of the device into the arena and are created as
+ *        sub-buffer by initCopyToDevice, so there is only one allocation on the host and on the
+ *        device and no padding to full pages for each buffer. Adjacent buffer of an arena can be
+ *        updated with a single transfer by updateBuffersOnDevice.
  *
- * @param data input-data for the run
- * @param kernelName, name of the kernel, which should be executed
+ * @param data data-object, where the buffer should be added
+ * @param arenaName name of the arena, which can be used to update all buffer of the arena at once
+ * @param entries names and sizes of the buffer within the arena
  * @param error reference for error-output
  *
- * @return true, if successful, else false
+ * @return false, if a name already is registered or a size is invalid, else true
  */
 bool
-GpuInterface::run(GpuData &data,
-                  const std::string &kernelName,
-                  ErrorContainer &error)
+GpuInterface::addArena(GpuData &data,
+                       const std::string &arenaName,
+                       const std::vector<ArenaEntry> &entries,
+                       ErrorContainer &error)
 {
-    cl::Event event;
-    std::vector<cl::Event> events;
-    events.push_back(event);
-
-    // convert ranges
-    const cl::NDRange globalRange = cl::NDRange(data.numberOfWg.x * data.threadsPerWg.x,
-                                                data.numberOfWg.y * data.threadsPerWg.y,
-                                                data.numberOfWg.z * data.threadsPerWg.z);
-    const cl::NDRange localRange = cl::NDRange(data.threadsPerWg.x,
-                                               data.threadsPerWg.y,
-                                               data.threadsPerWg.z);
+    // precheck
+    if(data.containsBuffer(arenaName))
+    {
+        error.addMeesage("buffer with name '" + arenaName + "' already exist");
+        return false;
+    }
 
-    // get kernel-data
-    GpuData::KernelDef* def = data.getKernel(kernelName);
-    if(def == nullptr)
+    if(entries.size() == 0)
     {
-        error.addMeesage("no kernel with name '" + kernelName + "' found");
+        error.addMeesage("arena with name '" + arenaName + "' has no entries");
         return false;
     }
 
-    try
+    // the alignment is given by the device in bits
+    uint64_t alignment = m_device.getInfo<CL_DEVICE_MEM_BASE_ADDR_ALIGN>() / 8;
+    if(alignment == 0) {
+        alignment = 1;
+    }
+
+    // calculate positions of the buffer within the arena
+    std::set<std::string> names;
+    std::vector<uint64_t> offsets;
+    uint64_t arenaSize = 0;
+    for(const ArenaEntry &entry : entries)
     {
-        // launch kernel on the device
-        const uint32_t ret = m_queue.enqueueNDRangeKernel(def->kernel,
-                                                          cl::NullRange,
-                                                          globalRange,
-                                                          localRange,
-                                                          NULL,
-                                                          &events[0]);
-        if(ret != CL_SUCCESS)
+        if(entry.numberOfObjects == 0
+                || entry.objectSize == 0)
+        {
+            error.addMeesage("buffer with name '" + entry.name + "' has size 0");
+            return false;
+        }
+
+        if(data.containsBuffer(entry.name)
+                || entry.name == arenaName
+                || names.insert(entry.name).second == false)
         {
-            error.addMeesage("GPU-kernel failed with return-value: " + std::to_string(ret));
+            error.addMeesage("buffer with name '" + entry.name + "' already exist");
             return false;
         }
+
+        if(arenaSize % alignment != 0) {
+            arenaSize += alignment - (arenaSize % alignment);
+        }
+        offsets.push_back(arenaSize);
+        arenaSize += entry.numberOfObjects * entry.objectSize;
     }
-    catch(const cl::Error &err)
+
+    // create arena with the memory for all buffer
+    GpuData::WorkerBuffer arena;
+    arena.name = arenaName;
+    arena.numberOfBytes = arenaSize;
+    if(arena.numberOfBytes % 4096 != 0) {
+        arena.numberOfBytes += 4096 - (arena.numberOfBytes % 4096);
+    }
+    arena.numberOfObjects = arena.numberOfBytes;
+    arena.objectSize = 1;
+    arena.data = m_bufferPool.getHostMemory(arena.numberOfBytes);
+    arena.hostMemoryPool = &m_bufferPool;
+
+    GpuData::WorkerBuffer* arenaBuffer = data.insertBuffer(arenaName, arena);
+
+    // register buffer as views into the arena
+    for(uint64_t i = 0; i < entries.size(); i++)
     {
-        error.addMeesage("OpenCL error: "
-                         + std::string(err.what())
-                         + "("
-                         + std::to_string(err.err())
-                         + ")");
-        return false;
+        GpuData::WorkerBuffer newBuffer;
+        newBuffer.name = entries.at(i).name;
+        newBuffer.data = static_cast<uint8_t*>(arenaBuffer->data) + offsets.at(i);
+        newBuffer.numberOfBytes = entries.at(i).numberOfObjects * entries.at(i).objectSize;
+        newBuffer.numberOfObjects = entries.at(i).numberOfObjects;
+        newBuffer.objectSize = entries.at(i).objectSize;
+        newBuffer.allowBufferDeleteAfterClose = false;
+        newBuffer.arena = arenaBuffer;
+        newBuffer.arenaOffset = offsets.at(i);
+
+        data.insertBuffer(entries.at(i).name, newBuffer);
     }
 
     return true;
 }
 
 /**
- * @brief copy data of all as output marked buffer from device to host
+ * @brief copy data from host to device
  *
  * @param data object with all data
- * @param bufferName name of the buffer to copy into
  * @param error reference for error-output
  *
  * @return true, if successful, else false
  */
 bool
-GpuInterface::copyFromDevice(GpuData &data,
-                             const std::string &bufferName,
-                             ErrorContainer &error)
+GpuInterface::initCopyToDevice(GpuData &data,
+                               ErrorContainer &error)
 {
-    // check id
-    if(data.containsBuffer(bufferName) == false)
-    {
-        error.addMeesage("no buffer with name '" + bufferName + "' found");
+    if(initContext(error) == false) {
         return false;
     }
 
-    // copy result back to host
-    GpuData::WorkerBuffer* buffer = data.getBuffer(bufferName);
-    if(m_queue.enqueueReadBuffer(buffer->clBuffer,
-                                 CL_TRUE,
-                                 0,
-                                 buffer->numberOfBytes,
-                                 buffer->data) != CL_SUCCESS)
-    {
+    LOG_DEBUG("initial data transfer to OpenCL device");
+
+    // precheck
+    if(validateWorkerGroupSize(data, error) == false) {
         return false;
     }
 
-    return true;
-}
+    // send input to device
+    for(auto& [name, workerBuffer] : data.m_buffer)
+    {
+        // buffer of an arena are transfered together with the arena
+        if(workerBuffer.arena != nullptr) {
+            continue;
+        }
 
-/**
- * @brief GpuInterface::getDeviceName
- * @return
- */
-const std::string
-GpuInterface::getDeviceName()
-{
-    return m_device.getInfo<CL_DEVICE_NAME>();
-}
+        LOG_DEBUG("copy data to device: "
+                  + std::to_string(workerBuffer.numberOfBytes)
+                  + " Bytes");
+
+        // check buffer
+        if(workerBuffer.numberOfBytes == 0
+                || workerBuffer.numberOfObjects == 0
+                || workerBuffer.data == nullptr)
+        {
+            error.addMeesage("failed to copy data to device, because buffer with name '"
+                             + name
+                             + "' has size 0 or is not initialized.");
+            LOG_ERROR(error);
+            return false;
+        }
+
+        // host-pointer-buffer are only a reference to the memory of the host and can not be reused
+        if(workerBuffer.useHostPtr)
+        {
+            workerBuffer.clBuffer = cl::Buffer(m_context,
+                                               CL_MEM_READ_ONLY | CL_MEM_USE_HOST_PTR,
+                                               workerBuffer.numberOfBytes,
+                                               workerBuffer.data);
+            continue;
+        }
+
+        // take buffer from the pool, if available, and send data to device
+        if(m_bufferPool.getDeviceBuffer(m_context,
+                                        workerBuffer.numberOfBytes,
+                                        workerBuffer.clBuffer,
+                                        error) == false)
+        {
+            return false;
+        }
+
+        try
+        {
+            cl::Event* event = nullptr;
+            if(m_recordOperations) {
+                event = getProfilingEvent();
+            }
+
+            getQueue().enqueueWriteBuffer(workerBuffer.clBuffer,
+                                          CL_TRUE,
+                                          0,
+                                          workerBuffer.numberOfBytes,
+                                          workerBuffer.data,
+                                          nullptr,
+                                          event);
+            recordOperation("initCopyToDevice",
+                            PROFILE_WRITE,
+                            name,
+                            workerBuffer.numberOfBytes,
+                            event);
+        }
+        catch(const cl::Error &err)
+        {
+            error.addMeesage("OpenCL error while copy data to device: "
+                             + std::string(err.what())
+                             + "("
+                             + std::to_string(err.err())
+                             + ")");
+            LOG_ERROR(error);
+            return false;
+        }
+    }
+
+    // create buffer of arenas as views into the already existing arena-buffer
+    for(auto& [name, workerBuffer] : data.m_buffer)
+    {
+        if(workerBuffer.arena == nullptr) {
+            continue;
+        }
+
+        cl_buffer_region region;
+        region.origin = workerBuffer.arenaOffset;
+        region.size = workerBuffer.numberOfBytes;
+
+        try
+        {
+            workerBuffer.clBuffer = workerBuffer.arena->clBuffer.createSubBuffer(
+                                        CL_MEM_READ_WRITE,
+                                        CL_BUFFER_CREATE_TYPE_REGION,
+                                        &region);
+        }
+        catch(const cl::Error &err)
+        {
+            error.addMeesage("OpenCL error while creating sub-buffer '" + name + "': "
+                             + std::string(err.what())
+                             + "("
+                             + std::to_string(err.err())
+                             + ")");
+            LOG_ERROR(error);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief add kernel to device
+ *
+ * @param data object with all data
+ * @param kernelName name of the kernel
+ * @param kernelCode kernel source-code as string
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuInterface::addKernel(GpuData &data,
+                        const std::string &kernelName,
+                        const std::string &kernelCode,
+                        ErrorContainer &error)
+{
+    const KernelBuildOptions options;
+    return addKernel(data, kernelName, kernelCode, options, error);
+}
+
+/**
+ * @brief add kernel to device, which is compiled with additional defines and compiler-flags.
+ *        So constants can be given at compile-time instead of reading them from memory at
+ *        runtime. Each combination of source-code and options is compiled only once by the
+ *        interface.
+ *
+ * @param data object with all data
+ * @param kernelName name of the kernel
+ * @param kernelCode kernel source-code as string
+ * @param options defines and flags for the compiler
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuInterface::addKernel(GpuData &data,
+                        const std::string &kernelName,
+                        const std::string &kernelCode,
+                        const KernelBuildOptions &options,
+                        ErrorContainer &error)
+{
+    LOG_DEBUG("add kernel with id: " + kernelName);
+
+    std::string buildOptions = "";
+    if(convertBuildOptions(options, buildOptions, error) == false) {
+        return false;
+    }
+
+    // compile opencl program for found device.
+    cl::Program program;
+    if(buildProgram(program, kernelCode, buildOptions, error) == false) {
+        return false;
+    }
+
+    GpuData::KernelDef def;
+    def.id = kernelName;
+    def.kernelCode = kernelCode;
+    def.buildOptions = buildOptions;
+    def.program = program;
+    def.kernel = cl::Kernel(program, kernelName.c_str());
+
+    data.insertKernel(kernelName, def);
+
+    return true;
+}
+
+/**
+ * @brief add all kernels of a source-code to the device. The source is compiled only once and the
+ *        resulting program is shared by all kernels, which are registered by their function-name.
+ *
+ * @param data object with all data
+ * @param kernelCode kernel source-code as string, which can contain multiple kernels
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuInterface::addKernels(GpuData &data,
+                         const std::string &kernelCode,
+                         ErrorContainer &error)
+{
+    const KernelBuildOptions options;
+    return addKernels(data, kernelCode, options, error);
+}
+
+/**
+ * @brief add all kernels of a source-code to the device, which is compiled with additional
+ *        defines and compiler-flags like in addKernel
+ *
+ * @param data object with all data
+ * @param kernelCode kernel source-code as string, which can contain multiple kernels
+ * @param options defines and flags for the compiler
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuInterface::addKernels(GpuData &data,
+                         const std::string &kernelCode,
+                         const KernelBuildOptions &options,
+                         ErrorContainer &error)
+{
+    LOG_DEBUG("add all kernels of a program");
+
+    std::string buildOptions = "";
+    if(convertBuildOptions(options, buildOptions, error) == false) {
+        return false;
+    }
+
+    // compile opencl program for found device.
+    cl::Program program;
+    if(buildProgram(program, kernelCode, buildOptions, error) == false) {
+        return false;
+    }
+
+    // create all kernels of the program at once
+    std::vector<cl::Kernel> kernels;
+    try
+    {
+        program.createKernels(&kernels);
+    }
+    catch(const cl::Error &err)
+    {
+        error.addMeesage("OpenCL error while creating kernels: "
+                         + std::string(err.what())
+                         + "("
+                         + std::to_string(err.err())
+                         + ")");
+        LOG_ERROR(error);
+        return false;
+    }
+
+    // precheck names to register all or nothing
+    std::vector<std::string> kernelNames;
+    for(const cl::Kernel &kernel : kernels)
+    {
+        const std::string kernelName = kernel.getInfo<CL_KERNEL_FUNCTION_NAME>();
+        if(data.containsKernel(kernelName))
+        {
+            error.addMeesage("kernel with name '" + kernelName + "' already exist");
+            return false;
+        }
+        kernelNames.push_back(kernelName);
+    }
+
+    // register kernels
+    for(uint64_t i = 0; i < kernels.size(); i++)
+    {
+        LOG_DEBUG("add kernel with id: " + kernelNames.at(i));
+
+        GpuData::KernelDef def;
+        def.id = kernelNames.at(i);
+        def.kernelCode = kernelCode;
+        def.buildOptions = buildOptions;
+        def.program = program;
+        def.kernel = kernels.at(i);
+
+        data.insertKernel(kernelNames.at(i), def);
+    }
+
+    return true;
+}
+
+/**
+ * @brief start compiling a kernel in the background and return immediately. Multiple kernels
+ *        are compiled in parallel. The kernel can be used after waitForKernels was called for
+ *        the data-object.
+ *
+ * @param data data-object, where the kernel should be added
+ * @param kernelName name of the kernel
+ * @param kernelCode source-code of the kernel
+ * @param error reference for error-output
+ *
+ * @return false, if the context of the device could not be created, else true
+ */
+bool
+GpuInterface::addKernelAsync(GpuData &data,
+                             const std::string &kernelName,
+                             const std::string &kernelCode,
+                             ErrorContainer &error)
+{
+    const KernelBuildOptions options;
+    return addKernelAsync(data, kernelName, kernelCode, options, error);
+}
+
+/**
+ * @brief variant of addKernelAsync with additional defines and compiler-flags
+ *
+ * @param data data-object, where the kernel should be added
+ * @param kernelName name of the kernel
+ * @param kernelCode source-code of the kernel
+ * @param options defines and flags for the compiler
+ * @param error reference for error-output
+ *
+ * @return false, if the context of the device could not be created, else true
+ */
+bool
+GpuInterface::addKernelAsync(GpuData &data,
+                             const std::string &kernelName,
+                             const std::string &kernelCode,
+                             const KernelBuildOptions &options,
+                             ErrorContainer &error)
+{
+    LOG_DEBUG("add kernel asynchronously with id: " + kernelName);
+
+    // context must exist before the build-threads are started, because they only read it
+    if(initContext(error) == false) {
+        return false;
+    }
+
+    PendingBuild build;
+    build.data = &data;
+    build.kernelName = kernelName;
+    build.kernelCode = kernelCode;
+    if(convertBuildOptions(options, build.buildOptions, error) == false) {
+        return false;
+    }
+    const std::string buildOptions = build.buildOptions;
+    build.result = std::async(std::launch::async, [this, kernelCode, buildOptions]()
+    {
+        BuildResult result;
+        ErrorContainer buildError;
+        result.success = buildProgram(result.program, kernelCode, buildOptions, buildError);
+        if(result.success == false) {
+            result.errorMessage = buildError.toString();
+        }
+        return result;
+    }).share();
+
+    std::lock_guard<std::mutex> guard(m_pendingBuildLock);
+    build.id = m_nextBuildId++;
+    m_pendingBuilds.push_back(std::move(build));
+
+    return true;
+}
+
+/**
+ * @brief wait until all kernels, which were added with addKernelAsync to the data-object, are
+ *        compiled and add them to the data-object
+ *
+ * @param data data-object, where the kernels were added
+ * @param error reference for error-output, which contains the build-logs of failed kernels
+ *
+ * @return false, if at least one kernel failed, else true
+ */
+bool
+GpuInterface::waitForKernels(GpuData &data,
+                             ErrorContainer &error)
+{
+    bool success = true;
+
+    // get the builds of the data-object, but wait for them without holding the lock, so other
+    // threads can start and wait for their own builds in the meantime. The builds stay in the
+    // list until they are finished, so the destructor still waits for them.
+    std::vector<PendingBuild> builds;
+    {
+        std::lock_guard<std::mutex> guard(m_pendingBuildLock);
+        for(const PendingBuild &build : m_pendingBuilds)
+        {
+            if(build.data == &data) {
+                builds.push_back(build);
+            }
+        }
+    }
+
+    for(const PendingBuild &build : builds)
+    {
+        const BuildResult result = build.result.get();
+        if(result.success)
+        {
+            try
+            {
+                GpuData::KernelDef def;
+                def.id = build.kernelName;
+                def.kernelCode = build.kernelCode;
+                def.buildOptions = build.buildOptions;
+                def.program = result.program;
+                def.kernel = cl::Kernel(result.program, build.kernelName.c_str());
+
+                data.insertKernel(build.kernelName, def);
+            }
+            catch(const cl::Error &err)
+            {
+                error.addMeesage("OpenCL error while creating kernel '"
+                                 + build.kernelName
+                                 + "': "
+                                 + std::string(err.what())
+                                 + "("
+                                 + std::to_string(err.err())
+                                 + ")");
+                success = false;
+            }
+        }
+        else
+        {
+            error.addMeesage("failed to compile kernel '"
+                             + build.kernelName
+                             + "': "
+                             + result.errorMessage);
+            success = false;
+        }
+    }
+
+    // remove the evaluated builds
+    std::lock_guard<std::mutex> guard(m_pendingBuildLock);
+    for(const PendingBuild &build : builds)
+    {
+        std::vector<PendingBuild>::iterator it = m_pendingBuilds.begin();
+        while(it != m_pendingBuilds.end())
+        {
+            if(it->id == build.id)
+            {
+                m_pendingBuilds.erase(it);
+                break;
+            }
+            it++;
+        }
+    }
+
+    return success;
+}
+
+/**
+ * @brief bind a buffer to a kernel
+ *
+ * @param data data-object with the buffer to bind
+ * @param kernelName, name of the kernel, which should be used
+ * @param bufferName name of buffer, which should be bind to the kernel
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuInterface::bindKernelToBuffer(GpuData &data,
+                                 const std::string &kernelName,
+                                 const std::string &bufferName,
+                                 ErrorContainer &error)
+{
+    LOG_DEBUG("bind buffer with name '" + bufferName + "' kernel with name: '" + kernelName + "'");
+
+    // get kernel
+    GpuData::KernelDef* def = data.getKernel(kernelName);
+    if(def == nullptr)
+    {
+        error.addMeesage("no kernel with name '" + kernelName + "' found");
+        return false;
+    }
+
+    // get buffer to bind to kernel
+    GpuData::WorkerBuffer* buffer = data.getBuffer(bufferName);
+    if(buffer == nullptr)
+    {
+        error.addMeesage("no buffer with name '" + bufferName + "' found");
+        return false;
+    }
+
+    // register arguments in opencl
+    const uint32_t argNumber = def->argumentCounter;
+
+    LOG_DEBUG("bind buffer with name '"
+              + bufferName
+              + "' to argument number "
+              + std::to_string(argNumber));
+    try
+    {
+        def->kernel.setArg(argNumber, buffer->clBuffer);
+    }
+    catch(const cl::Error&err)
+    {
+        error.addMeesage("OpenCL error while binding buffer to kernel: "
+                         + std::string(err.what())
+                         + "("
+                         + std::to_string(err.err())
+                         + ")");
+        LOG_ERROR(error);
+        return false;
+    }
+
+    // register on which argument-position the buffer was binded
+    def->arguments.insert(std::make_pair(bufferName, argNumber));
+    def->boundBuffers.push_back(buffer);
+    def->argumentCounter++;
+
+    return true;
+}
+
+/**
+ * @brief set the size of a local-memory argument of a kernel. Each call reserves the next free
+ *        argument-position of the kernel, like the buffer in bindKernelToBuffer and the values
+ *        in setKernelArgument, so it must be called in the order of the kernel-parameters.
+ *
+ * @param data object with all data
+ * @param kernelName, name of the kernel, which should be executed
+ * @param localMemorySize size of the local mamory
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuInterface::setLocalMemory(GpuData &data,
+                             const std::string &kernelName,
+                             const uint32_t localMemorySize,
+                             ErrorContainer &error)
+{
+    // get kernel-data
+    GpuData::KernelDef* def = data.getKernel(kernelName);
+    if(def == nullptr)
+    {
+        error.addMeesage("no kernel with name '" + kernelName + "' found");
+        return false;
+    }
+
+    // set arguments
+    const uint32_t argNumber = def->argumentCounter;
+    try
+    {
+        def->kernel.setArg(argNumber, localMemorySize, nullptr);
+    }
+    catch(const cl::Error &err)
+    {
+        error.addMeesage("OpenCL error while setting local memory: "
+                         + std::string(err.what())
+                         + "("
+                         + std::to_string(err.err())
+                         + ")");
+        LOG_ERROR(error);
+        return false;
+    }
+
+    // reserve the position, so following arguments don't overwrite the local memory
+    def->localBufferSize += localMemorySize;
+    def->argumentCounter++;
+
+    return true;
+}
+
+/**
+ * @brief set a value as argument of a kernel, without creating a buffer for it. At the first call
+ *        for a name, the value is bound to the next free argument-position of the kernel, like
+ *        the buffer in bindKernelToBuffer, so all arguments must be bound in the order of the
+ *        kernel-parameters. Further calls with the same name only update the value. The value is
+ *        copied into the kernel by this call, so the memory of the caller can be reused directly
+ *        afterwards and all following runs use the new value, without any transfer to the
+ *        device.
+ *
+ * @param data object with all data
+ * @param kernelName name of the kernel
+ * @param argName name of the argument
+ * @param value pointer to the value
+ * @param valueSize number of bytes of the value
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuInterface::setKernelArgument(GpuData &data,
+                                const std::string &kernelName,
+                                const std::string &argName,
+                                const void* value,
+                                const uint64_t valueSize,
+                                ErrorContainer &error)
+{
+    // get kernel
+    GpuData::KernelDef* def = data.getKernel(kernelName);
+    if(def == nullptr)
+    {
+        error.addMeesage("no kernel with name '" + kernelName + "' found");
+        return false;
+    }
+
+    return setKernelArgument(*def, argName, value, valueSize, error);
+}
+
+/**
+ * @brief set a value as argument of a kernel by the handle of the kernel, which avoids the
+ *        lookup of the kernel-name for arguments, which are updated before each run
+ *
+ * @param data object with all data
+ * @param handle handle of the kernel
+ * @param argName name of the argument
+ * @param value pointer to the value
+ * @param valueSize number of bytes of the value
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuInterface::setKernelArgument(GpuData &data,
+                                const KernelHandle &handle,
+                                const std::string &argName,
+                                const void* value,
+                                const uint64_t valueSize,
+                                ErrorContainer &error)
+{
+    // get kernel
+    GpuData::KernelDef* def = data.getKernel(handle);
+    if(def == nullptr)
+    {
+        error.addMeesage("invalid kernel-handle");
+        return false;
+    }
+
+    return setKernelArgument(*def, argName, value, valueSize, error);
+}
+
+/**
+ * @brief set a value as argument of an already resolved kernel
+ *
+ * @param def kernel, which should get the argument
+ * @param argName name of the argument
+ * @param value pointer to the value
+ * @param valueSize number of bytes of the value
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuInterface::setKernelArgument(GpuData::KernelDef &def,
+                                const std::string &argName,
+                                const void* value,
+                                const uint64_t valueSize,
+                                ErrorContainer &error)
+{
+    // precheck
+    if(value == nullptr
+            || valueSize == 0)
+    {
+        error.addMeesage("invalid value for argument '" + argName + "'");
+        return false;
+    }
+
+    // get position of the argument or register a new one
+    uint32_t argNumber = def.argumentCounter;
+    std::map<std::string, uint32_t>::const_iterator it;
+    it = def.arguments.find(argName);
+    if(it != def.arguments.end())
+    {
+        std::map<std::string, uint64_t>::const_iterator sizeIt;
+        sizeIt = def.valueSizes.find(argName);
+        if(sizeIt == def.valueSizes.end())
+        {
+            error.addMeesage("argument '" + argName + "' is already bound to a buffer");
+            return false;
+        }
+
+        if(sizeIt->second != valueSize)
+        {
+            error.addMeesage("size of argument '"
+                             + argName
+                             + "' doesn't match with the size of the already set value");
+            return false;
+        }
+
+        argNumber = it->second;
+    }
+
+    try
+    {
+        def.kernel.setArg(argNumber, static_cast<size_t>(valueSize), value);
+    }
+    catch(const cl::Error &err)
+    {
+        error.addMeesage("OpenCL error while setting argument '"
+                         + argName
+                         + "': "
+                         + std::string(err.what())
+                         + "("
+                         + std::to_string(err.err())
+                         + ")");
+        return false;
+    }
+
+    if(it == def.arguments.end())
+    {
+        def.arguments.insert(std::make_pair(argName, argNumber));
+        def.valueSizes.insert(std::make_pair(argName, valueSize));
+        def.argumentCounter++;
+    }
+
+    return true;
+}
+
+/**
+ * @brief update data inside the buffer on the device
+ *
+ * @param data object with all data
+ * @param bufferName name of the buffer in the kernel
+ * @param error reference for error-output
+ * @param numberOfObjects number of objects to copy
+ * @param offset offset in buffer on device
+ *
+ * @return false, if copy failed of buffer is output-buffer, else true
+ */
+bool
+GpuInterface::updateBufferOnDevice(GpuData &data,
+                                   const std::string &bufferName,
+                                   ErrorContainer &error,
+                                   uint64_t numberOfObjects,
+                                   const uint64_t offset)
+{
+    GpuEvent event;
+    return updateBufferOnDeviceAsync(data, bufferName, event, error, numberOfObjects, offset);
+}
+
+/**
+ * @brief handle-variant of updateBufferOnDevice without lookup of the buffer-name
+ *
+ * @param data object with all data
+ * @param handle handle of the buffer
+ * @param error reference for error-output
+ * @param numberOfObjects number of objects to copy
+ * @param offset offset in buffer on device
+ *
+ * @return false, if copy failed or handle is invalid, else true
+ */
+bool
+GpuInterface::updateBufferOnDevice(GpuData &data,
+                                   const BufferHandle &handle,
+                                   ErrorContainer &error,
+                                   uint64_t numberOfObjects,
+                                   const uint64_t offset)
+{
+    GpuEvent event;
+    return updateBufferOnDeviceAsync(data, handle, event, error, numberOfObjects, offset);
+}
+
+/**
+ * @brief update multiple buffer on the device. Adjacent buffer of the same arena are combined
+ *        into a single transfer.
+ *
+ * @param data object with all data
+ * @param bufferNames names of the buffer to update. The name of an arena updates all of its buffer.
+ * @param error reference for error-output
+ *
+ * @return false, if copy failed or buffer-name not found, else true
+ */
+bool
+GpuInterface::updateBuffersOnDevice(GpuData &data,
+                                    const std::vector<std::string> &bufferNames,
+                                    ErrorContainer &error)
+{
+    GpuEvent event;
+    return updateBuffersOnDeviceAsync(data, bufferNames, event, error);
+}
+
+/**
+ * @brief run kernel with input
+ *
+ * @param data input-data for the run
+ * @param kernelName, name of the kernel, which should be executed
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuInterface::run(GpuData &data,
+                  const std::string &kernelName,
+                  ErrorContainer &error)
+{
+    GpuEvent event;
+    return runAsync(data, kernelName, event, error);
+}
+
+/**
+ * @brief handle-variant of run without lookup of the kernel-name
+ *
+ * @param data input-data for the run
+ * @param handle handle of the kernel, which should be executed
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuInterface::run(GpuData &data,
+                  const KernelHandle &handle,
+                  ErrorContainer &error)
+{
+    GpuEvent event;
+    return runAsync(data, handle, event, error);
+}
+
+/**
+ * @brief run kernel for a problem-size, where the worker-dimensions are calculated automatically
+ *
+ * @param data input-data for the run
+ * @param kernelName, name of the kernel, which should be executed
+ * @param problemSize number of work-items, which have to be processed in each dimension
+ * @param error reference for error-output
+ * @param offset offset of the first work-item in each dimension
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuInterface::launch(GpuData &data,
+                     const std::string &kernelName,
+                     const WorkerDim &problemSize,
+                     ErrorContainer &error,
+                     const WorkerDim &offset)
+{
+    GpuEvent event;
+    return launchAsync(data, kernelName, problemSize, event, error, offset);
+}
+
+/**
+ * @brief copy data of a buffer from device to host
+ *
+ * @param data object with all data
+ * @param bufferName name of the buffer to copy into
+ * @param error reference for error-output
+ * @param numberOfObjects number of objects to copy (0 = whole buffer)
+ * @param offset offset in buffer on device
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuInterface::copyFromDevice(GpuData &data,
+                             const std::string &bufferName,
+                             ErrorContainer &error,
+                             uint64_t numberOfObjects,
+                             const uint64_t offset)
+{
+    GpuEvent event;
+    if(copyFromDeviceAsync(data, bufferName, event, error, numberOfObjects, offset) == false) {
+        return false;
+    }
+
+    return event.wait();
+}
+
+/**
+ * @brief handle-variant of copyFromDevice without lookup of the buffer-name
+ *
+ * @param data object with all data
+ * @param handle handle of the buffer to copy into
+ * @param error reference for error-output
+ * @param numberOfObjects number of objects to copy (0 = whole buffer)
+ * @param offset offset in buffer on device
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuInterface::copyFromDevice(GpuData &data,
+                             const BufferHandle &handle,
+                             ErrorContainer &error,
+                             uint64_t numberOfObjects,
+                             const uint64_t offset)
+{
+    GpuEvent event;
+    if(copyFromDeviceAsync(data, handle, event, error, numberOfObjects, offset) == false) {
+        return false;
+    }
+
+    return event.wait();
+}
+
+/**
+ * @brief update a rectangular region of a buffer on the device, for example a tile of a matrix
+ *
+ * @param data object with all data
+ * @param bufferName name of the buffer
+ * @param region region to update
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuInterface::updateRegionOnDevice(GpuData &data,
+                                   const std::string &bufferName,
+                                   const BufferRegion &region,
+                                   ErrorContainer &error)
+{
+    GpuEvent event;
+    return updateRegionOnDeviceAsync(data, bufferName, region, event, error);
+}
+
+/**
+ * @brief handle-variant of updateRegionOnDevice without lookup of the buffer-name
+ *
+ * @param data object with all data
+ * @param handle handle of the buffer
+ * @param region region to update
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuInterface::updateRegionOnDevice(GpuData &data,
+                                   const BufferHandle &handle,
+                                   const BufferRegion &region,
+                                   ErrorContainer &error)
+{
+    GpuEvent event;
+    return updateRegionOnDeviceAsync(data, handle, region, event, error);
+}
+
+/**
+ * @brief copy a rectangular region of a buffer from the device to the host
+ *
+ * @param data object with all data
+ * @param bufferName name of the buffer
+ * @param region region to copy
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuInterface::copyRegionFromDevice(GpuData &data,
+                                   const std::string &bufferName,
+                                   const BufferRegion &region,
+                                   ErrorContainer &error)
+{
+    GpuEvent event;
+    if(copyRegionFromDeviceAsync(data, bufferName, region, event, error) == false) {
+        return false;
+    }
+
+    return event.wait();
+}
+
+/**
+ * @brief handle-variant of copyRegionFromDevice without lookup of the buffer-name
+ *
+ * @param data object with all data
+ * @param handle handle of the buffer
+ * @param region region to copy
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuInterface::copyRegionFromDevice(GpuData &data,
+                                   const BufferHandle &handle,
+                                   const BufferRegion &region,
+                                   ErrorContainer &error)
+{
+    GpuEvent event;
+    if(copyRegionFromDeviceAsync(data, handle, region, event, error) == false) {
+        return false;
+    }
+
+    return event.wait();
+}
+
+/**
+ * @brief map a buffer into the host-address-space. For buffer with host-pointer on devices, which
+ *        are using the host-memory directly, like integrated GPUs or CPUs, this doesn't copy any
+ *        data. The buffer must not be used by any kernel until it is unmapped again.
+ *
+ * @param data object with all data
+ * @param bufferName name of the buffer to map
+ * @param mode MAP_READ to read the data of the device, MAP_WRITE to update the data and
+ *             MAP_WRITE_INVALIDATE to overwrite the data without reading the old content
+ * @param error reference for error-output
+ *
+ * @return pointer to the mapped memory, or nullptr if failed
+ */
+void*
+GpuInterface::mapBuffer(GpuData &data,
+                        const std::string &bufferName,
+                        const MapMode mode,
+                        ErrorContainer &error)
+{
+    GpuData::WorkerBuffer* buffer = data.getBuffer(bufferName);
+    if(buffer == nullptr)
+    {
+        error.addMeesage("no buffer with name '" + bufferName + "' found");
+        return nullptr;
+    }
+
+    void* mappedData = enqueueMap(*buffer, mode, error);
+    if(mappedData == nullptr) {
+        error.addMeesage("failed to map buffer with name '" + bufferName + "'");
+    }
+
+    return mappedData;
+}
+
+/**
+ * @brief handle-variant of mapBuffer without lookup of the buffer-name
+ *
+ * @param data object with all data
+ * @param handle handle of the buffer to map
+ * @param mode mode of the mapping
+ * @param error reference for error-output
+ *
+ * @return pointer to the mapped memory, or nullptr if failed
+ */
+void*
+GpuInterface::mapBuffer(GpuData &data,
+                        const BufferHandle &handle,
+                        const MapMode mode,
+                        ErrorContainer &error)
+{
+    GpuData::WorkerBuffer* buffer = data.getBuffer(handle);
+    if(buffer == nullptr)
+    {
+        error.addMeesage("invalid buffer-handle");
+        return nullptr;
+    }
+
+    return enqueueMap(*buffer, mode, error);
+}
+
+/**
+ * @brief unmap a mapped buffer, which makes the changes of the host visible for the device
+ *
+ * @param data object with all data
+ * @param bufferName name of the buffer to unmap
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuInterface::unmapBuffer(GpuData &data,
+                          const std::string &bufferName,
+                          ErrorContainer &error)
+{
+    GpuData::WorkerBuffer* buffer = data.getBuffer(bufferName);
+    if(buffer == nullptr)
+    {
+        error.addMeesage("no buffer with name '" + bufferName + "' found");
+        return false;
+    }
+
+    if(enqueueUnmap(*buffer, error) == false)
+    {
+        error.addMeesage("failed to unmap buffer with name '" + bufferName + "'");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief handle-variant of unmapBuffer without lookup of the buffer-name
+ *
+ * @param data object with all data
+ * @param handle handle of the buffer to unmap
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuInterface::unmapBuffer(GpuData &data,
+                          const BufferHandle &handle,
+                          ErrorContainer &error)
+{
+    GpuData::WorkerBuffer* buffer = data.getBuffer(handle);
+    if(buffer == nullptr)
+    {
+        error.addMeesage("invalid buffer-handle");
+        return false;
+    }
+
+    return enqueueUnmap(*buffer, error);
+}
+
+/**
+ * @brief update data inside the buffer on the device without waiting for the transfer. The
+ *        host-memory of the buffer must not be changed, until the event is finished.
+ *
+ * @param data object with all data
+ * @param bufferName name of the buffer in the kernel
+ * @param event reference for the event to wait for the end of the transfer
+ * @param error reference for error-output
+ * @param numberOfObjects number of objects to copy
+ * @param offset offset in buffer on device
+ *
+ * @return false, if enqueue of the transfer failed, else true
+ */
+bool
+GpuInterface::updateBufferOnDeviceAsync(GpuData &data,
+                                        const std::string &bufferName,
+                                        GpuEvent &event,
+                                        ErrorContainer &error,
+                                        uint64_t numberOfObjects,
+                                        const uint64_t offset)
+{
+    GpuData::WorkerBuffer* buffer = data.getBuffer(bufferName);
+    if(buffer == nullptr)
+    {
+        error.addMeesage("no buffer with name '" + bufferName + "' found");
+        return false;
+    }
+
+    if(enqueueUpdate(*buffer, event, error, numberOfObjects, offset) == false)
+    {
+        error.addMeesage("Update buffer with name '" + bufferName + "' on gpu failed");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief handle-variant of updateBufferOnDeviceAsync without lookup of the buffer-name
+ *
+ * @param data object with all data
+ * @param handle handle of the buffer
+ * @param event reference for the event to wait for the end of the transfer
+ * @param error reference for error-output
+ * @param numberOfObjects number of objects to copy
+ * @param offset offset in buffer on device
+ *
+ * @return false, if enqueue of the transfer failed, else true
+ */
+bool
+GpuInterface::updateBufferOnDeviceAsync(GpuData &data,
+                                        const BufferHandle &handle,
+                                        GpuEvent &event,
+                                        ErrorContainer &error,
+                                        uint64_t numberOfObjects,
+                                        const uint64_t offset)
+{
+    GpuData::WorkerBuffer* buffer = data.getBuffer(handle);
+    if(buffer == nullptr)
+    {
+        error.addMeesage("invalid buffer-handle");
+        return false;
+    }
+
+    return enqueueUpdate(*buffer, event, error, numberOfObjects, offset);
+}
+
+/**
+ * @brief update multiple buffer on the device without waiting for the transfers. Adjacent buffer
+ *        of the same arena, which are only separated by the alignment-padding, are combined into
+ *        a single transfer.
+ *
+ * @param data object with all data
+ * @param bufferNames names of the buffer to update. The name of an arena updates all of its buffer.
+ * @param event reference for the event to wait for the end of the last transfer
+ * @param error reference for error-output
+ *
+ * @return false, if enqueue of a transfer failed or buffer-name not found, else true
+ */
+bool
+GpuInterface::updateBuffersOnDeviceAsync(GpuData &data,
+                                         const std::vector<std::string> &bufferNames,
+                                         GpuEvent &event,
+                                         ErrorContainer &error)
+{
+    // group buffer of arenas by their arena and update all other buffer directly
+    std::map<GpuData::WorkerBuffer*, std::vector<GpuData::WorkerBuffer*>> arenaParts;
+    for(const std::string &name : bufferNames)
+    {
+        GpuData::WorkerBuffer* buffer = data.getBuffer(name);
+        if(buffer == nullptr)
+        {
+            error.addMeesage("no buffer with name '" + name + "' found");
+            return false;
+        }
+
+        if(buffer->arena != nullptr)
+        {
+            arenaParts[buffer->arena].push_back(buffer);
+            continue;
+        }
+
+        // expand name of an arena to all of its buffer
+        bool isArena = false;
+        for(auto& [partName, part] : data.m_buffer)
+        {
+            if(part.arena == buffer)
+            {
+                arenaParts[buffer].push_back(&part);
+                isArena = true;
+            }
+        }
+
+        if(isArena == false
+                && updateBufferOnDeviceAsync(data, name, event, error) == false)
+        {
+            return false;
+        }
+    }
+
+    uint64_t alignment = m_device.getInfo<CL_DEVICE_MEM_BASE_ADDR_ALIGN>() / 8;
+    if(alignment == 0) {
+        alignment = 1;
+    }
+
+    for(auto& [arena, parts] : arenaParts)
+    {
+        std::sort(parts.begin(),
+                  parts.end(),
+                  [](const GpuData::WorkerBuffer* a, const GpuData::WorkerBuffer* b) {
+                      return a->arenaOffset < b->arenaOffset;
+                  });
+        parts.erase(std::unique(parts.begin(), parts.end()), parts.end());
+
+        // split into ranges of adjacent buffer and transfer each range at once
+        std::vector<GpuData::WorkerBuffer*> range;
+        uint64_t rangeEnd = 0;
+        for(GpuData::WorkerBuffer* part : parts)
+        {
+            if(range.size() > 0
+                    && part->arenaOffset - rangeEnd >= alignment)
+            {
+                if(enqueueArenaWrite(*arena, range, &event.m_event, error) == false) {
+                    return false;
+                }
+                range.clear();
+            }
+
+            range.push_back(part);
+            rangeEnd = part->arenaOffset + part->numberOfBytes;
+        }
+
+        if(enqueueArenaWrite(*arena, range, &event.m_event, error) == false) {
+            return false;
+        }
+        event.m_isActive = true;
+    }
+
+    return true;
+}
+
+/**
+ * @brief run kernel with input without waiting until the kernel is finished
+ *
+ * @param data input-data for the run
+ * @param kernelName, name of the kernel, which should be executed
+ * @param event reference for the event to wait for the end of the kernel
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuInterface::runAsync(GpuData &data,
+                       const std::string &kernelName,
+                       GpuEvent &event,
+                       ErrorContainer &error)
+{
+    // get kernel-data
+    GpuData::KernelDef* def = data.getKernel(kernelName);
+    if(def == nullptr)
+    {
+        error.addMeesage("no kernel with name '" + kernelName + "' found");
+        return false;
+    }
+
+    if(enqueueKernel(data, *def, nullptr, &event.m_event, error) == false) {
+        return false;
+    }
+    event.m_isActive = true;
+
+    return true;
+}
+
+/**
+ * @brief handle-variant of runAsync without lookup of the kernel-name
+ *
+ * @param data input-data for the run
+ * @param handle handle of the kernel, which should be executed
+ * @param event reference for the event to wait for the end of the kernel
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuInterface::runAsync(GpuData &data,
+                       const KernelHandle &handle,
+                       GpuEvent &event,
+                       ErrorContainer &error)
+{
+    GpuData::KernelDef* def = data.getKernel(handle);
+    if(def == nullptr)
+    {
+        error.addMeesage("invalid kernel-handle");
+        return false;
+    }
+
+    if(enqueueKernel(data, *def, nullptr, &event.m_event, error) == false) {
+        return false;
+    }
+    event.m_isActive = true;
+
+    return true;
+}
+
+/**
+ * @brief run kernel for a problem-size without waiting until the kernel is finished. The
+ *        worker-dimensions are calculated with calculateRange and stay in the data-object, so
+ *        following calls of run use the same range.
+ *
+ * @param data input-data for the run
+ * @param kernelName, name of the kernel, which should be executed
+ * @param problemSize number of work-items, which have to be processed in each dimension
+ * @param event reference for the event to wait for the end of the kernel
+ * @param error reference for error-output
+ * @param offset offset of the first work-item in each dimension
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuInterface::launchAsync(GpuData &data,
+                          const std::string &kernelName,
+                          const WorkerDim &problemSize,
+                          GpuEvent &event,
+                          ErrorContainer &error,
+                          const WorkerDim &offset)
+{
+    if(calculateRange(data, kernelName, problemSize, error, offset) == false) {
+        return false;
+    }
+
+    return runAsync(data, kernelName, event, error);
+}
+
+/**
+ * @brief copy data of a buffer from device to host without waiting for the transfer. The
+ *        host-memory of the buffer is only valid, after the event is finished.
+ *
+ * @param data object with all data
+ * @param bufferName name of the buffer to copy into
+ * @param event reference for the event to wait for the end of the transfer
+ * @param error reference for error-output
+ * @param numberOfObjects number of objects to copy (0 = whole buffer)
+ * @param offset offset in buffer on device
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuInterface::copyFromDeviceAsync(GpuData &data,
+                                  const std::string &bufferName,
+                                  GpuEvent &event,
+                                  ErrorContainer &error,
+                                  uint64_t numberOfObjects,
+                                  const uint64_t offset)
+{
+    GpuData::WorkerBuffer* buffer = data.getBuffer(bufferName);
+    if(buffer == nullptr)
+    {
+        error.addMeesage("no buffer with name '" + bufferName + "' found");
+        return false;
+    }
+
+    return enqueueCopy(*buffer, event, error, numberOfObjects, offset);
+}
+
+/**
+ * @brief handle-variant of copyFromDeviceAsync without lookup of the buffer-name
+ *
+ * @param data object with all data
+ * @param handle handle of the buffer to copy into
+ * @param event reference for the event to wait for the end of the transfer
+ * @param error reference for error-output
+ * @param numberOfObjects number of objects to copy (0 = whole buffer)
+ * @param offset offset in buffer on device
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuInterface::copyFromDeviceAsync(GpuData &data,
+                                  const BufferHandle &handle,
+                                  GpuEvent &event,
+                                  ErrorContainer &error,
+                                  uint64_t numberOfObjects,
+                                  const uint64_t offset)
+{
+    GpuData::WorkerBuffer* buffer = data.getBuffer(handle);
+    if(buffer == nullptr)
+    {
+        error.addMeesage("invalid buffer-handle");
+        return false;
+    }
+
+    return enqueueCopy(*buffer, event, error, numberOfObjects, offset);
+}
+
+/**
+ * @brief update a rectangular region of a buffer on the device without waiting for the transfer
+ *
+ * @param data object with all data
+ * @param bufferName name of the buffer
+ * @param region region to update
+ * @param event reference for the event to wait for the end of the transfer
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuInterface::updateRegionOnDeviceAsync(GpuData &data,
+                                        const std::string &bufferName,
+                                        const BufferRegion &region,
+                                        GpuEvent &event,
+                                        ErrorContainer &error)
+{
+    GpuData::WorkerBuffer* buffer = data.getBuffer(bufferName);
+    if(buffer == nullptr)
+    {
+        error.addMeesage("no buffer with name '" + bufferName + "' found");
+        return false;
+    }
+
+    if(enqueueUpdateRegion(*buffer, region, event, error) == false)
+    {
+        error.addMeesage("Update region of buffer with name '" + bufferName + "' on gpu failed");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief handle-variant of updateRegionOnDeviceAsync without lookup of the buffer-name
+ *
+ * @param data object with all data
+ * @param handle handle of the buffer
+ * @param region region to update
+ * @param event reference for the event to wait for the end of the transfer
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuInterface::updateRegionOnDeviceAsync(GpuData &data,
+                                        const BufferHandle &handle,
+                                        const BufferRegion &region,
+                                        GpuEvent &event,
+                                        ErrorContainer &error)
+{
+    GpuData::WorkerBuffer* buffer = data.getBuffer(handle);
+    if(buffer == nullptr)
+    {
+        error.addMeesage("invalid buffer-handle");
+        return false;
+    }
+
+    return enqueueUpdateRegion(*buffer, region, event, error);
+}
+
+/**
+ * @brief copy a rectangular region of a buffer from the device to the host without waiting for
+ *        the transfer
+ *
+ * @param data object with all data
+ * @param bufferName name of the buffer
+ * @param region region to copy
+ * @param event reference for the event to wait for the end of the transfer
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuInterface::copyRegionFromDeviceAsync(GpuData &data,
+                                        const std::string &bufferName,
+                                        const BufferRegion &region,
+                                        GpuEvent &event,
+                                        ErrorContainer &error)
+{
+    GpuData::WorkerBuffer* buffer = data.getBuffer(bufferName);
+    if(buffer == nullptr)
+    {
+        error.addMeesage("no buffer with name '" + bufferName + "' found");
+        return false;
+    }
+
+    return enqueueCopyRegion(*buffer, region, event, error);
+}
+
+/**
+ * @brief handle-variant of copyRegionFromDeviceAsync without lookup of the buffer-name
+ *
+ * @param data object with all data
+ * @param handle handle of the buffer
+ * @param region region to copy
+ * @param event reference for the event to wait for the end of the transfer
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuInterface::copyRegionFromDeviceAsync(GpuData &data,
+                                        const BufferHandle &handle,
+                                        const BufferRegion &region,
+                                        GpuEvent &event,
+                                        ErrorContainer &error)
+{
+    GpuData::WorkerBuffer* buffer = data.getBuffer(handle);
+    if(buffer == nullptr)
+    {
+        error.addMeesage("invalid buffer-handle");
+        return false;
+    }
+
+    return enqueueCopyRegion(*buffer, region, event, error);
+}
+
+/**
+ * @brief copy the content of a buffer into another buffer of the same data-object on the device
+ *        without waiting for the copy. The copy is enqueued on the queue of the calling thread,
+ *        so in contrast to copyToInterface no other queue is finished.
+ *
+ * @param data object with all data
+ * @param sourceBufferName name of the buffer to copy from
+ * @param targetBufferName name of the buffer to copy into
+ * @param event reference for the event to wait for the end of the copy
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuInterface::copyBufferOnDeviceAsync(GpuData &data,
+                                      const std::string &sourceBufferName,
+                                      const std::string &targetBufferName,
+                                      GpuEvent &event,
+                                      ErrorContainer &error)
+{
+    GpuData::WorkerBuffer* source = data.getBuffer(sourceBufferName);
+    if(source == nullptr)
+    {
+        error.addMeesage("no buffer with name '" + sourceBufferName + "' found");
+        return false;
+    }
+
+    GpuData::WorkerBuffer* destination = data.getBuffer(targetBufferName);
+    if(destination == nullptr)
+    {
+        error.addMeesage("no buffer with name '" + targetBufferName + "' found");
+        return false;
+    }
+
+    const uint64_t numberOfBytes = source->numberOfObjects * source->objectSize;
+    if(numberOfBytes > destination->numberOfObjects * destination->objectSize)
+    {
+        error.addMeesage("buffer '"
+                         + targetBufferName
+                         + "' is too small for the content of buffer '"
+                         + sourceBufferName
+                         + "'");
+        return false;
+    }
+
+    if(source->clBuffer() == nullptr
+            || destination->clBuffer() == nullptr)
+    {
+        error.addMeesage("buffer for copy on the device are not initialized on the device");
+        return false;
+    }
+
+    try
+    {
+        if(m_useSeparateQueues)
+        {
+            // wait for the last operations on both buffer, like for a kernel
+            GpuData::WorkerBuffer* buffers[2] = {source, destination};
+            const std::vector<cl::Event>* waitList = prepareWaitList(nullptr, buffers, 2);
+
+            cl::CommandQueue &queue = m_computeQueues[m_nextComputeQueue];
+            m_nextComputeQueue = (m_nextComputeQueue + 1) % m_computeQueues.size();
+            queue.enqueueCopyBuffer(source->clBuffer,
+                                    destination->clBuffer,
+                                    0,
+                                    0,
+                                    numberOfBytes,
+                                    waitList,
+                                    &event.m_event);
+            queue.flush();
+
+            source->lastEvent = event.m_event;
+            source->hasLastEvent = true;
+            destination->lastEvent = event.m_event;
+            destination->hasLastEvent = true;
+        }
+        else
+        {
+            getQueue().enqueueCopyBuffer(source->clBuffer,
+                                         destination->clBuffer,
+                                         0,
+                                         0,
+                                         numberOfBytes,
+                                         nullptr,
+                                         &event.m_event);
+        }
+        recordOperation("copyBufferOnDevice",
+                        PROFILE_WRITE,
+                        targetBufferName,
+                        numberOfBytes,
+                        &event.m_event);
+    }
+    catch(const cl::Error &err)
+    {
+        error.addMeesage("OpenCL error while copy buffer on device: "
+                         + std::string(err.what())
+                         + "("
+                         + std::to_string(err.err())
+                         + ")");
+        return false;
+    }
+    event.m_isActive = true;
+
+    return true;
+}
+
+/**
+ * @brief copy the content of a buffer on the device of this interface into a buffer on the
+ *        device of another interface. If both interfaces share the same context, the data are
+ *        copied directly between the devices, else they are moved through the host-memory of
+ *        the target-buffer, which is overwritten by this.
+ *
+ * @param data data-object with the source-buffer
+ * @param bufferName name of the source-buffer
+ * @param target interface of the target-device
+ * @param targetData data-object with the target-buffer, which is initialized on the target
+ * @param targetBufferName name of the target-buffer
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuInterface::copyToInterface(GpuData &data,
+                              const std::string &bufferName,
+                              GpuInterface &target,
+                              GpuData &targetData,
+                              const std::string &targetBufferName,
+                              ErrorContainer &error)
+{
+    if(initContext(error) == false
+            || target.initContext(error) == false)
+    {
+        return false;
+    }
+
+    GpuData::WorkerBuffer* source = data.getBuffer(bufferName);
+    if(source == nullptr)
+    {
+        error.addMeesage("no buffer with name '" + bufferName + "' found");
+        return false;
+    }
+
+    GpuData::WorkerBuffer* destination = targetData.getBuffer(targetBufferName);
+    if(destination == nullptr)
+    {
+        error.addMeesage("no buffer with name '" + targetBufferName + "' found");
+        return false;
+    }
+
+    const uint64_t numberOfBytes = source->numberOfObjects * source->objectSize;
+    if(numberOfBytes > destination->numberOfObjects * destination->objectSize)
+    {
+        error.addMeesage("buffer '"
+                         + targetBufferName
+                         + "' is too small for the content of buffer '"
+                         + bufferName
+                         + "'");
+        return false;
+    }
+
+    if(source->clBuffer() == nullptr
+            || destination->clBuffer() == nullptr)
+    {
+        error.addMeesage("buffer for device-to-device copy are not initialized on the devices");
+        return false;
+    }
+
+    if(source->mappedData != nullptr
+            || destination->mappedData != nullptr)
+    {
+        error.addMeesage("buffer for device-to-device copy must not be mapped");
+        return false;
+    }
+
+    // all operations, which are using one of the buffers, must be finished
+    if(finishQueues() == false
+            || target.finishQueues() == false)
+    {
+        error.addMeesage("failed to wait for the queues before device-to-device copy");
+        return false;
+    }
+
+    try
+    {
+        if(sharesContext(target))
+        {
+            // both buffer are in the same context, so the driver can copy the data without
+            // the host
+            cl::Event event;
+            target.getQueue().enqueueCopyBuffer(source->clBuffer,
+                                                destination->clBuffer,
+                                                0,
+                                                0,
+                                                numberOfBytes,
+                                                nullptr,
+                                                &event);
+            target.recordOperation("copyToInterface",
+                                   PROFILE_WRITE,
+                                   targetBufferName,
+                                   numberOfBytes,
+                                   &event);
+            event.wait();
+        }
+        else
+        {
+            getQueue().enqueueReadBuffer(source->clBuffer,
+                                         CL_TRUE,
+                                         0,
+                                         numberOfBytes,
+                                         destination->data);
+            target.getQueue().enqueueWriteBuffer(destination->clBuffer,
+                                                 CL_TRUE,
+                                                 0,
+                                                 numberOfBytes,
+                                                 destination->data);
+        }
+    }
+    catch(const cl::Error &err)
+    {
+        error.addMeesage("OpenCL error: "
+                         + std::string(err.what())
+                         + "("
+                         + std::to_string(err.err())
+                         + ")");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief GpuInterface::getDeviceName
+ * @return
+ */
+const std::string
+GpuInterface::getDeviceName()
+{
+    return m_device.getInfo<CL_DEVICE_NAME>();
+}
+
+/**
+ * @brief check if another interface uses the same context, so buffer can be copied directly
+ *        between the devices of both interfaces
+ *
+ * @param other other interface
+ *
+ * @return true, if both share the same context, else false
+ */
+bool
+GpuInterface::sharesContext(const GpuInterface &other) const
+{
+    if(this == &other) {
+        return true;
+    }
+
+    // interfaces without shared context get their own context not before the first use
+    return m_context() != nullptr
+           && m_context() == other.m_context();
+}
+
+/**
+ * @brief get pool of the interface, which keeps the memory of closed data-objects. It can be
+ *        given to the constructor of a new data-object to reuse the host-memory.
+ *
+ * @return pointer to the buffer-pool
+ */
+BufferPool*
+GpuInterface::getBufferPool()
+{
+    return &m_bufferPool;
+}
+
+/**
+ * @brief close device and remove all buffer from the data-object. The memory of the buffer on the
+ *        device and the host-memory, which was taken from a pool, is given back to the pool, so
+ *        it can be reused by the next data-object with the same buffer-sizes. Host-memory of
+ *        data-objects without pool is freed. With per-thread queues only the queue of the
+ *        calling thread is finished, so operations of other threads on the data-object must be
+ *        finished before.
+ *
+ * @param data object with all data related to the device, which will be cleared
+
+ * @return true, if successful, else false
+ */
+bool
+GpuInterface::closeDevice(GpuData &data)
+{
+    LOG_DEBUG("close OpenCL device");
+
+    // unmap all still mapped buffer, before they are deleted
+    for(auto& [name, workerBuffer] : data.m_buffer)
+    {
+        if(workerBuffer.mappedData != nullptr)
+        {
+            ErrorContainer unmapError;
+            enqueueUnmap(workerBuffer, unmapError);
+        }
+    }
+
+    // end queue
+    if(finishOwnQueue() == false) {
+        return false;
+    }
+
+    // keep allocated memory on the host and the device in the pool for the next data-object
+    for(auto& [name, workerBuffer] : data.m_buffer)
+    {
+        if(workerBuffer.usePinnedMemory)
+        {
+            m_bufferPool.releasePinnedMemory(workerBuffer.pinnedBuffer,
+                                             m_queue,
+                                             workerBuffer.data,
+                                             workerBuffer.numberOfBytes);
+        }
+        else if(workerBuffer.data != nullptr
+                && workerBuffer.allowBufferDeleteAfterClose)
+        {
+            // only memory, which came from a pool, can be taken again from the pool
+            if(workerBuffer.hostMemoryPool != nullptr) {
+                workerBuffer.hostMemoryPool->releaseHostMemory(workerBuffer.data,
+                                                               workerBuffer.numberOfBytes);
+            } else {
+                Kitsunemimi::alignedFree(workerBuffer.data, workerBuffer.numberOfBytes);
+            }
+        }
+
+        // sub-buffer of arenas are only views into the arena and can not be reused
+        if(workerBuffer.useHostPtr == false
+                && workerBuffer.arena == nullptr
+                && workerBuffer.clBuffer() != nullptr)
+        {
+            m_bufferPool.releaseDeviceBuffer(workerBuffer.clBuffer, workerBuffer.numberOfBytes);
+        }
+    }
+
+    // clear data and invalidate the handles of the buffer
+    data.clearBuffer();
+
+    // remove bindings of the kernels, because the bound buffers doesn't exist anymore
+    std::unique_lock<std::shared_mutex> guard(data.m_lock.mutex);
+    for(auto& [name, kernelDef] : data.m_kernel)
+    {
+        kernelDef.arguments.clear();
+        kernelDef.valueSizes.clear();
+        kernelDef.boundBuffers.clear();
+        kernelDef.localBufferSize = 0;
+        kernelDef.argumentCounter = 0;
+    }
+
+    return true;
+}
+
+/**
+ * @brief use dedicated queues for the transfers to the device and back to the host and one or
+ *        more queues for the kernels instead of the single default queue, so uploads, downloads
+ *        and running kernels can overlap on devices with independent copy-engines. The order of
+ *        operations on the same buffer is kept by events. Must be called before any operation
+ *        was enqueued.
+ *
+ * @param numberOfComputeQueues number of queues for kernels, which are used in round-robin
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuInterface::enableSeparateQueues(const uint32_t numberOfComputeQueues,
+                                   ErrorContainer &error)
+{
+    if(initContext(error) == false) {
+        return false;
+    }
+
+    if(numberOfComputeQueues == 0)
+    {
+        error.addMeesage("at least one compute-queue is required");
+        return false;
+    }
+
+    if(m_usePerThreadQueues)
+    {
+        error.addMeesage("separate queues can not be combined with per-thread queues");
+        return false;
+    }
+
+    if(finishQueues() == false)
+    {
+        error.addMeesage("failed to finish queues before switching to separate queues");
+        return false;
+    }
+
+    try
+    {
+        m_uploadQueue = cl::CommandQueue(m_context, m_device, m_queueProperties);
+        m_downloadQueue = cl::CommandQueue(m_context, m_device, m_queueProperties);
+        m_computeQueues.clear();
+        for(uint32_t i = 0; i < numberOfComputeQueues; i++) {
+            m_computeQueues.push_back(cl::CommandQueue(m_context, m_device, m_queueProperties));
+        }
+    }
+    catch(const cl::Error &err)
+    {
+        error.addMeesage("OpenCL error while creating queues: "
+                         + std::string(err.what())
+                         + "("
+                         + std::to_string(err.err())
+                         + ")");
+        LOG_ERROR(error);
+        m_computeQueues.clear();
+        return false;
+    }
+
+    m_nextComputeQueue = 0;
+    m_useSeparateQueues = true;
+
+    return true;
+}
+
+/**
+ * @brief check if separate queues for transfers and kernels are used
+ *
+ * @return true, if separate queues are enabled, else false
+ */
+bool
+GpuInterface::useSeparateQueues() const
+{
+    return m_useSeparateQueues;
+}
+
+/**
+ * @brief enable the concurrent mode, where the interface can be used by multiple host-threads at
+ *        the same time. Each thread gets its own in-order queue on the shared context, which is
+ *        created at the first operation of the thread, so the threads don't serialize on a single
+ *        queue. The operations of one thread keep their order, but there is no order between the
+ *        operations of different threads. Rules for the concurrent usage:
+ *
+ *        - configuration (enable*-functions) must be done before the threads are started
+ *        - each thread should use its own data-object for running kernels and transfers, because
+ *          worker-dimensions and kernel-arguments are stored within the data-object
+ *        - a shared data-object can be read by all threads (lookup of buffer, kernels and their
+ *          handles), but closeDevice must not be called while other threads are using it
+ *        - results of another thread must be synchronized by its events
+ *
+ *        Must be called before any operation was enqueued and can not be combined with
+ *        separate queues.
+ *
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuInterface::enablePerThreadQueues(ErrorContainer &error)
+{
+    if(initContext(error) == false) {
+        return false;
+    }
+
+    if(m_useSeparateQueues)
+    {
+        error.addMeesage("per-thread queues can not be combined with separate queues");
+        return false;
+    }
+
+    if(finishQueues() == false)
+    {
+        error.addMeesage("failed to finish queues before switching to per-thread queues");
+        return false;
+    }
+
+    m_usePerThreadQueues = true;
+
+    return true;
+}
+
+/**
+ * @brief check if each host-thread uses its own queue
+ *
+ * @return true, if per-thread queues are enabled, else false
+ */
+bool
+GpuInterface::usePerThreadQueues() const
+{
+    return m_usePerThreadQueues;
+}
+
+/**
+ * @brief get number of queues, which were created for different host-threads
+ *
+ * @return number of per-thread queues
+ */
+uint64_t
+GpuInterface::getNumberOfThreadQueues()
+{
+    std::shared_lock<std::shared_mutex> guard(m_threadQueueLock);
+    return m_threadQueues.size();
+}
+
+/**
+ * @brief finish and remove the queue of the calling thread, for example before a thread of a
+ *        thread-pool ends. If the thread uses the interface again later, a new queue is created.
+ *        All operations of the thread on the queue are finished before the queue is removed.
+ *
+ * @return false, if the queue could not be finished, else true
+ */
+bool
+GpuInterface::releaseThreadQueue()
+{
+    if(m_usePerThreadQueues == false) {
+        return true;
+    }
+
+    const std::thread::id threadId = std::this_thread::get_id();
+
+    // finish without holding the lock, so the other threads are not blocked in the meantime.
+    // Only the own thread uses its queue, so it can not be removed by another thread.
+    {
+        std::shared_lock<std::shared_mutex> guard(m_threadQueueLock);
+        if(m_threadQueues.find(threadId) == m_threadQueues.end()) {
+            return true;
+        }
+    }
+
+    if(getQueue().finish() != CL_SUCCESS) {
+        return false;
+    }
+
+    std::unique_lock<std::shared_mutex> guard(m_threadQueueLock);
+    m_threadQueues.erase(threadId);
+
+    return true;
+}
+
+/**
+ * @brief enable the measurement of the execution-time on the device for all kernels and transfers.
+ *        The queues are recreated with profiling enabled, so this must be called before any
+ *        operation was enqueued.
+ *
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuInterface::enableProfiling(ErrorContainer &error)
+{
+    if(m_profiler != nullptr) {
+        return true;
+    }
+
+    if(enableQueueProfiling(error) == false) {
+        return false;
+    }
+
+    m_profiler = new GpuProfiler();
+
+    return true;
+}
+
+/**
+ * @brief get statistics of the execution-times on the device of a kernel or of the transfers of
+ *        a buffer. Waits until all enqueued operations are finished.
+ *
+ * @param type PROFILE_KERNEL for kernels, PROFILE_WRITE or PROFILE_READ for transfers to or
+ *             from the device
+ * @param name name of the kernel or buffer
+ * @param stats reference for the resulting statistics
+ * @param error reference for error-output
+ *
+ * @return false, if profiling is disabled or there are no measurements for the name, else true
+ */
+bool
+GpuInterface::getProfilingStats(const ProfilingType type,
+                                const std::string &name,
+                                ProfilingStats &stats,
+                                ErrorContainer &error)
+{
+    if(m_profiler == nullptr)
+    {
+        error.addMeesage("profiling is not enabled");
+        return false;
+    }
+
+    if(finishQueues() == false)
+    {
+        error.addMeesage("failed to finish queues before reading profiling-information");
+        return false;
+    }
+
+    std::lock_guard<std::mutex> guard(m_recordLock);
+    m_profiler->update();
+
+    if(m_profiler->getStats(type, name, stats) == false)
+    {
+        error.addMeesage("no profiling-information for name '" + name + "' found");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief remove all measurements of the profiler
+ */
+void
+GpuInterface::resetProfiling()
+{
+    std::lock_guard<std::mutex> guard(m_recordLock);
+    if(m_profiler != nullptr) {
+        m_profiler->reset();
+    }
+}
+
+/**
+ * @brief record all kernels and transfers with their times on the host and the device for a
+ *        trace. Like the profiling, this recreates the queues and must be called before any
+ *        operation was enqueued.
+ *
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuInterface::enableTracing(ErrorContainer &error)
+{
+    if(m_tracer != nullptr) {
+        return true;
+    }
+
+    if(enableQueueProfiling(error) == false) {
+        return false;
+    }
+
+    m_tracer = new GpuTracer();
+
+    return true;
+}
+
+/**
+ * @brief write all recorded operations as trace-event-json, which can be loaded by
+ *        chrome://tracing or Perfetto, and remove them from the recorder. Waits until all
+ *        enqueued operations are finished.
+ *
+ * @param filePath path of the file to write
+ * @param error reference for error-output
+ *
+ * @return false, if tracing is disabled or writing failed, else true
+ */
+bool
+GpuInterface::writeTrace(const std::string &filePath,
+                         ErrorContainer &error)
+{
+    if(m_tracer == nullptr)
+    {
+        error.addMeesage("tracing is not enabled");
+        return false;
+    }
+
+    if(finishQueues() == false)
+    {
+        error.addMeesage("failed to finish queues before writing trace");
+        return false;
+    }
+
+    std::lock_guard<std::mutex> guard(m_recordLock);
+    m_tracer->update();
+
+    if(m_tracer->writeTrace(filePath, error) == false) {
+        return false;
+    }
+    m_tracer->clear();
+
+    return true;
+}
+
+/**
+ * @brief enable persistent cache for compiled program-binaries. Programs, which were already
+ *        compiled for the same device and driver, are then loaded from this cache instead of
+ *        compiling them again from source.
+ *
+ * @param cacheDirectory directory for the cache-files, which is created if not exist
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuInterface::enableProgramCache(const std::string &cacheDirectory,
+                                 ErrorContainer &error)
+{
+    std::error_code ec;
+    std::filesystem::create_directories(cacheDirectory, ec);
+    if(ec)
+    {
+        error.addMeesage("failed to create directory '"
+                         + cacheDirectory
+                         + "' for the program-cache: "
+                         + ec.message());
+        LOG_ERROR(error);
+        return false;
+    }
+
+    // running builds are using the old program-cache
+    {
+        std::lock_guard<std::mutex> guard(m_pendingBuildLock);
+        for(PendingBuild &build : m_pendingBuilds) {
+            build.result.wait();
+        }
+    }
+
+    if(m_programCache != nullptr) {
+        delete m_programCache;
+    }
+    m_programCache = new ProgramCache(cacheDirectory);
+
+    return true;
+}
+
+/**
+ * @brief get number of programs, which were loaded from the program-cache
+ *
+ * @return number of cache-hits, or 0 if the cache is not enabled
+ */
+uint64_t
+GpuInterface::getNumberOfProgramCacheHits()
+{
+    if(m_programCache == nullptr) {
+        return 0;
+    }
+
+    return m_programCache->getNumberOfHits();
+}
+
+/**
+ * @brief get number of programs, which had to be compiled, because they were not in the cache
+ *
+ * @return number of cache-misses, or 0 if the cache is not enabled
+ */
+uint64_t
+GpuInterface::getNumberOfProgramCacheMisses()
+{
+    if(m_programCache == nullptr) {
+        return 0;
+    }
+
+    return m_programCache->getNumberOfMisses();
+}
+
+/**
+ * @brief get number of different programs, which were build by this interface. Each combination
+ *        of source-code and build-options is one variant.
+ *
+ * @return number of program-variants
+ */
+uint64_t
+GpuInterface::getNumberOfProgramVariants()
+{
+    std::lock_guard<std::mutex> guard(m_programVariantLock);
+    return m_programVariants.size();
+}
+
+/**
+ * @brief enable persistent storage of the results of the work-group tuning. Kernels, which were
+ *        already tuned for the same device, driver and sizes, then get their work-group size from
+ *        the stored results without running the benchmark again.
+ *
+ * @param resultDirectory directory for the result-files, which is created if not exist
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuInterface::enableWorkGroupTuning(const std::string &resultDirectory,
+                                    ErrorContainer &error)
+{
+    std::error_code ec;
+    std::filesystem::create_directories(resultDirectory, ec);
+    if(ec)
+    {
+        error.addMeesage("failed to create directory '"
+                         + resultDirectory
+                         + "' for the work-group tuning: "
+                         + ec.message());
+        LOG_ERROR(error);
+        return false;
+    }
+
+    if(m_workGroupTuner != nullptr) {
+        delete m_workGroupTuner;
+    }
+    m_workGroupTuner = new WorkGroupTuner(resultDirectory);
+
+    return true;
+}
+
+/**
+ * @brief search the fastest number of threads per work-group in x-direction for a kernel and
+ *        set it within the data-object. The total number of threads in x-direction is kept, so
+ *        numberOfWg.x is adjusted accordingly. Candidates are multiples of the preferred
+ *        work-group size multiple of the kernel, which are allowed by the kernel and the device
+ *        and which divide the total number of threads. Each candidate is benchmarked by running
+ *        the kernel on the currently bound buffers, so the content of the buffer on the device
+ *        can be changed by this function. If enableWorkGroupTuning was called before, the result
+ *        is stored and later calls of this function and of calculateRange and launch for the same
+ *        kernel, device and sizes apply the stored result automatically.
+ *
+ * @param data data-object with the kernel, which must already be initialized on the device
+ * @param kernelName name of the kernel, which should be tuned
+ * @param error reference for error-output
+ * @param numberOfRuns number of measured runs per candidate
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuInterface::tuneWorkGroupSize(GpuData &data,
+                                const std::string &kernelName,
+                                ErrorContainer &error,
+                                const uint32_t numberOfRuns)
+{
+    GpuData::KernelDef* def = data.getKernel(kernelName);
+    if(def == nullptr)
+    {
+        error.addMeesage("no kernel with name '" + kernelName + "' found");
+        return false;
+    }
+
+    const uint64_t totalX = data.numberOfWg.x * data.threadsPerWg.x;
+    const uint64_t otherThreads = data.threadsPerWg.y * data.threadsPerWg.z;
+
+    // check for an already stored result
+    std::string key = "";
+    if(applyTunedWorkGroupSize(data, *def, key)) {
+        return true;
+    }
+
+    // the kernel is measured on its own queue with profiling, so the time on the device is
+    // measured without the overhead of the host
+    cl::CommandQueue tuningQueue;
+    try
+    {
+        tuningQueue = cl::CommandQueue(m_context, m_device, CL_QUEUE_PROFILING_ENABLE);
+    }
+    catch(const cl::Error &err)
+    {
+        error.addMeesage("OpenCL error while creating queue for the work-group tuning: "
+                         + std::string(err.what())
+                         + "("
+                         + std::to_string(err.err())
+                         + ")");
+        return false;
+    }
+
+    // all operations on the bound buffer must be finished before the tuning-queue uses them
+    if(finishQueues() == false)
+    {
+        error.addMeesage("failed to wait for the queues before the work-group tuning");
+        return false;
+    }
+
+    // get limits of the kernel and the device
+    uint64_t preferredMultiple = 1;
+    uint64_t maxSize = getMaxWorkGroupSize();
+    try
+    {
+        preferredMultiple = def->kernel.getWorkGroupInfo<
+                CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE>(m_device);
+        maxSize = std::min(maxSize,
+                           static_cast<uint64_t>(def->kernel.getWorkGroupInfo<
+                                                 CL_KERNEL_WORK_GROUP_SIZE>(m_device)));
+    }
+    catch(const cl::Error &err)
+    {
+        error.addMeesage("OpenCL error: "
+                         + std::string(err.what())
+                         + "("
+                         + std::to_string(err.err())
+                         + ")");
+        return false;
+    }
+
+    if(preferredMultiple == 0) {
+        preferredMultiple = 1;
+    }
+    maxSize = std::min(maxSize / otherThreads, getMaxWorkItemSize().x);
+
+    // collect candidates
+    std::vector<uint64_t> candidates;
+    for(uint64_t size = preferredMultiple; size <= maxSize; size *= 2)
+    {
+        if(totalX % size == 0) {
+            candidates.push_back(size);
+        }
+    }
+    if(std::find(candidates.begin(), candidates.end(), data.threadsPerWg.x) == candidates.end()
+            && data.threadsPerWg.x <= maxSize)
+    {
+        candidates.push_back(data.threadsPerWg.x);
+    }
+
+    if(candidates.size() == 0)
+    {
+        error.addMeesage("no valid work-group size found for kernel '" + kernelName + "'");
+        return false;
+    }
+
+    // benchmark all candidates
+    uint64_t bestSize = candidates.at(0);
+    uint64_t bestDuration = 0xFFFFFFFFFFFFFFFF;
+    for(const uint64_t size : candidates)
+    {
+        data.threadsPerWg.x = size;
+        data.numberOfWg.x = totalX / size;
+
+        // errors of skipped candidates are not errors of the whole tuning
+        uint64_t duration = 0;
+        ErrorContainer candidateError;
+        if(benchmarkKernel(data, *def, tuningQueue, numberOfRuns, duration, candidateError)
+                == false)
+        {
+            // some sizes are only rejected by the driver at runtime, for example because of
+            // the local memory of the kernel, so these are skipped
+            LOG_DEBUG("skip work-group size " + std::to_string(size));
+            continue;
+        }
+
+        if(duration < bestDuration)
+        {
+            bestDuration = duration;
+            bestSize = size;
+        }
+    }
+
+    if(bestDuration == 0xFFFFFFFFFFFFFFFF)
+    {
+        error.addMeesage("failed to run kernel '" + kernelName + "' with any work-group size");
+        return false;
+    }
+
+    LOG_DEBUG("tuned work-group size for kernel '"
+              + kernelName
+              + "' to "
+              + std::to_string(bestSize));
+
+    data.threadsPerWg.x = bestSize;
+    data.numberOfWg.x = totalX / bestSize;
+
+    // a failed storage only loses the result for later calls, so it is not handled as error
+    if(m_workGroupTuner != nullptr)
+    {
+        ErrorContainer storeError;
+        if(m_workGroupTuner->storeResult(key, bestSize, storeError) == false) {
+            LOG_WARNING("failed to store result of the work-group tuning");
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief calculate the worker-dimensions of a data-object for a problem-size. The number of
+ *        threads per work-group is derived from the limits of the kernel and the device, where
+ *        the x-dimension is filled first up to the preferred work-group size multiple and the
+ *        remaining threads are given to the dimensions with the most work-items per thread.
+ *        The number of work-groups is rounded up, so the global range can be bigger than the
+ *        problem-size and the kernel has to ignore the padding work-items, for example with
+ *        a check of get_global_id against the problem-size. With an offset, a big problem can
+ *        be split into multiple launches, where get_global_id already contains the offset.
+ *
+ * @param data data-object, where the worker-dimensions should be set
+ * @param kernelName name of the kernel, which should be executed
+ * @param problemSize number of work-items, which have to be processed in each dimension
+ * @param error reference for error-output
+ * @param offset offset of the first work-item in each dimension
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuInterface::calculateRange(GpuData &data,
+                             const std::string &kernelName,
+                             const WorkerDim &problemSize,
+                             ErrorContainer &error,
+                             const WorkerDim &offset)
+{
+    GpuData::KernelDef* def = data.getKernel(kernelName);
+    if(def == nullptr)
+    {
+        error.addMeesage("no kernel with name '" + kernelName + "' found");
+        return false;
+    }
+
+    if(problemSize.x == 0
+            || problemSize.y == 0
+            || problemSize.z == 0)
+    {
+        error.addMeesage("problem-size for kernel '" + kernelName + "' is empty");
+        return false;
+    }
+
+    // get limits of the kernel and the device
+    uint64_t preferredMultiple = 1;
+    uint64_t maxSize = getMaxWorkGroupSize();
+    try
+    {
+        preferredMultiple = def->kernel.getWorkGroupInfo<
+                CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE>(m_device);
+        maxSize = std::min(maxSize,
+                           static_cast<uint64_t>(def->kernel.getWorkGroupInfo<
+                                                 CL_KERNEL_WORK_GROUP_SIZE>(m_device)));
+    }
+    catch(const cl::Error &err)
+    {
+        error.addMeesage("OpenCL error: "
+                         + std::string(err.what())
+                         + "("
+                         + std::to_string(err.err())
+                         + ")");
+        return false;
+    }
+
+    // bigger work-groups rarely bring more performance, but reduce the number of work-groups,
+    // which can be distributed over the compute-units
+    maxSize = std::min(maxSize, static_cast<uint64_t>(256));
+
+    const WorkerDim maxDim = getMaxWorkItemSize();
+    const uint64_t problem[3] = {problemSize.x, problemSize.y, problemSize.z};
+    const uint64_t limit[3] = {maxDim.x, maxDim.y, maxDim.z};
+    uint64_t local[3] = {1, 1, 1};
+    uint64_t total = 1;
+
+    // fill x-dimension first, because neighbouring work-items in x-direction usually access
+    // neighbouring memory
+    while(local[0] < preferredMultiple
+          && local[0] < problem[0]
+          && local[0] * 2 <= limit[0]
+          && total * 2 <= maxSize)
+    {
+        local[0] *= 2;
+        total *= 2;
+    }
+
+    // give remaining threads to the dimension with the most work-items per thread
+    while(total * 2 <= maxSize)
+    {
+        int32_t next = -1;
+        uint64_t nextRatio = 1;
+        for(uint32_t dim = 0; dim < 3; dim++)
+        {
+            if(local[dim] >= problem[dim]
+                    || local[dim] * 2 > limit[dim])
+            {
+                continue;
+            }
+
+            const uint64_t ratio = problem[dim] / local[dim];
+            if(ratio > nextRatio)
+            {
+                next = dim;
+                nextRatio = ratio;
+            }
+        }
+
+        if(next == -1) {
+            break;
+        }
+
+        local[next] *= 2;
+        total *= 2;
+    }
+
+    // round number of work-groups up to cover the whole problem
+    data.threadsPerWg.x = local[0];
+    data.threadsPerWg.y = local[1];
+    data.threadsPerWg.z = local[2];
+    data.numberOfWg.x = (problem[0] + local[0] - 1) / local[0];
+    data.numberOfWg.y = (problem[1] + local[1] - 1) / local[1];
+    data.numberOfWg.z = (problem[2] + local[2] - 1) / local[2];
+    data.globalOffset = offset;
+
+    // use a result of an earlier tuning for the same sizes instead of the calculated size
+    std::string key = "";
+    applyTunedWorkGroupSize(data, *def, key);
+
+    return true;
+}
+
+/**
+ * @brief apply a stored result of the work-group tuning for the current sizes of the data-object.
+ *        The total number of threads in x-direction is kept, so numberOfWg.x is adjusted.
+ *
+ * @param data data-object with the worker-dimensions
+ * @param def kernel, for which the result was tuned
+ * @param key reference for the key of the result, which is empty if tuning is disabled
+ *
+ * @return true, if a stored result was applied, else false
+ */
+bool
+GpuInterface::applyTunedWorkGroupSize(GpuData &data,
+                                      GpuData::KernelDef &def,
+                                      std::string &key)
+{
+    if(m_workGroupTuner == nullptr) {
+        return false;
+    }
+
+    if(def.tuningHash == 0)
+    {
+        def.tuningHash = m_workGroupTuner->createKernelHash(m_device,
+                                                            def.kernelCode + def.buildOptions,
+                                                            def.id);
+    }
+
+    const uint64_t totalX = data.numberOfWg.x * data.threadsPerWg.x;
+    WorkerDim globalSize;
+    globalSize.x = totalX;
+    globalSize.y = data.numberOfWg.y * data.threadsPerWg.y;
+    globalSize.z = data.numberOfWg.z * data.threadsPerWg.z;
+    key = m_workGroupTuner->createKey(def.tuningHash, globalSize, data.threadsPerWg);
+
+    uint64_t localSizeX = 0;
+    if(m_workGroupTuner->loadResult(key, localSizeX) == false
+            || totalX % localSizeX != 0)
+    {
+        return false;
+    }
+
+    LOG_DEBUG("use stored work-group size "
+              + std::to_string(localSizeX)
+              + " for kernel '"
+              + def.id
+              + "'");
+    data.threadsPerWg.x = localSizeX;
+    data.numberOfWg.x = totalX / localSizeX;
+
+    return true;
+}
+
+/**
+ * @brief get size of the local memory on device
+ *
+ * @return size of local memory on device, or 0 if no device is initialized
+ */
+uint64_t
+GpuInterface::getLocalMemorySize()
+{
+    // get information
+    cl_ulong size = 0;
+    m_device.getInfo(CL_DEVICE_LOCAL_MEM_SIZE, &size);
+
+    return size;
+}
+
+/**
+ * @brief get size of the global memory on device
+ *
+ * @return size of global memory on device, or 0 if no device is initialized
+ */
+uint64_t
+GpuInterface::getGlobalMemorySize()
+{
+    // get information
+    cl_ulong size = 0;
+    m_device.getInfo(CL_DEVICE_GLOBAL_MEM_SIZE, &size);
+
+    return size;
+}
+
+/**
+ * @brief get maximum memory size, which can be allocated at one time on device
+ *
+ * @return maximum at one time allocatable size, or 0 if no device is initialized
+ */
+uint64_t
+GpuInterface::getMaxMemAllocSize()
+{
+    // get information
+    cl_ulong size = 0;
+    m_device.getInfo(CL_DEVICE_MAX_MEM_ALLOC_SIZE, &size);
+
+    return size;
+}
+
+/**
+ * @brief get maximum total number of work-items within a work-group
+ *
+ * @return maximum work-group size
+ */
+uint64_t
+GpuInterface::getMaxWorkGroupSize()
+{
+    // get information
+    size_t size = 0;
+    m_device.getInfo(CL_DEVICE_MAX_WORK_GROUP_SIZE, &size);
+
+    return size;
+}
+
+/**
+ * @brief get maximum size of all dimensions of work-items within a work-group
+ *
+ * @return worker-dimension object
+ */
+const WorkerDim
+GpuInterface::getMaxWorkItemSize()
+{
+    // get information
+    size_t size[3];
+    m_device.getInfo(CL_DEVICE_MAX_WORK_ITEM_SIZES, &size);
+
+    // create result object
+    const uint64_t dimension = getMaxWorkItemDimension();
+    WorkerDim result;
+    if(dimension > 0) {
+        result.x = size[0];
+    }
+    if(dimension > 1) {
+        result.y = size[1];
+    }
+    if(dimension > 2) {
+        result.z = size[2];
+    }
+
+    return result;
+}
+
+/**
+ * @brief get maximaum dimension of items
+ *
+ * @return number of dimensions
+ */
+uint64_t
+GpuInterface::getMaxWorkItemDimension()
+{
+    // get information
+    cl_uint size = 0;
+    m_device.getInfo(CL_DEVICE_MAX_WORK_ITEM_DIMENSIONS, &size);
+
+    return size;
+}
+
+/**
+ * @brief build program for the device. Each combination of source-code and build-options is
+ *        build only once. If the same variant is already compiled by another thread, this thread
+ *        waits for the result instead of compiling it again.
+ *
+ * @param program reference for the resulting program
+ * @param kernelCode source-code of the program
+ * @param buildOptions options for the compilation
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuInterface::buildProgram(cl::Program &program,
+                           const std::string &kernelCode,
+                           const std::string &buildOptions,
+                           ErrorContainer &error)
+{
+    if(initContext(error) == false) {
+        return false;
+    }
+
+    // reuse program, which was already build with the same source-code and options, or register
+    // the build before it starts, so parallel requests for the same variant wait for it
+    const std::string variantKey = buildOptions + '\0' + kernelCode;
+    std::promise<BuildResult> promise;
+    std::shared_future<BuildResult> runningBuild;
+    {
+        std::lock_guard<std::mutex> guard(m_programVariantLock);
+        std::map<std::string, cl::Program>::const_iterator it;
+        it = m_programVariants.find(variantKey);
+        if(it != m_programVariants.end())
+        {
+            program = it->second;
+            return true;
+        }
+
+        std::map<std::string, std::shared_future<BuildResult>>::const_iterator runningIt;
+        runningIt = m_runningVariantBuilds.find(variantKey);
+        if(runningIt != m_runningVariantBuilds.end()) {
+            runningBuild = runningIt->second;
+        } else {
+            m_runningVariantBuilds.insert(std::make_pair(variantKey, promise.get_future().share()));
+        }
+    }
+
+    // wait for the build of the other thread without holding the lock
+    if(runningBuild.valid())
+    {
+        const BuildResult result = runningBuild.get();
+        if(result.success == false)
+        {
+            error.addMeesage(result.errorMessage);
+            return false;
+        }
+
+        program = result.program;
+        return true;
+    }
+
+    // the waiting threads must always get a result, so no exception is allowed to leave here
+    BuildResult result;
+    ErrorContainer buildError;
+    try
+    {
+        result.success = compileProgram(result.program, kernelCode, buildOptions, buildError);
+    }
+    catch(const cl::Error &err)
+    {
+        buildError.addMeesage("OpenCL error while creating program: "
+                              + std::string(err.what())
+                              + "("
+                              + std::to_string(err.err())
+                              + ")");
+        result.success = false;
+    }
+    if(result.success == false) {
+        result.errorMessage = buildError.toString();
+    }
+
+    // register the result and wake up the waiting threads
+    {
+        std::lock_guard<std::mutex> guard(m_programVariantLock);
+        if(result.success) {
+            m_programVariants.insert(std::make_pair(variantKey, result.program));
+        }
+        m_runningVariantBuilds.erase(variantKey);
+    }
+    promise.set_value(result);
+
+    if(result.success == false)
+    {
+        error.addMeesage(result.errorMessage);
+        return false;
+    }
+
+    program = result.program;
+    return true;
+}
+
+/**
+ * @brief compile a program for the device, either from the program-cache or from source
+ *
+ * @param program reference for the resulting program
+ * @param kernelCode source-code of the program
+ * @param buildOptions options for the compilation
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuInterface::compileProgram(cl::Program &program,
+                             const std::string &kernelCode,
+                             const std::string &buildOptions,
+                             ErrorContainer &error)
+{
+    // try to get program from the cache
+    std::string cacheKey = "";
+    if(m_programCache != nullptr)
+    {
+        cacheKey = m_programCache->createKey(m_device, kernelCode, buildOptions);
+        if(m_programCache->loadProgram(program, m_context, m_device, cacheKey, buildOptions)) {
+            return true;
+        }
+    }
+
+    // compile opencl program for found device.
+    cl::Program::Sources source;
+    source.push_back(kernelCode);
+    program = cl::Program(m_context, source);
+
+    try
+    {
+        std::vector<cl::Device> devices = {m_device};
+        program.build(devices, buildOptions.c_str());
+    }
+    catch(const cl::Error&err)
+    {
+        error.addMeesage("OpenCL compilation error\n    "
+                         + program.getBuildInfo<CL_PROGRAM_BUILD_LOG>(m_device));
+        return false;
+    }
+
+    // update cache with the new compiled program. A failed write only costs a new compilation
+    // next time, so the error is not forwarded
+    if(m_programCache != nullptr)
+    {
+        ErrorContainer cacheError;
+        if(m_programCache->storeProgram(program, m_device, cacheKey, cacheError) == false) {
+            LOG_WARNING("failed to update program-cache for key '" + cacheKey + "'");
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief convert defines and flags into the option-string for the compiler. The defines are
+ *        sorted by the map, so the same options always result in the same string and with this in
+ *        the same program-variant. The flags are kept in the given order, because some of them
+ *        depend on their position, like the path after -I.
+ *
+ * @param options defines and flags for the compiler
+ * @param result reference for the resulting option-string
+ * @param error reference for error-output
+ *
+ * @return false, if a define contains whitespace, which would break the option-string, else true
+ */
+bool
+GpuInterface::convertBuildOptions(const KernelBuildOptions &options,
+                                  std::string &result,
+                                  ErrorContainer &error)
+{
+    result = "";
+
+    std::map<std::string, std::string>::const_iterator it;
+    for(it = options.defines.begin(); it != options.defines.end(); it++)
+    {
+        if(it->first.size() == 0
+                || it->first.find_first_of(" \t\r\n") != std::string::npos
+                || it->second.find_first_of(" \t\r\n") != std::string::npos)
+        {
+            error.addMeesage("invalid define '"
+                             + it->first
+                             + "': name and value must not be empty or contain whitespace");
+            return false;
+        }
+
+        if(result.size() > 0) {
+            result += " ";
+        }
+
+        result += "-D " + it->first;
+        if(it->second.size() > 0) {
+            result += "=" + it->second;
+        }
+    }
+
+    for(const std::string &flag : options.flags)
+    {
+        if(result.size() > 0) {
+            result += " ";
+        }
+
+        result += flag;
+    }
+
+    return true;
+}
+
+/**
+ * @brief validate a region and convert its x-values and pitches from objects into bytes
+ *
+ * @param buffer buffer, which belongs to the region
+ * @param input region in number of objects
+ * @param output reference for the region in bytes
+ * @param error reference for error-output
+ *
+ * @return false, if the region is not within the buffer, else true
+ */
+bool
+GpuInterface::convertRegion(const GpuData::WorkerBuffer &buffer,
+                            const BufferRegion &input,
+                            BufferRegion &output,
+                            ErrorContainer &error)
+{
+    // fill pitches, if not explitely set
+    const uint64_t rowPitch = input.rowPitch == 0 ? input.size.x : input.rowPitch;
+    const uint64_t slicePitch = input.slicePitch == 0 ? rowPitch * input.size.y : input.slicePitch;
+
+    // check region
+    if(input.size.x == 0
+            || input.size.y == 0
+            || input.size.z == 0
+            || input.origin.x + input.size.x > rowPitch
+            || slicePitch < rowPitch * input.size.y
+            || slicePitch % rowPitch != 0)
+    {
+        error.addMeesage("region has an invalid size or pitch");
+        return false;
+    }
+
+    const uint64_t end = (input.origin.z + input.size.z - 1) * slicePitch
+                         + (input.origin.y + input.size.y - 1) * rowPitch
+                         + input.origin.x
+                         + input.size.x;
+    if(end > buffer.numberOfObjects)
+    {
+        error.addMeesage("region is outside of the buffer");
+        return false;
+    }
+
+    // convert into bytes
+    const uint64_t objectSize = buffer.objectSize;
+    output.origin = {input.origin.x * objectSize, input.origin.y, input.origin.z};
+    output.size = {input.size.x * objectSize, input.size.y, input.size.z};
+    output.rowPitch = rowPitch * objectSize;
+    output.slicePitch = slicePitch * objectSize;
+
+    return true;
+}
+
+/**
+ * @brief enqueue update of a buffer on the device
+ *
+ * @param buffer buffer to update
+ * @param event reference for the event to wait for the end of the transfer
+ * @param error reference for error-output
+ * @param numberOfObjects number of objects to copy (0 = whole buffer)
+ * @param offset offset in buffer on device
+ *
+ * @return false, if enqueue of the transfer failed, else true
+ */
+bool
+GpuInterface::enqueueUpdate(GpuData::WorkerBuffer &buffer,
+                            GpuEvent &event,
+                            ErrorContainer &error,
+                            uint64_t numberOfObjects,
+                            const uint64_t offset)
+{
+    const uint64_t objectSize = buffer.objectSize;
+
+    // set size with value of the buffer, if size not explitely set
+    if(numberOfObjects == 0) {
+        numberOfObjects = buffer.numberOfObjects;
+    }
+
+    // check size
+    if(offset + numberOfObjects > buffer.numberOfObjects)
+    {
+        error.addMeesage("write-position invalid");
+        return false;
+    }
+
+    if(numberOfObjects == 0) {
+        return true;
+    }
+
+    bool success = false;
+    if(buffer.useHostPtr)
+    {
+        // host-pointer-buffer are read by the device directly, so they have only to be mapped
+        // and unmapped to make the changes of the host visible for the device
+        success = enqueueMapSync(buffer,
+                                 offset * objectSize,
+                                 numberOfObjects * objectSize,
+                                 CL_MAP_WRITE_INVALIDATE_REGION,
+                                 &event.m_event,
+                                 error);
+    }
+    else
+    {
+        // write data into the buffer on the device
+        success = enqueueWrite(buffer,
+                               offset * objectSize,
+                               numberOfObjects * objectSize,
+                               nullptr,
+                               &event.m_event,
+                               error);
+    }
+
+    if(success == false) {
+        return false;
+    }
+    event.m_isActive = true;
+
+    return true;
+}
+
+/**
+ * @brief enqueue copy of a buffer from the device to the host
+ *
+ * @param buffer buffer to copy
+ * @param event reference for the event to wait for the end of the transfer
+ * @param error reference for error-output
+ * @param numberOfObjects number of objects to copy (0 = whole buffer)
+ * @param offset offset in buffer on device
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuInterface::enqueueCopy(GpuData::WorkerBuffer &buffer,
+                          GpuEvent &event,
+                          ErrorContainer &error,
+                          uint64_t numberOfObjects,
+                          const uint64_t offset)
+{
+    // copy the whole buffer including padding, if size not explitely set
+    uint64_t readOffset = 0;
+    uint64_t readSize = buffer.numberOfBytes;
+    if(numberOfObjects != 0
+            || offset != 0)
+    {
+        if(numberOfObjects == 0) {
+            numberOfObjects = buffer.numberOfObjects - std::min(offset, buffer.numberOfObjects);
+        }
+
+        // check size
+        if(offset + numberOfObjects > buffer.numberOfObjects)
+        {
+            error.addMeesage("read-position invalid");
+            return false;
+        }
+
+        const uint64_t objectSize = buffer.objectSize;
+        readOffset = offset * objectSize;
+        readSize = numberOfObjects * objectSize;
+    }
+
+    // copy result back to host. Host-pointer-buffer are mapped instead, which doesn't copy any
+    // data, if the device works directly on the host-memory
+    bool success = false;
+    if(buffer.useHostPtr)
+    {
+        success = enqueueMapSync(buffer,
+                                 readOffset,
+                                 readSize,
+                                 CL_MAP_READ,
+                                 &event.m_event,
+                                 error);
+    }
+    else
+    {
+        success = enqueueRead(buffer,
+                              readOffset,
+                              readSize,
+                              nullptr,
+                              &event.m_event,
+                              error);
+    }
+
+    if(success == false) {
+        return false;
+    }
+    event.m_isActive = true;
+
+    return true;
+}
+
+/**
+ * @brief enqueue update of a rectangular region of a buffer on the device
+ *
+ * @param buffer buffer to update
+ * @param region region to update
+ * @param event reference for the event to wait for the end of the transfer
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuInterface::enqueueUpdateRegion(GpuData::WorkerBuffer &buffer,
+                                  const BufferRegion &region,
+                                  GpuEvent &event,
+                                  ErrorContainer &error)
+{
+    BufferRegion byteRegion;
+    if(convertRegion(buffer, region, byteRegion, error) == false) {
+        return false;
+    }
+
+    // host-pointer-buffer are read by the device directly, so there is nothing to transfer
+    if(buffer.useHostPtr) {
+        return true;
+    }
+
+    if(enqueueWriteRect(buffer, byteRegion, nullptr, &event.m_event, error) == false) {
+        return false;
+    }
+    event.m_isActive = true;
+
+    return true;
+}
+
+/**
+ * @brief enqueue copy of a rectangular region of a buffer from the device to the host
+ *
+ * @param buffer buffer to copy
+ * @param region region to copy
+ * @param event reference for the event to wait for the end of the transfer
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuInterface::enqueueCopyRegion(GpuData::WorkerBuffer &buffer,
+                                const BufferRegion &region,
+                                GpuEvent &event,
+                                ErrorContainer &error)
+{
+    BufferRegion byteRegion;
+    if(convertRegion(buffer, region, byteRegion, error) == false) {
+        return false;
+    }
+
+    if(enqueueReadRect(buffer, byteRegion, nullptr, &event.m_event, error) == false) {
+        return false;
+    }
+    event.m_isActive = true;
+
+    return true;
+}
+
+/**
+ * @brief map a buffer blocking into the host-address-space
+ *
+ * @param buffer buffer to map
+ * @param mode mode of the mapping
+ * @param error reference for error-output
+ *
+ * @return pointer to the mapped memory, or nullptr if failed
+ */
+void*
+GpuInterface::enqueueMap(GpuData::WorkerBuffer &buffer,
+                         const MapMode mode,
+                         ErrorContainer &error)
+{
+    if(buffer.mappedData != nullptr)
+    {
+        error.addMeesage("buffer is already mapped");
+        return nullptr;
+    }
+
+    cl_map_flags flags = CL_MAP_READ;
+    if(mode == MAP_WRITE) {
+        flags = CL_MAP_READ | CL_MAP_WRITE;
+    } else if(mode == MAP_WRITE_INVALIDATE) {
+        flags = CL_MAP_WRITE_INVALIDATE_REGION;
+    }
+
+    try
+    {
+        const std::vector<cl::Event>* waitList = nullptr;
+        cl::Event* event = nullptr;
+        cl::CommandQueue &queue = prepareTransfer(buffer, mode != MAP_READ, waitList, event);
+        buffer.mappedData = queue.enqueueMapBuffer(buffer.clBuffer,
+                                                   CL_TRUE,
+                                                   flags,
+                                                   0,
+                                                   buffer.numberOfBytes,
+                                                   waitList);
+    }
+    catch(const cl::Error &err)
+    {
+        error.addMeesage("OpenCL error while mapping buffer: "
+                         + std::string(err.what())
+                         + "("
+                         + std::to_string(err.err())
+                         + ")");
+        return nullptr;
+    }
+
+    return buffer.mappedData;
+}
+
+/**
+ * @brief unmap a mapped buffer
+ *
+ * @param buffer buffer to unmap
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuInterface::enqueueUnmap(GpuData::WorkerBuffer &buffer,
+                           ErrorContainer &error)
+{
+    if(buffer.mappedData == nullptr)
+    {
+        error.addMeesage("buffer is not mapped");
+        return false;
+    }
+
+    try
+    {
+        const std::vector<cl::Event>* waitList = nullptr;
+        cl::Event* event = nullptr;
+        cl::CommandQueue &queue = prepareTransfer(buffer, true, waitList, event);
+        queue.enqueueUnmapMemObject(buffer.clBuffer, buffer.mappedData, waitList, event);
+        finishTransfer(queue, buffer, nullptr);
+    }
+    catch(const cl::Error &err)
+    {
+        error.addMeesage("OpenCL error while unmapping buffer: "
+                         + std::string(err.what())
+                         + "("
+                         + std::to_string(err.err())
+                         + ")");
+        return false;
+    }
+
+    buffer.mappedData = nullptr;
+
+    return true;
+}
+
+/**
+ * @brief enqueue non-blocking transfer of a buffer-section from the host to the device
+ *
+ * @param buffer buffer to update
+ * @param offset offset in bytes within the buffer
+ * @param size number of bytes to transfer
+ * @param waitList optional list of events, which have to be finished before the transfer
+ * @param event optional pointer for the event of the transfer
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuInterface::enqueueWrite(GpuData::WorkerBuffer &buffer,
+                           const uint64_t offset,
+                           const uint64_t size,
+                           const std::vector<cl::Event>* waitList,
+                           cl::Event* event,
+                           ErrorContainer &error)
+{
+    try
+    {
+        const uint8_t* source = static_cast<const uint8_t*>(buffer.data) + offset;
+        cl::Event* transferEvent = event;
+        cl::CommandQueue &queue = prepareTransfer(buffer, true, waitList, transferEvent);
+        queue.enqueueWriteBuffer(buffer.clBuffer,
+                                 CL_FALSE,
+                                 offset,
+                                 size,
+                                 source,
+                                 waitList,
+                                 transferEvent);
+        recordOperation("updateBufferOnDevice", PROFILE_WRITE, buffer.name, size, transferEvent);
+        finishTransfer(queue, buffer, event);
+    }
+    catch(const cl::Error &err)
+    {
+        error.addMeesage("OpenCL error while writing buffer: "
+                         + std::string(err.what())
+                         + "("
+                         + std::to_string(err.err())
+                         + ")");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief enqueue non-blocking transfer of a range of adjacent buffer of an arena from the host to
+ *        the device with a single write into the arena
+ *
+ * @param arena arena, which contains the buffer
+ * @param parts buffer of the arena, sorted by their position within the arena
+ * @param event optional pointer for the event of the transfer
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuInterface::enqueueArenaWrite(GpuData::WorkerBuffer &arena,
+                                const std::vector<GpuData::WorkerBuffer*> &parts,
+                                cl::Event* event,
+                                ErrorContainer &error)
+{
+    const uint64_t offset = parts.front()->arenaOffset;
+    const uint64_t size = parts.back()->arenaOffset + parts.back()->numberOfBytes - offset;
+
+    try
+    {
+        const uint8_t* source = static_cast<const uint8_t*>(arena.data) + offset;
+        if(m_useSeparateQueues == false)
+        {
+            cl::Event* transferEvent = event;
+            if(transferEvent == nullptr && m_recordOperations) {
+                transferEvent = getProfilingEvent();
+            }
+
+            getQueue().enqueueWriteBuffer(arena.clBuffer,
+                                          CL_FALSE,
+                                          offset,
+                                          size,
+                                          source,
+                                          nullptr,
+                                          transferEvent);
+            recordOperation("updateBuffersOnDevice",
+                            PROFILE_WRITE,
+                            arena.name,
+                            size,
+                            transferEvent);
+            return true;
+        }
+
+        // wait for the last operations on all covered buffer and on the arena itself
+        std::vector<GpuData::WorkerBuffer*> buffers = parts;
+        buffers.push_back(&arena);
+        const std::vector<cl::Event>* waitList = prepareWaitList(nullptr,
+                                                                 buffers.data(),
+                                                                 buffers.size());
+
+        cl::Event transferEvent;
+        m_uploadQueue.enqueueWriteBuffer(arena.clBuffer,
+                                         CL_FALSE,
+                                         offset,
+                                         size,
+                                         source,
+                                         waitList,
+                                         &transferEvent);
+        m_uploadQueue.flush();
+        recordOperation("updateBuffersOnDevice", PROFILE_WRITE, arena.name, size, &transferEvent);
+
+        for(GpuData::WorkerBuffer* part : parts)
+        {
+            part->lastEvent = transferEvent;
+            part->hasLastEvent = true;
+        }
+        if(event != nullptr) {
+            *event = transferEvent;
+        }
+    }
+    catch(const cl::Error &err)
+    {
+        error.addMeesage("OpenCL error while writing arena: "
+                         + std::string(err.what())
+                         + "("
+                         + std::to_string(err.err())
+                         + ")");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief enqueue non-blocking transfer of a buffer-section from the device to the host
+ *
+ * @param buffer buffer to read
+ * @param offset offset in bytes within the buffer
+ * @param size number of bytes to transfer
+ * @param waitList optional list of events, which have to be finished before the transfer
+ * @param event optional pointer for the event of the transfer
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuInterface::enqueueRead(GpuData::WorkerBuffer &buffer,
+                          const uint64_t offset,
+                          const uint64_t size,
+                          const std::vector<cl::Event>* waitList,
+                          cl::Event* event,
+                          ErrorContainer &error)
+{
+    try
+    {
+        uint8_t* target = static_cast<uint8_t*>(buffer.data) + offset;
+        cl::Event* transferEvent = event;
+        cl::CommandQueue &queue = prepareTransfer(buffer, false, waitList, transferEvent);
+        queue.enqueueReadBuffer(buffer.clBuffer,
+                                CL_FALSE,
+                                offset,
+                                size,
+                                target,
+                                waitList,
+                                transferEvent);
+        recordOperation("copyFromDevice", PROFILE_READ, buffer.name, size, transferEvent);
+        finishTransfer(queue, buffer, event);
+    }
+    catch(const cl::Error &err)
+    {
+        error.addMeesage("OpenCL error while reading buffer: "
+                         + std::string(err.what())
+                         + "("
+                         + std::to_string(err.err())
+                         + ")");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief enqueue non-blocking transfer of a rectangular region from the host to the device. The
+ *        host-memory of the buffer has the same layout like the buffer on the device.
+ *
+ * @param buffer buffer to update
+ * @param region region within the buffer, which is already converted into bytes
+ * @param waitList optional list of events, which have to be finished before the transfer
+ * @param event optional pointer for the event of the transfer
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuInterface::enqueueWriteRect(GpuData::WorkerBuffer &buffer,
+                               const BufferRegion &region,
+                               const std::vector<cl::Event>* waitList,
+                               cl::Event* event,
+                               ErrorContainer &error)
+{
+    const cl::array<cl::size_type, 3> origin = {region.origin.x,
+                                                region.origin.y,
+                                                region.origin.z};
+    const cl::array<cl::size_type, 3> size = {region.size.x,
+                                              region.size.y,
+                                              region.size.z};
+
+    try
+    {
+        cl::Event* transferEvent = event;
+        cl::CommandQueue &queue = prepareTransfer(buffer, true, waitList, transferEvent);
+        queue.enqueueWriteBufferRect(buffer.clBuffer,
+                                     CL_FALSE,
+                                     origin,
+                                     origin,
+                                     size,
+                                     region.rowPitch,
+                                     region.slicePitch,
+                                     region.rowPitch,
+                                     region.slicePitch,
+                                     buffer.data,
+                                     waitList,
+                                     transferEvent);
+        recordOperation("updateRegionOnDevice",
+                        PROFILE_WRITE,
+                        buffer.name,
+                        region.size.x * region.size.y * region.size.z,
+                        transferEvent);
+        finishTransfer(queue, buffer, event);
+    }
+    catch(const cl::Error &err)
+    {
+        error.addMeesage("OpenCL error while writing region of buffer: "
+                         + std::string(err.what())
+                         + "("
+                         + std::to_string(err.err())
+                         + ")");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief enqueue non-blocking transfer of a rectangular region from the device to the host. The
+ *        host-memory of the buffer has the same layout like the buffer on the device.
+ *
+ * @param buffer buffer to read
+ * @param region region within the buffer, which is already converted into bytes
+ * @param waitList optional list of events, which have to be finished before the transfer
+ * @param event optional pointer for the event of the transfer
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuInterface::enqueueReadRect(GpuData::WorkerBuffer &buffer,
+                              const BufferRegion &region,
+                              const std::vector<cl::Event>* waitList,
+                              cl::Event* event,
+                              ErrorContainer &error)
+{
+    const cl::array<cl::size_type, 3> origin = {region.origin.x,
+                                                region.origin.y,
+                                                region.origin.z};
+    const cl::array<cl::size_type, 3> size = {region.size.x,
+                                              region.size.y,
+                                              region.size.z};
+
+    try
+    {
+        cl::Event* transferEvent = event;
+        cl::CommandQueue &queue = prepareTransfer(buffer, false, waitList, transferEvent);
+        queue.enqueueReadBufferRect(buffer.clBuffer,
+                                    CL_FALSE,
+                                    origin,
+                                    origin,
+                                    size,
+                                    region.rowPitch,
+                                    region.slicePitch,
+                                    region.rowPitch,
+                                    region.slicePitch,
+                                    buffer.data,
+                                    waitList,
+                                    transferEvent);
+        recordOperation("copyRegionFromDevice",
+                        PROFILE_READ,
+                        buffer.name,
+                        region.size.x * region.size.y * region.size.z,
+                        transferEvent);
+        finishTransfer(queue, buffer, event);
+    }
+    catch(const cl::Error &err)
+    {
+        error.addMeesage("OpenCL error while reading region of buffer: "
+                         + std::string(err.what())
+                         + "("
+                         + std::to_string(err.err())
+                         + ")");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief map a buffer-section blocking and unmap it again without blocking, to synchronize the
+ *        memory of a host-pointer-buffer between host and device
+ *
+ * @param buffer buffer to synchronize
+ * @param offset offset in bytes within the buffer
+ * @param size number of bytes to synchronize
+ * @param flags CL_MAP_READ to make the data of the device visible for the host or
+ *              CL_MAP_WRITE_INVALIDATE_REGION to make the data of the host visible for the device
+ * @param event optional pointer for the event of the unmap
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuInterface::enqueueMapSync(GpuData::WorkerBuffer &buffer,
+                             const uint64_t offset,
+                             const uint64_t size,
+                             const cl_map_flags flags,
+                             cl::Event* event,
+                             ErrorContainer &error)
+{
+    try
+    {
+        const std::vector<cl::Event>* waitList = nullptr;
+        cl::Event* transferEvent = event;
+        cl::CommandQueue &queue = prepareTransfer(buffer,
+                                                  flags != CL_MAP_READ,
+                                                  waitList,
+                                                  transferEvent);
+        void* mapped = queue.enqueueMapBuffer(buffer.clBuffer,
+                                              CL_TRUE,
+                                              flags,
+                                              offset,
+                                              size,
+                                              waitList);
+        queue.enqueueUnmapMemObject(buffer.clBuffer, mapped, nullptr, transferEvent);
+        if(flags == CL_MAP_READ) {
+            recordOperation("copyFromDevice", PROFILE_READ, buffer.name, size, transferEvent);
+        } else {
+            recordOperation("updateBufferOnDevice",
+                            PROFILE_WRITE,
+                            buffer.name,
+                            size,
+                            transferEvent);
+        }
+        finishTransfer(queue, buffer, event);
+    }
+    catch(const cl::Error &err)
+    {
+        error.addMeesage("OpenCL error while mapping buffer: "
+                         + std::string(err.what())
+                         + "("
+                         + std::to_string(err.err())
+                         + ")");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief recreate all queues with profiling enabled, which is necessary to read the times of the
+ *        operations on the device
+ *
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuInterface::enableQueueProfiling(ErrorContainer &error)
+{
+    if(initContext(error) == false) {
+        return false;
+    }
+
+    if(m_queueProperties & CL_QUEUE_PROFILING_ENABLE)
+    {
+        m_recordOperations = true;
+        return true;
+    }
+
+    if(finishQueues() == false)
+    {
+        error.addMeesage("failed to finish queues before enabling profiling");
+        return false;
+    }
+
+    try
+    {
+        const cl_command_queue_properties properties = m_queueProperties
+                                                       | CL_QUEUE_PROFILING_ENABLE;
+        m_queue = cl::CommandQueue(m_context, m_device, properties);
+        if(m_useSeparateQueues)
+        {
+            m_uploadQueue = cl::CommandQueue(m_context, m_device, properties);
+            m_downloadQueue = cl::CommandQueue(m_context, m_device, properties);
+            for(cl::CommandQueue &queue : m_computeQueues) {
+                queue = cl::CommandQueue(m_context, m_device, properties);
+            }
+        }
+
+        std::unique_lock<std::shared_mutex> guard(m_threadQueueLock);
+        for(auto& [id, threadQueue] : m_threadQueues) {
+            threadQueue.queue = cl::CommandQueue(m_context, m_device, properties);
+        }
+        m_queueProperties = properties;
+    }
+    catch(const cl::Error &err)
+    {
+        error.addMeesage("OpenCL error while creating queues with profiling: "
+                         + std::string(err.what())
+                         + "("
+                         + std::to_string(err.err())
+                         + ")");
+        LOG_ERROR(error);
+        return false;
+    }
+
+    m_recordOperations = true;
+
+    return true;
+}
 
 /**
- * @brief close device, free buffer on device and delete all data from the data-object, which are
- *        not a null-pointer
+ * @brief register the event of an enqueued operation at the profiler and the tracer, if they are
+ *        enabled. Without both this is only a pointer-check.
  *
- * @param data object with all data related to the device, which will be cleared
+ * @param operation name of the operation for the trace
+ * @param type type of the operation
+ * @param name name of the kernel or buffer
+ * @param numberOfBytes number of transfered bytes
+ * @param event pointer to the event of the operation
+ */
+void
+GpuInterface::recordOperation(const char* operation,
+                              const ProfilingType type,
+                              const std::string &name,
+                              const uint64_t numberOfBytes,
+                              const cl::Event* event)
+{
+    if(m_recordOperations == false
+            || event == nullptr)
+    {
+        return;
+    }
 
- * @return true, if successful, else false
+    std::lock_guard<std::mutex> guard(m_recordLock);
+
+    if(m_profiler != nullptr) {
+        m_profiler->addEvent(type, name, numberOfBytes, *event);
+    }
+
+    if(m_tracer != nullptr) {
+        m_tracer->addEvent(operation, type, name, numberOfBytes, *event);
+    }
+}
+
+/**
+ * @brief get queue of the calling thread and create it at the first call of the thread
+ *
+ * @return pointer to the queue of the thread, or nullptr if per-thread queues are disabled
  */
-bool
-GpuInterface::closeDevice(GpuData &data)
+GpuInterface::ThreadQueue*
+GpuInterface::getThreadQueue()
 {
-    LOG_DEBUG("close OpenCL device");
+    if(m_usePerThreadQueues == false) {
+        return nullptr;
+    }
 
-    // end queue
-    const cl_int ret = m_queue.finish();
-    if(ret != CL_SUCCESS) {
-        return false;
+    const std::thread::id threadId = std::this_thread::get_id();
+
+    // fast path for all further operations of the thread
+    {
+        std::shared_lock<std::shared_mutex> guard(m_threadQueueLock);
+        std::map<std::thread::id, ThreadQueue>::iterator it;
+        it = m_threadQueues.find(threadId);
+        if(it != m_threadQueues.end()) {
+            return &it->second;
+        }
     }
 
-    // free allocated memory on the host
-    for(auto& [name, workerBuffer] : data.m_buffer)
+    // the entry of a thread is only removed by the thread itself, so the pointer stays valid
+    std::unique_lock<std::shared_mutex> guard(m_threadQueueLock);
+    ThreadQueue &threadQueue = m_threadQueues[threadId];
+    if(threadQueue.queue() == nullptr) {
+        threadQueue.queue = cl::CommandQueue(m_context, m_device, m_queueProperties);
+    }
+
+    return &threadQueue;
+}
+
+/**
+ * @brief get queue for operations, which are not using the separate queues
+ *
+ * @return queue of the calling thread, if per-thread queues are enabled, else default-queue
+ */
+cl::CommandQueue&
+GpuInterface::getQueue()
+{
+    ThreadQueue* threadQueue = getThreadQueue();
+    if(threadQueue != nullptr) {
+        return threadQueue->queue;
+    }
+
+    return m_queue;
+}
+
+/**
+ * @brief get event, which is used for operations, where the caller doesn't need an event, but the
+ *        profiler or the tracer
+ *
+ * @return pointer to the event of the calling thread
+ */
+cl::Event*
+GpuInterface::getProfilingEvent()
+{
+    ThreadQueue* threadQueue = getThreadQueue();
+    if(threadQueue != nullptr) {
+        return &threadQueue->profilingEvent;
+    }
+
+    return &m_profilingEvent;
+}
+
+/**
+ * @brief select queue for a transfer and prepare wait-list and event. With separate queues the
+ *        transfer has to wait for the last operation on the buffer and its event is stored
+ *        within the buffer. Uploads and downloads are using different queues, so the upload for
+ *        the next kernel doesn't have to wait for the download of the results of the last one.
+ *
+ * @param buffer buffer, which is transfered
+ * @param upload true for a transfer to the device, false for a transfer to the host
+ * @param waitList reference to the wait-list, which is updated if necessary
+ * @param event reference to the event-pointer, which is updated if necessary
+ *
+ * @return queue for the transfer
+ */
+cl::CommandQueue&
+GpuInterface::prepareTransfer(GpuData::WorkerBuffer &buffer,
+                              const bool upload,
+                              const std::vector<cl::Event>* &waitList,
+                              cl::Event* &event)
+{
+    if(m_useSeparateQueues == false)
     {
-        if(workerBuffer.data != nullptr
-                && workerBuffer.allowBufferDeleteAfterClose)
-        {
-            Kitsunemimi::alignedFree(workerBuffer.data, workerBuffer.numberOfBytes);
+        // the profiler and the tracer require an event of each operation
+        if(event == nullptr && m_recordOperations) {
+            event = getProfilingEvent();
         }
+        return getQueue();
     }
 
-    // clear data and free memory on the device
-    data.m_buffer.clear();
+    GpuData::WorkerBuffer* buffers[1] = {&buffer};
+    waitList = prepareWaitList(waitList, buffers, 1);
+    event = &buffer.lastEvent;
 
-    return true;
+    if(upload) {
+        return m_uploadQueue;
+    }
+
+    return m_downloadQueue;
 }
 
 /**
- * @brief get size of the local memory on device
+ * @brief finish a transfer after it was enqueued
  *
- * @return size of local memory on device, or 0 if no device is initialized
+ * @param queue queue, which was selected by prepareTransfer
+ * @param buffer buffer, which is transfered
+ * @param event optional pointer for the event of the transfer, which was given by the caller
  */
-uint64_t
-GpuInterface::getLocalMemorySize()
+void
+GpuInterface::finishTransfer(cl::CommandQueue &queue,
+                             GpuData::WorkerBuffer &buffer,
+                             cl::Event* event)
 {
-    // get information
-    cl_ulong size = 0;
-    m_device.getInfo(CL_DEVICE_LOCAL_MEM_SIZE, &size);
+    if(m_useSeparateQueues == false) {
+        return;
+    }
 
-    return size;
+    queue.flush();
+    buffer.hasLastEvent = true;
+    if(event != nullptr) {
+        *event = buffer.lastEvent;
+    }
 }
 
 /**
- * @brief get size of the global memory on device
+ * @brief enqueue a kernel with the worker-dimensions of the data-object
  *
- * @return size of global memory on device, or 0 if no device is initialized
+ * @param data object with the worker-dimensions
+ * @param def kernel to run
+ * @param waitList optional list of events, which have to be finished before the kernel
+ * @param event optional pointer for the event of the kernel
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
  */
-uint64_t
-GpuInterface::getGlobalMemorySize()
+bool
+GpuInterface::enqueueKernel(GpuData &data,
+                            GpuData::KernelDef &def,
+                            const std::vector<cl::Event>* waitList,
+                            cl::Event* event,
+                            ErrorContainer &error)
 {
-    // get information
-    cl_ulong size = 0;
-    m_device.getInfo(CL_DEVICE_GLOBAL_MEM_SIZE, &size);
+    cl::NDRange globalRange;
+    cl::NDRange localRange;
+    cl::NDRange offsetRange;
+    convertRanges(data, globalRange, localRange, offsetRange);
 
-    return size;
+    try
+    {
+        if(m_useSeparateQueues)
+        {
+            // wait for all transfers and kernels, which are using the same buffers
+            waitList = prepareWaitList(waitList, def.boundBuffers.data(), def.boundBuffers.size());
+
+            cl::CommandQueue &queue = m_computeQueues[m_nextComputeQueue];
+            m_nextComputeQueue = (m_nextComputeQueue + 1) % m_computeQueues.size();
+
+            cl::Event kernelEvent;
+            const cl_int ret = queue.enqueueNDRangeKernel(def.kernel,
+                                                          offsetRange,
+                                                          globalRange,
+                                                          localRange,
+                                                          waitList,
+                                                          &kernelEvent);
+            if(ret != CL_SUCCESS)
+            {
+                error.addMeesage("GPU-kernel failed with return-value: " + std::to_string(ret));
+                return false;
+            }
+            queue.flush();
+            recordOperation("run", PROFILE_KERNEL, def.id, 0, &kernelEvent);
+
+            for(GpuData::WorkerBuffer* buffer : def.boundBuffers)
+            {
+                buffer->lastEvent = kernelEvent;
+                buffer->hasLastEvent = true;
+            }
+            if(event != nullptr) {
+                *event = kernelEvent;
+            }
+        }
+        else
+        {
+            // the profiler and the tracer require an event of each kernel
+            if(event == nullptr && m_recordOperations) {
+                event = getProfilingEvent();
+            }
+
+            // launch kernel on the device
+            const cl_int ret = getQueue().enqueueNDRangeKernel(def.kernel,
+                                                               offsetRange,
+                                                               globalRange,
+                                                               localRange,
+                                                               waitList,
+                                                               event);
+            if(ret != CL_SUCCESS)
+            {
+                error.addMeesage("GPU-kernel failed with return-value: " + std::to_string(ret));
+                return false;
+            }
+            recordOperation("run", PROFILE_KERNEL, def.id, 0, event);
+        }
+    }
+    catch(const cl::Error &err)
+    {
+        error.addMeesage("OpenCL error: "
+                         + std::string(err.what())
+                         + "("
+                         + std::to_string(err.err())
+                         + ")");
+        return false;
+    }
+
+    return true;
 }
 
 /**
- * @brief get maximum memory size, which can be allocated at one time on device
+ * @brief convert the worker-dimensions of a data-object into the ranges for a kernel-run
  *
- * @return maximum at one time allocatable size, or 0 if no device is initialized
+ * @param data data-object with the worker-dimensions
+ * @param globalRange reference for the total number of threads
+ * @param localRange reference for the number of threads per work-group
+ * @param offsetRange reference for the offset, which is a null-range without offset
  */
-uint64_t
-GpuInterface::getMaxMemAllocSize()
+void
+GpuInterface::convertRanges(const GpuData &data,
+                            cl::NDRange &globalRange,
+                            cl::NDRange &localRange,
+                            cl::NDRange &offsetRange)
 {
-    // get information
-    cl_ulong size = 0;
-    m_device.getInfo(CL_DEVICE_MAX_MEM_ALLOC_SIZE, &size);
+    globalRange = cl::NDRange(data.numberOfWg.x * data.threadsPerWg.x,
+                              data.numberOfWg.y * data.threadsPerWg.y,
+                              data.numberOfWg.z * data.threadsPerWg.z);
+    localRange = cl::NDRange(data.threadsPerWg.x,
+                             data.threadsPerWg.y,
+                             data.threadsPerWg.z);
+    offsetRange = cl::NullRange;
+    if(data.globalOffset.x != 0
+            || data.globalOffset.y != 0
+            || data.globalOffset.z != 0)
+    {
+        offsetRange = cl::NDRange(data.globalOffset.x,
+                                  data.globalOffset.y,
+                                  data.globalOffset.z);
+    }
+}
 
-    return size;
+/**
+ * @brief combine a given wait-list with the last events of the buffers, which are used by the
+ *        next operation. Only necessary for separate queues, because there is no implicit order
+ *        between the queues.
+ *
+ * @param waitList optional wait-list given by the caller
+ * @param buffers list of buffers used by the next operation
+ * @param numberOfBuffers number of buffers in the list
+ *
+ * @return pointer to the combined wait-list, or nullptr if there is nothing to wait for
+ */
+const std::vector<cl::Event>*
+GpuInterface::prepareWaitList(const std::vector<cl::Event>* waitList,
+                              GpuData::WorkerBuffer* const* buffers,
+                              const uint64_t numberOfBuffers)
+{
+    m_waitList.clear();
+    if(waitList != nullptr) {
+        m_waitList.insert(m_waitList.end(), waitList->begin(), waitList->end());
+    }
+
+    for(uint64_t i = 0; i < numberOfBuffers; i++)
+    {
+        if(buffers[i]->hasLastEvent) {
+            m_waitList.push_back(buffers[i]->lastEvent);
+        }
+    }
+
+    if(m_waitList.size() == 0) {
+        return nullptr;
+    }
+
+    return &m_waitList;
 }
 
 /**
- * @brief get maximum total number of work-items within a work-group
+ * @brief measure the duration of a kernel with the current work-group size of the data-object by
+ *        the profiling-information of the device
  *
- * @return maximum work-group size
+ * @param data data-object with the worker-dimensions
+ * @param def kernel, which should be measured
+ * @param queue queue with enabled profiling, which is only used for the measurement
+ * @param numberOfRuns number of measured runs
+ * @param duration reference for the resulting duration of all runs in nanoseconds
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
  */
-uint64_t
-GpuInterface::getMaxWorkGroupSize()
+bool
+GpuInterface::benchmarkKernel(GpuData &data,
+                              GpuData::KernelDef &def,
+                              cl::CommandQueue &queue,
+                              const uint32_t numberOfRuns,
+                              uint64_t &duration,
+                              ErrorContainer &error)
 {
-    // get information
-    size_t size = 0;
-    m_device.getInfo(CL_DEVICE_MAX_WORK_GROUP_SIZE, &size);
+    cl::NDRange globalRange;
+    cl::NDRange localRange;
+    cl::NDRange offsetRange;
+    convertRanges(data, globalRange, localRange, offsetRange);
 
-    return size;
+    try
+    {
+        // warm-up run, which is not measured
+        queue.enqueueNDRangeKernel(def.kernel, offsetRange, globalRange, localRange);
+
+        std::vector<cl::Event> events(numberOfRuns);
+        for(uint32_t i = 0; i < numberOfRuns; i++)
+        {
+            queue.enqueueNDRangeKernel(def.kernel,
+                                       offsetRange,
+                                       globalRange,
+                                       localRange,
+                                       nullptr,
+                                       &events[i]);
+        }
+        queue.finish();
+
+        duration = 0;
+        for(const cl::Event &event : events)
+        {
+            duration += event.getProfilingInfo<CL_PROFILING_COMMAND_END>()
+                        - event.getProfilingInfo<CL_PROFILING_COMMAND_START>();
+        }
+    }
+    catch(const cl::Error &err)
+    {
+        error.addMeesage("OpenCL error while measuring kernel: "
+                         + std::string(err.what())
+                         + "("
+                         + std::to_string(err.err())
+                         + ")");
+        return false;
+    }
+
+    return true;
 }
 
 /**
- * @brief get maximum size of all dimensions of work-items within a work-group
+ * @brief submit all enqueued operations of all queues to the device
  *
- * @return worker-dimension object
+ * @return true, if successful, else false
  */
-const WorkerDim
-GpuInterface::getMaxWorkItemSize()
+bool
+GpuInterface::flushQueues()
 {
-    // get information
-    size_t size[3];
-    m_device.getInfo(CL_DEVICE_MAX_WORK_ITEM_SIZES, &size);
+    // without queue there is nothing enqueued
+    if(m_isInit == false) {
+        return true;
+    }
 
-    // create result object
-    const uint64_t dimension = getMaxWorkItemDimension();
-    WorkerDim result;
-    if(dimension > 0) {
-        result.x = size[0];
+    if(m_queue.flush() != CL_SUCCESS) {
+        return false;
     }
-    if(dimension > 1) {
-        result.y = size[1];
+
+    if(m_useSeparateQueues)
+    {
+        if(m_uploadQueue.flush() != CL_SUCCESS
+                || m_downloadQueue.flush() != CL_SUCCESS)
+        {
+            return false;
+        }
+
+        for(cl::CommandQueue &queue : m_computeQueues)
+        {
+            if(queue.flush() != CL_SUCCESS) {
+                return false;
+            }
+        }
     }
-    if(dimension > 2) {
-        result.z = size[2];
+
+    std::shared_lock<std::shared_mutex> guard(m_threadQueueLock);
+    for(auto& [id, threadQueue] : m_threadQueues)
+    {
+        if(threadQueue.queue.flush() != CL_SUCCESS) {
+            return false;
+        }
     }
 
-    return result;
+    return true;
 }
 
 /**
- * @brief get maximaum dimension of items
+ * @brief block until all enqueued operations of all queues are finished
  *
- * @return number of dimensions
+ * @return true, if successful, else false
  */
-uint64_t
-GpuInterface::getMaxWorkItemDimension()
+bool
+GpuInterface::finishQueues()
 {
-    // get information
-    cl_uint size = 0;
-    m_device.getInfo(CL_DEVICE_MAX_WORK_ITEM_DIMENSIONS, &size);
+    // without queue there is nothing enqueued
+    if(m_isInit == false) {
+        return true;
+    }
 
-    return size;
+    if(m_queue.finish() != CL_SUCCESS) {
+        return false;
+    }
+
+    if(m_useSeparateQueues)
+    {
+        if(m_uploadQueue.finish() != CL_SUCCESS
+                || m_downloadQueue.finish() != CL_SUCCESS)
+        {
+            return false;
+        }
+
+        for(cl::CommandQueue &queue : m_computeQueues)
+        {
+            if(queue.finish() != CL_SUCCESS) {
+                return false;
+            }
+        }
+    }
+
+    std::shared_lock<std::shared_mutex> guard(m_threadQueueLock);
+    for(auto& [id, threadQueue] : m_threadQueues)
+    {
+        if(threadQueue.queue.finish() != CL_SUCCESS) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief block until the operations of the calling thread are finished. With per-thread queues
+ *        only the queue of the calling thread is finished and not the queues of all other threads,
+ *        which would block the caller until the work of all threads is done. Without per-thread
+ *        queues all queues are finished.
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuInterface::finishOwnQueue()
+{
+    if(m_usePerThreadQueues == false) {
+        return finishQueues();
+    }
+
+    // without queue there is nothing enqueued
+    if(m_isInit == false) {
+        return true;
+    }
+
+    return getQueue().finish() == CL_SUCCESS;
 }
 
 /**
@@ -0,0 +1,494 @@
+/**
+ * @file        gpu_job_scheduler.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include <libKitsunemimiOpencl/gpu_job_scheduler.h>
+
+#include <libKitsunemimiOpencl/gpu_interface.h>
+#include <libKitsunemimiCommon/logger.h>
+
+namespace Kitsunemimi
+{
+
+/**
+ * @brief constructor
+ *
+ * @param interfaces interfaces of all devices, which should process the jobs
+ */
+GpuJobScheduler::GpuJobScheduler(const std::vector<GpuInterface*> &interfaces)
+    : m_devices(interfaces.size())
+{
+    for(uint64_t i = 0; i < interfaces.size(); i++) {
+        m_devices[i].interface = interfaces.at(i);
+    }
+}
+
+/**
+ * @brief destructor
+ */
+GpuJobScheduler::~GpuJobScheduler()
+{
+    close();
+}
+
+/**
+ * @brief initialize scheduler by compiling the kernel on all devices and starting one
+ *        worker-thread for each device. The buffer of each job are bound to the kernel in the
+ *        order of the input-names, followed by the output-names.
+ *
+ * @param kernelName name of the kernel, which is executed for each job
+ * @param kernelCode source-code of the kernel
+ * @param inputNames names of the buffer, which are copied to the device for each run of a job
+ * @param outputNames names of the buffer, which are copied back to the host after each run
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuJobScheduler::init(const std::string &kernelName,
+                      const std::string &kernelCode,
+                      const std::vector<std::string> &inputNames,
+                      const std::vector<std::string> &outputNames,
+                      ErrorContainer &error)
+{
+    if(m_isInit)
+    {
+        error.addMeesage("job-scheduler is already initialized");
+        return false;
+    }
+
+    if(m_devices.size() == 0)
+    {
+        error.addMeesage("job-scheduler has no device");
+        return false;
+    }
+
+    // compile kernel only once for each device
+    for(Device &device : m_devices)
+    {
+        if(device.interface->addKernel(device.kernelData, kernelName, kernelCode, error) == false)
+        {
+            for(Device &compiledDevice : m_devices) {
+                compiledDevice.kernelData.clearKernel();
+            }
+            return false;
+        }
+    }
+
+    m_kernelName = kernelName;
+    m_inputNames = inputNames;
+    m_outputNames = outputNames;
+    m_stop = false;
+
+    for(uint64_t i = 0; i < m_devices.size(); i++) {
+        m_devices[i].thread = std::thread(&GpuJobScheduler::runWorker, this, i);
+    }
+
+    m_isInit = true;
+
+    return true;
+}
+
+/**
+ * @brief add a job to the queues. A job, which was already processed before, is always given to
+ *        the device, where its buffer are resident. New jobs are given to the device with the
+ *        shortest queue, but can be stolen by any other device, which has nothing to do. The
+ *        data-object must not be changed until the job is finished.
+ *
+ * @param data data-object with the buffer and worker-dimensions of the job
+ * @param error reference for error-output
+ *
+ * @return false, if not initialized or the job is still pending, else true
+ */
+bool
+GpuJobScheduler::submit(GpuData &data,
+                        ErrorContainer &error)
+{
+    if(m_isInit == false)
+    {
+        error.addMeesage("job-scheduler is not initialized");
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+
+        Job &job = m_jobs[&data];
+        if(job.isPending)
+        {
+            error.addMeesage("job is still pending");
+            return false;
+        }
+
+        job.data = &data;
+        job.isPending = true;
+        job.success = true;
+        job.error = ErrorContainer();
+
+        // keep job on the device, where its buffer are
+        uint64_t target = 0;
+        if(job.deviceId != -1)
+        {
+            target = static_cast<uint64_t>(job.deviceId);
+        }
+        else
+        {
+            for(uint64_t i = 1; i < m_devices.size(); i++)
+            {
+                if(m_devices[i].queue.size() < m_devices[target].queue.size()) {
+                    target = i;
+                }
+            }
+        }
+
+        m_devices[target].queue.push_back(&job);
+        m_numberOfPendingJobs++;
+    }
+
+    m_workAvailable.notify_all();
+
+    return true;
+}
+
+/**
+ * @brief block until all submitted jobs are finished
+ *
+ * @param error reference for error-output
+ *
+ * @return false, if at least one job failed since the last call, else true
+ */
+bool
+GpuJobScheduler::waitForAll(ErrorContainer &error)
+{
+    std::unique_lock<std::mutex> lock(m_lock);
+    m_jobFinished.wait(lock, [this]{ return m_numberOfPendingJobs == 0; });
+
+    bool result = true;
+    for(auto& [data, job] : m_jobs)
+    {
+        if(job.success == false)
+        {
+            error.addMeesage("job failed: " + job.error.toString());
+            job.success = true;
+            result = false;
+        }
+    }
+
+    return result;
+}
+
+/**
+ * @brief wait for all pending jobs, stop the worker-threads and free the buffer of all jobs on
+ *        the devices
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuJobScheduler::close()
+{
+    if(m_isInit == false) {
+        return true;
+    }
+
+    ErrorContainer error;
+    waitForAll(error);
+
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_stop = true;
+    }
+    m_workAvailable.notify_all();
+
+    for(Device &device : m_devices)
+    {
+        if(device.thread.joinable()) {
+            device.thread.join();
+        }
+    }
+
+    // the worker-threads are stopped, so the interfaces can be used by this thread
+    bool result = true;
+    for(auto& [data, job] : m_jobs)
+    {
+        if(job.deviceId == -1) {
+            continue;
+        }
+
+        if(m_devices[job.deviceId].interface->closeDevice(*data) == false) {
+            result = false;
+        }
+        data->clearKernel();
+    }
+    m_jobs.clear();
+
+    for(Device &device : m_devices)
+    {
+        device.kernelData.clearKernel();
+        device.queue.clear();
+        device.numberOfProcessedJobs = 0;
+    }
+
+    m_numberOfStolenJobs = 0;
+    m_isInit = false;
+
+    return result;
+}
+
+/**
+ * @brief get device, where the buffer of a job are resident
+ *
+ * @param data data-object of the job
+ *
+ * @return position of the device in the list given to the constructor, or -1 if the job was
+ *         not processed until now
+ */
+int64_t
+GpuJobScheduler::getDeviceOfJob(GpuData &data)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    std::map<GpuData*, Job>::const_iterator it;
+    it = m_jobs.find(&data);
+    if(it == m_jobs.end()) {
+        return -1;
+    }
+
+    return it->second.deviceId;
+}
+
+/**
+ * @brief get number of jobs, which were processed by a device
+ *
+ * @param deviceId position of the device in the list given to the constructor
+ *
+ * @return number of jobs, or 0 if the id is invalid
+ */
+uint64_t
+GpuJobScheduler::getNumberOfProcessedJobs(const uint64_t deviceId)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    if(deviceId >= m_devices.size()) {
+        return 0;
+    }
+
+    return m_devices[deviceId].numberOfProcessedJobs;
+}
+
+/**
+ * @brief get number of jobs, which were taken from the queue of another device
+ *
+ * @return number of stolen jobs
+ */
+uint64_t
+GpuJobScheduler::getNumberOfStolenJobs()
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    return m_numberOfStolenJobs;
+}
+
+/**
+ * @brief loop of the worker-thread of a device
+ *
+ * @param deviceId position of the device in the list given to the constructor
+ */
+void
+GpuJobScheduler::runWorker(const uint64_t deviceId)
+{
+    while(true)
+    {
+        Job* job = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(m_lock);
+            m_workAvailable.wait(lock, [&]{
+                job = takeJob(deviceId);
+                return job != nullptr || m_stop;
+            });
+        }
+
+        // the worker is stopped, so its queue is not necessary anymore
+        if(job == nullptr)
+        {
+            m_devices[deviceId].interface->releaseThreadQueue();
+            return;
+        }
+
+        const bool success = processJob(deviceId, *job);
+
+        {
+            std::lock_guard<std::mutex> guard(m_lock);
+            job->success = success;
+            job->isPending = false;
+            m_devices[deviceId].numberOfProcessedJobs++;
+            m_numberOfPendingJobs--;
+        }
+        m_jobFinished.notify_all();
+    }
+}
+
+/**
+ * @brief get next job for a device. The own queue is processed from the front. If it is empty,
+ *        a job, which is not resident on any device, is stolen from the back of the queue of
+ *        another device. Must be called with locked mutex.
+ *
+ * @param deviceId position of the device in the list given to the constructor
+ *
+ * @return pointer to the job, or nullptr if there is nothing to do
+ */
+GpuJobScheduler::Job*
+GpuJobScheduler::takeJob(const uint64_t deviceId)
+{
+    std::deque<Job*> &ownQueue = m_devices[deviceId].queue;
+    if(ownQueue.size() > 0)
+    {
+        Job* job = ownQueue.front();
+        ownQueue.pop_front();
+        return job;
+    }
+
+    for(uint64_t i = 1; i < m_devices.size(); i++)
+    {
+        std::deque<Job*> &otherQueue = m_devices[(deviceId + i) % m_devices.size()].queue;
+        for(auto it = otherQueue.rbegin(); it != otherQueue.rend(); it++)
+        {
+            // jobs with resident buffer are never moved to another device
+            if((*it)->deviceId != -1) {
+                continue;
+            }
+
+            Job* job = *it;
+            otherQueue.erase(std::next(it).base());
+            m_numberOfStolenJobs++;
+            return job;
+        }
+    }
+
+    return nullptr;
+}
+
+/**
+ * @brief run a job on a device. At the first run all buffer are copied to the device and stay
+ *        there, for all following runs only the input-buffer are updated.
+ *
+ * @param deviceId position of the device in the list given to the constructor
+ * @param job job to process
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuJobScheduler::processJob(const uint64_t deviceId,
+                            Job &job)
+{
+    GpuInterface* interface = m_devices[deviceId].interface;
+    GpuData &data = *job.data;
+
+    if(job.deviceId == -1)
+    {
+        if(placeJob(deviceId, job) == false) {
+            return false;
+        }
+    }
+    else
+    {
+        for(const std::string &name : m_inputNames)
+        {
+            if(interface->updateBufferOnDevice(data, name, job.error) == false) {
+                return false;
+            }
+        }
+    }
+
+    if(interface->run(data, m_kernelName, job.error) == false) {
+        return false;
+    }
+
+    // copy is blocking, so the kernel is finished afterwards
+    for(const std::string &name : m_outputNames)
+    {
+        if(interface->copyFromDevice(data, name, job.error) == false) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief copy the buffer of a job to a device and bind them to the kernel of the device. If this
+ *        fails, the data-object is closed like with closeDevice, to not leave incomplete buffer
+ *        on the device.
+ *
+ * @param deviceId position of the device in the list given to the constructor
+ * @param job job, which should be placed on the device
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuJobScheduler::placeJob(const uint64_t deviceId,
+                          Job &job)
+{
+    GpuInterface* interface = m_devices[deviceId].interface;
+    GpuData &data = *job.data;
+
+    if(data.containsKernel(m_kernelName))
+    {
+        job.error.addMeesage("data-object of the job already contains the kernel '"
+                             + m_kernelName
+                             + "'");
+        return false;
+    }
+
+    if(interface->initCopyToDevice(data, job.error) == false)
+    {
+        interface->closeDevice(data);
+        return false;
+    }
+
+    // create kernel from the program, which was already compiled for the device
+    GpuData::KernelDef def;
+    def.id = m_kernelName;
+    def.kernelCode = m_devices[deviceId].kernelData.getKernel(m_kernelName)->kernelCode;
+    def.program = m_devices[deviceId].kernelData.getKernel(m_kernelName)->program;
+    def.kernel = cl::Kernel(def.program, m_kernelName.c_str());
+    data.insertKernel(m_kernelName, def);
+
+    bool success = true;
+    for(const std::string &name : m_inputNames) {
+        success = success && interface->bindKernelToBuffer(data, m_kernelName, name, job.error);
+    }
+    for(const std::string &name : m_outputNames) {
+        success = success && interface->bindKernelToBuffer(data, m_kernelName, name, job.error);
+    }
+
+    if(success == false)
+    {
+        interface->closeDevice(data);
+        data.clearKernel();
+        return false;
+    }
+
+    std::lock_guard<std::mutex> guard(m_lock);
+    job.deviceId = static_cast<int64_t>(deviceId);
+
+    return true;
+}
+
+}
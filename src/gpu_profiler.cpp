@@ -0,0 +1,200 @@
+/**
+ * @file        gpu_profiler.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include <libKitsunemimiOpencl/gpu_profiler.h>
+
+#include <algorithm>
+
+#include <event_helper.h>
+
+namespace Kitsunemimi
+{
+
+GpuProfiler::GpuProfiler() {}
+
+/**
+ * @brief register the event of an enqueued operation. The profiling-information can only be read
+ *        after the operation is finished, so the event is only stored here and evaluated later.
+ *
+ * @param type type of the operation
+ * @param name name of the kernel or buffer
+ * @param numberOfBytes number of transfered bytes (0 for kernels)
+ * @param event event of the operation, which must come from a queue with profiling enabled
+ */
+void
+GpuProfiler::addEvent(const ProfilingType type,
+                      const std::string &name,
+                      const uint64_t numberOfBytes,
+                      const cl::Event &event)
+{
+    PendingEvent pendingEvent;
+    pendingEvent.type = type;
+    pendingEvent.name = name;
+    pendingEvent.numberOfBytes = numberOfBytes;
+    pendingEvent.event = event;
+
+    m_pendingEvents.push_back(pendingEvent);
+
+    // limit the number of pending events by evaluating the oldest ones, which are most likely
+    // already finished, instead of checking all pending events for each new one
+    if(m_pendingEvents.size() >= 1024)
+    {
+        evaluatePendingEvents(m_pendingEvents, true,
+                              [this](PendingEvent &entry, const cl_int status) {
+                                  addMeasurement(entry, status);
+                              });
+    }
+}
+
+/**
+ * @brief read the profiling-information of all finished operations and add them to the
+ *        measurements. Events of unfinished operations are kept for the next update.
+ */
+void
+GpuProfiler::update()
+{
+    evaluatePendingEvents(m_pendingEvents, false,
+                          [this](PendingEvent &entry, const cl_int status) {
+                              addMeasurement(entry, status);
+                          });
+}
+
+/**
+ * @brief add the profiling-information of a finished operation to the measurements
+ *
+ * @param pendingEvent finished operation
+ * @param status execution-status of the operation, where failed operations are dropped
+ */
+void
+GpuProfiler::addMeasurement(const PendingEvent &pendingEvent,
+                            const cl_int status)
+{
+    if(status < CL_COMPLETE) {
+        return;
+    }
+
+    try
+    {
+        const cl::Event &event = pendingEvent.event;
+        const uint64_t queued = event.getProfilingInfo<CL_PROFILING_COMMAND_QUEUED>();
+        const uint64_t submit = event.getProfilingInfo<CL_PROFILING_COMMAND_SUBMIT>();
+        const uint64_t start = event.getProfilingInfo<CL_PROFILING_COMMAND_START>();
+        const uint64_t end = event.getProfilingInfo<CL_PROFILING_COMMAND_END>();
+
+        Measurements &measurements = m_measurements[pendingEvent.type][pendingEvent.name];
+        measurements.durations.push_back(end - start);
+        measurements.submitDelaySum += submit - queued;
+        measurements.startDelaySum += start - queued;
+        measurements.numberOfBytes += pendingEvent.numberOfBytes;
+    }
+    catch(const cl::Error &) {}
+}
+
+/**
+ * @brief get statistics of all finished operations of a kernel or buffer. Operations, which are
+ *        not evaluated by update, are not included.
+ *
+ * @param type type of the operations
+ * @param name name of the kernel or buffer
+ * @param stats reference for the resulting statistics
+ *
+ * @return false, if there are no measurements for the name, else true
+ */
+bool
+GpuProfiler::getStats(const ProfilingType type,
+                      const std::string &name,
+                      ProfilingStats &stats) const
+{
+    std::map<std::string, Measurements>::const_iterator it;
+    it = m_measurements[type].find(name);
+    if(it == m_measurements[type].end()
+            || it->second.durations.size() == 0)
+    {
+        return false;
+    }
+
+    const Measurements &measurements = it->second;
+    std::vector<uint64_t> sorted = measurements.durations;
+    std::sort(sorted.begin(), sorted.end());
+
+    uint64_t sum = 0;
+    for(const uint64_t duration : sorted) {
+        sum += duration;
+    }
+
+    // percentiles by nearest rank
+    const uint64_t count = sorted.size();
+    const uint64_t p50Pos = (count * 50 + 99) / 100;
+    const uint64_t p99Pos = (count * 99 + 99) / 100;
+
+    stats.count = count;
+    stats.numberOfBytes = measurements.numberOfBytes;
+    stats.minTime = static_cast<double>(sorted.front()) / 1000.0;
+    stats.meanTime = (static_cast<double>(sum) / static_cast<double>(count)) / 1000.0;
+    stats.p50Time = static_cast<double>(sorted.at(p50Pos - 1)) / 1000.0;
+    stats.p99Time = static_cast<double>(sorted.at(p99Pos - 1)) / 1000.0;
+    stats.meanSubmitDelay = (static_cast<double>(measurements.submitDelaySum)
+                             / static_cast<double>(count)) / 1000.0;
+    stats.meanStartDelay = (static_cast<double>(measurements.startDelaySum)
+                            / static_cast<double>(count)) / 1000.0;
+
+    stats.bytesPerSecond = 0.0;
+    if(sum > 0)
+    {
+        stats.bytesPerSecond = static_cast<double>(measurements.numberOfBytes)
+                               / (static_cast<double>(sum) / 1000000000.0);
+    }
+
+    return true;
+}
+
+/**
+ * @brief get names of all kernels or buffer with measurements
+ *
+ * @param type type of the operations
+ *
+ * @return list of names
+ */
+const std::vector<std::string>
+GpuProfiler::getNames(const ProfilingType type) const
+{
+    std::vector<std::string> result;
+    for(const auto& [name, measurements] : m_measurements[type]) {
+        result.push_back(name);
+    }
+
+    return result;
+}
+
+/**
+ * @brief remove all measurements and pending events
+ */
+void
+GpuProfiler::reset()
+{
+    m_pendingEvents.clear();
+    for(uint32_t i = 0; i < 3; i++) {
+        m_measurements[i].clear();
+    }
+}
+
+}
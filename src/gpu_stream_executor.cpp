@@ -0,0 +1,454 @@
+/**
+ * @file        gpu_stream_executor.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include <libKitsunemimiOpencl/gpu_stream_executor.h>
+
+#include <libKitsunemimiOpencl/gpu_interface.h>
+#include <libKitsunemimiCommon/logger.h>
+
+namespace Kitsunemimi
+{
+
+/**
+ * @brief constructor
+ *
+ * @param gpuInterface interface of the device, which should process the data
+ */
+GpuStreamExecutor::GpuStreamExecutor(GpuInterface* gpuInterface)
+{
+    m_interface = gpuInterface;
+}
+
+/**
+ * @brief destructor
+ */
+GpuStreamExecutor::~GpuStreamExecutor()
+{
+    close();
+}
+
+/**
+ * @brief register input-data, which are streamed to the device
+ *
+ * @param name name of the buffer
+ * @param data pointer to the data on the host
+ * @param numberOfObjects number of objects, which is equal for all buffers of the executor
+ * @param objectSize number of bytes of a single object
+ *
+ * @return false, if name already exist, executor is already initialized or the number of objects
+ *         doesn't match with the other buffers, else true
+ */
+bool
+GpuStreamExecutor::addInput(const std::string &name,
+                            const void* data,
+                            const uint64_t numberOfObjects,
+                            const uint64_t objectSize)
+{
+    return addBuffer(name, const_cast<void*>(data), numberOfObjects, objectSize, false);
+}
+
+/**
+ * @brief register output-buffer, into which the results are streamed back
+ *
+ * @param name name of the buffer
+ * @param data pointer to the target on the host
+ * @param numberOfObjects number of objects, which is equal for all buffers of the executor
+ * @param objectSize number of bytes of a single object
+ *
+ * @return false, if name already exist, executor is already initialized or the number of objects
+ *         doesn't match with the other buffers, else true
+ */
+bool
+GpuStreamExecutor::addOutput(const std::string &name,
+                             void* data,
+                             const uint64_t numberOfObjects,
+                             const uint64_t objectSize)
+{
+    return addBuffer(name, data, numberOfObjects, objectSize, true);
+}
+
+/**
+ * @brief initialize executor by creating the chunk-buffer on the device and compile the kernel.
+ *        The buffer are bound to the kernel in the order, in which they were added. Each
+ *        work-item of the kernel processes the object get_global_id(0) of each buffer within the
+ *        current chunk. The last chunk is padded, so the kernel doesn't need a range-check.
+ *        The executor doesn't change the queue-configuration of the interface. Transfers and
+ *        kernels are only overlapping, if separate queues were enabled on the interface before,
+ *        else all chunks are processed one after another by the single queue.
+ *
+ * @param kernelName name of the kernel
+ * @param kernelCode source-code of the kernel
+ * @param error reference for error-output
+ * @param chunkSize number of objects per chunk (0 = calculate from the available device-memory)
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuStreamExecutor::init(const std::string &kernelName,
+                        const std::string &kernelCode,
+                        ErrorContainer &error,
+                        const uint64_t chunkSize)
+{
+    if(m_isInit)
+    {
+        error.addMeesage("stream-executor is already initialized");
+        return false;
+    }
+
+    if(m_buffers.size() == 0)
+    {
+        error.addMeesage("stream-executor has no buffer");
+        return false;
+    }
+
+    // the buffer are created from the pool before the kernel is added, so the context of the
+    // interface must already exist
+    if(m_interface->initContext(error) == false) {
+        return false;
+    }
+
+    // get work-group size, which is used for all chunks
+    m_localSize = std::min(m_interface->getMaxWorkGroupSize(),
+                           m_interface->getMaxWorkItemSize().x);
+    m_localSize = std::min(m_localSize, static_cast<uint64_t>(256));
+
+    // get size of the chunks as multiple of the work-group size
+    if(chunkSize == 0)
+    {
+        m_chunkSize = calculateChunkSize();
+    }
+    else
+    {
+        m_chunkSize = chunkSize;
+        if(m_chunkSize % m_localSize != 0) {
+            m_chunkSize += m_localSize - (m_chunkSize % m_localSize);
+        }
+    }
+
+    if(m_chunkSize == 0)
+    {
+        error.addMeesage("not enough memory on the device for the stream-executor");
+        return false;
+    }
+
+    LOG_DEBUG("init stream-executor with chunks of "
+              + std::to_string(m_chunkSize)
+              + " objects");
+
+    for(GpuData &slot : m_slots)
+    {
+        slot.numberOfWg.x = m_chunkSize / m_localSize;
+        slot.threadsPerWg.x = m_localSize;
+
+        // the host-pointer of the buffer are moved over the data for each chunk and the buffer
+        // on the device are taken from the pool without initial copy, so no staging-memory is
+        // necessary
+        for(StreamBuffer &buffer : m_buffers)
+        {
+            slot.addBuffer(buffer.name, m_chunkSize, buffer.objectSize, false, buffer.data);
+            GpuData::WorkerBuffer* workerBuffer = slot.getBuffer(buffer.name);
+            if(m_interface->getBufferPool()->getDeviceBuffer(m_interface->m_context,
+                                                             workerBuffer->numberOfBytes,
+                                                             workerBuffer->clBuffer,
+                                                             error) == false)
+            {
+                error.addMeesage("failed to create buffer for stream-executor");
+                close();
+                return false;
+            }
+        }
+    }
+
+    // compile kernel only once and create the kernel of the second slot from the same program
+    if(m_interface->addKernel(m_slots[0], kernelName, kernelCode, error) == false)
+    {
+        close();
+        return false;
+    }
+
+    GpuData::KernelDef secondDef;
+    secondDef.id = kernelName;
+    secondDef.kernelCode = kernelCode;
+    secondDef.program = m_slots[0].getKernel(kernelName)->program;
+    secondDef.kernel = cl::Kernel(secondDef.program, kernelName.c_str());
+    m_slots[1].insertKernel(kernelName, secondDef);
+
+    for(GpuData &slot : m_slots)
+    {
+        for(StreamBuffer &buffer : m_buffers)
+        {
+            if(m_interface->bindKernelToBuffer(slot, kernelName, buffer.name, error) == false)
+            {
+                close();
+                return false;
+            }
+        }
+    }
+
+    m_kernelName = kernelName;
+    m_isInit = true;
+
+    return true;
+}
+
+/**
+ * @brief stream all data through the device. While one chunk is processed by the kernel, the
+ *        next chunk is uploaded and the results of the previous chunk are downloaded. The upload
+ *        of the next chunk is enqueued before the download of the current chunk, so it doesn't
+ *        have to wait for the kernel of the current chunk.
+ *
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuStreamExecutor::run(ErrorContainer &error)
+{
+    if(m_isInit == false)
+    {
+        error.addMeesage("stream-executor is not initialized");
+        return false;
+    }
+
+    std::vector<GpuEvent> events;
+
+    if(uploadChunk(0, error) == false) {
+        return false;
+    }
+
+    for(uint64_t chunk = 0; chunk < getNumberOfChunks(); chunk++)
+    {
+        GpuData &slot = m_slots[chunk % 2];
+        const uint64_t offset = chunk * m_chunkSize;
+        const uint64_t count = std::min(m_chunkSize, m_numberOfObjects - offset);
+
+        // process chunk
+        GpuEvent runEvent;
+        if(m_interface->runAsync(slot, m_kernelName, runEvent, error) == false) {
+            return false;
+        }
+
+        // upload next chunk into the other slot, while the current chunk is processed
+        if(chunk + 1 < getNumberOfChunks()
+                && uploadChunk(chunk + 1, error) == false)
+        {
+            return false;
+        }
+
+        // download only the valid part of the output
+        for(StreamBuffer &buffer : m_buffers)
+        {
+            if(buffer.isOutput == false) {
+                continue;
+            }
+
+            events.emplace_back();
+            if(m_interface->copyFromDeviceAsync(slot, buffer.name, events.back(), error, count)
+                    == false)
+            {
+                return false;
+            }
+        }
+    }
+
+    if(GpuEvent::waitForAll(events) == false)
+    {
+        error.addMeesage("stream-executor failed while waiting for the results");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief move the host-pointer of the slot of a chunk to the data of the chunk and upload the
+ *        input of the chunk. The upload waits for the last kernel on the same slot by the events
+ *        of the buffer.
+ *
+ * @param chunk number of the chunk
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuStreamExecutor::uploadChunk(const uint64_t chunk,
+                               ErrorContainer &error)
+{
+    GpuData &slot = m_slots[chunk % 2];
+    const uint64_t offset = chunk * m_chunkSize;
+    const uint64_t count = std::min(m_chunkSize, m_numberOfObjects - offset);
+
+    // move host-pointer to the chunk, which doesn't affect already enqueued downloads of the slot
+    for(StreamBuffer &buffer : m_buffers) {
+        slot.getBuffer(buffer.name)->data = buffer.data + offset * buffer.objectSize;
+    }
+
+    for(StreamBuffer &buffer : m_buffers)
+    {
+        if(buffer.isOutput) {
+            continue;
+        }
+
+        GpuEvent event;
+        if(m_interface->updateBufferOnDeviceAsync(slot, buffer.name, event, error, count)
+                == false)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief free the buffer on the device
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuStreamExecutor::close()
+{
+    bool result = true;
+    for(GpuData &slot : m_slots)
+    {
+        if(m_interface->closeDevice(slot) == false) {
+            result = false;
+        }
+        slot.clearKernel();
+    }
+
+    m_isInit = false;
+
+    return result;
+}
+
+/**
+ * @brief get number of objects, which are processed by one kernel-run
+ *
+ * @return chunk-size
+ */
+uint64_t
+GpuStreamExecutor::getChunkSize() const
+{
+    return m_chunkSize;
+}
+
+/**
+ * @brief get number of chunks, which are necessary to process all data
+ *
+ * @return number of chunks
+ */
+uint64_t
+GpuStreamExecutor::getNumberOfChunks() const
+{
+    if(m_chunkSize == 0) {
+        return 0;
+    }
+
+    return (m_numberOfObjects + m_chunkSize - 1) / m_chunkSize;
+}
+
+/**
+ * @brief register new buffer
+ *
+ * @param name name of the buffer
+ * @param data pointer to the data on the host
+ * @param numberOfObjects number of objects
+ * @param objectSize number of bytes of a single object
+ * @param isOutput true, if results are written into the buffer
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuStreamExecutor::addBuffer(const std::string &name,
+                             void* data,
+                             const uint64_t numberOfObjects,
+                             const uint64_t objectSize,
+                             const bool isOutput)
+{
+    // precheck
+    if(m_isInit
+            || data == nullptr
+            || numberOfObjects == 0
+            || objectSize == 0)
+    {
+        return false;
+    }
+
+    // all buffer must have the same number of objects
+    if(m_buffers.size() > 0
+            && m_numberOfObjects != numberOfObjects)
+    {
+        return false;
+    }
+
+    for(const StreamBuffer &buffer : m_buffers)
+    {
+        if(buffer.name == name) {
+            return false;
+        }
+    }
+
+    StreamBuffer newBuffer;
+    newBuffer.name = name;
+    newBuffer.data = static_cast<uint8_t*>(data);
+    newBuffer.objectSize = objectSize;
+    newBuffer.isOutput = isOutput;
+    m_buffers.push_back(newBuffer);
+
+    m_numberOfObjects = numberOfObjects;
+
+    return true;
+}
+
+/**
+ * @brief calculate number of objects per chunk based on the memory of the device
+ *
+ * @return number of objects per chunk, or 0 if the device-memory is too small
+ */
+uint64_t
+GpuStreamExecutor::calculateChunkSize()
+{
+    uint64_t bytesPerObject = 0;
+    uint64_t maxObjectSize = 0;
+    for(const StreamBuffer &buffer : m_buffers)
+    {
+        bytesPerObject += buffer.objectSize;
+        maxObjectSize = std::max(maxObjectSize, buffer.objectSize);
+    }
+
+    // use at most the half of the global memory for both slots, to leave space for other data
+    // on the device, and respect the maximum size of a single allocation
+    uint64_t chunkSize = (m_interface->getGlobalMemorySize() / 2) / (2 * bytesPerObject);
+    chunkSize = std::min(chunkSize, m_interface->getMaxMemAllocSize() / maxObjectSize);
+
+    // no chunk bigger than the data itself
+    uint64_t paddedNumberOfObjects = m_numberOfObjects;
+    if(paddedNumberOfObjects % m_localSize != 0) {
+        paddedNumberOfObjects += m_localSize - (paddedNumberOfObjects % m_localSize);
+    }
+    chunkSize = std::min(chunkSize, paddedNumberOfObjects);
+
+    return chunkSize - (chunkSize % m_localSize);
+}
+
+}
@@ -0,0 +1,258 @@
+/**
+ * @file        gpu_tracer.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include <libKitsunemimiOpencl/gpu_tracer.h>
+
+#include <fstream>
+#include <sstream>
+
+#include <event_helper.h>
+
+namespace Kitsunemimi
+{
+
+/**
+ * @brief constructor. All host-times of the trace are relative to the creation of the tracer.
+ */
+GpuTracer::GpuTracer()
+{
+    m_startTime = std::chrono::steady_clock::now();
+}
+
+/**
+ * @brief register an enqueued operation. The device-times can only be read after the operation
+ *        is finished, so the event is only stored here and evaluated later.
+ *
+ * @param operation name of the operation
+ * @param type type of the operation
+ * @param name name of the kernel or buffer
+ * @param numberOfBytes number of transfered bytes (0 for kernels)
+ * @param event event of the operation, which must come from a queue with profiling enabled
+ */
+void
+GpuTracer::addEvent(const char* operation,
+                    const ProfilingType type,
+                    const std::string &name,
+                    const uint64_t numberOfBytes,
+                    const cl::Event &event)
+{
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+    TraceEvent traceEvent;
+    traceEvent.operation = operation;
+    traceEvent.type = type;
+    traceEvent.name = name;
+    traceEvent.numberOfBytes = numberOfBytes;
+    traceEvent.event = event;
+    traceEvent.enqueueTime = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                 now - m_startTime).count();
+
+    m_pendingEvents.push_back(traceEvent);
+
+    // limit the number of pending events in the same way like the profiler
+    if(m_pendingEvents.size() >= 1024)
+    {
+        evaluatePendingEvents(m_pendingEvents, true,
+                              [this](TraceEvent &entry, const cl_int status) {
+                                  finishEvent(entry, status);
+                              });
+    }
+}
+
+/**
+ * @brief read the device-times of all finished operations. Events of unfinished operations are
+ *        kept for the next update.
+ */
+void
+GpuTracer::update()
+{
+    evaluatePendingEvents(m_pendingEvents, false,
+                          [this](TraceEvent &entry, const cl_int status) {
+                              finishEvent(entry, status);
+                          });
+}
+
+/**
+ * @brief read the device-times of a finished operation and move it to the finished events
+ *
+ * @param traceEvent finished operation
+ * @param status execution-status of the operation
+ */
+void
+GpuTracer::finishEvent(TraceEvent &traceEvent,
+                       const cl_int status)
+{
+    // failed operations are kept in the trace without device-times
+    if(status < CL_COMPLETE) {
+        traceEvent.failed = true;
+    }
+    else
+    {
+        try
+        {
+            const cl::Event &event = traceEvent.event;
+            const uint64_t queued = event.getProfilingInfo<CL_PROFILING_COMMAND_QUEUED>();
+            const uint64_t submit = event.getProfilingInfo<CL_PROFILING_COMMAND_SUBMIT>();
+            const uint64_t start = event.getProfilingInfo<CL_PROFILING_COMMAND_START>();
+            const uint64_t end = event.getProfilingInfo<CL_PROFILING_COMMAND_END>();
+
+            traceEvent.submitDelay = submit - queued;
+            traceEvent.startDelay = start - queued;
+            traceEvent.duration = end - start;
+        }
+        catch(const cl::Error &)
+        {
+            traceEvent.failed = true;
+        }
+    }
+
+    // release the event, because it is not necessary anymore
+    traceEvent.event = cl::Event();
+    m_finishedEvents.push_back(traceEvent);
+}
+
+/**
+ * @brief get number of finished and pending events of the trace
+ *
+ * @return number of events
+ */
+uint64_t
+GpuTracer::getNumberOfEvents() const
+{
+    return m_pendingEvents.size() + m_finishedEvents.size();
+}
+
+/**
+ * @brief write all finished operations as trace-event-json, which can be loaded by
+ *        chrome://tracing or Perfetto. The enqueue of each operation is shown as instant-event on
+ *        the host and the execution as slice on the device. The device-times are placed on the
+ *        host-timeline by the delay between enqueue and start, because device- and host-clock
+ *        have different origins.
+ *
+ * @param filePath path of the file to write
+ * @param error reference for error-output
+ *
+ * @return false, if the file could not be written, else true
+ */
+bool
+GpuTracer::writeTrace(const std::string &filePath,
+                      ErrorContainer &error)
+{
+    std::ostringstream output;
+    output.precision(3);
+    output<<std::fixed;
+
+    output<<"{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+
+    // names of the timelines
+    output<<"{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,\"args\":{\"name\":\"host\"}},\n";
+    output<<"{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"device\"}},\n";
+    output<<"{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,"
+            "\"args\":{\"name\":\"kernels\"}},\n";
+    output<<"{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,"
+            "\"args\":{\"name\":\"transfers\"}}";
+
+    for(const TraceEvent &traceEvent : m_finishedEvents)
+    {
+        const std::string name = escape(traceEvent.name);
+        const std::string label = std::string(traceEvent.operation) + " " + name;
+        const double enqueueTime = static_cast<double>(traceEvent.enqueueTime) / 1000.0;
+        const uint32_t tid = traceEvent.type == PROFILE_KERNEL ? 0 : 1;
+
+        // enqueue on the host
+        output<<",\n{\"name\":\""<<label<<"\",\"cat\":\"enqueue\",\"ph\":\"i\",\"s\":\"t\","
+              <<"\"pid\":0,\"tid\":0,\"ts\":"<<enqueueTime<<"}";
+
+        if(traceEvent.failed) {
+            continue;
+        }
+
+        // execution on the device
+        const double startTime = enqueueTime + static_cast<double>(traceEvent.startDelay) / 1000.0;
+        output<<",\n{\"name\":\""<<label<<"\",\"cat\":\""
+              <<(traceEvent.type == PROFILE_KERNEL ? "kernel" : "transfer")<<"\","
+              <<"\"ph\":\"X\",\"pid\":1,\"tid\":"<<tid<<","
+              <<"\"ts\":"<<startTime<<","
+              <<"\"dur\":"<<static_cast<double>(traceEvent.duration) / 1000.0<<","
+              <<"\"args\":{\"name\":\""<<name<<"\","
+              <<"\"bytes\":"<<traceEvent.numberOfBytes<<","
+              <<"\"enqueue_us\":"<<enqueueTime<<","
+              <<"\"submit_delay_us\":"<<static_cast<double>(traceEvent.submitDelay) / 1000.0<<","
+              <<"\"start_delay_us\":"<<static_cast<double>(traceEvent.startDelay) / 1000.0<<"}}";
+    }
+
+    output<<"\n]}\n";
+
+    std::ofstream file(filePath, std::ios::out | std::ios::trunc);
+    if(file.is_open() == false)
+    {
+        error.addMeesage("failed to open trace-file '" + filePath + "'");
+        return false;
+    }
+
+    file<<output.str();
+    file.close();
+    if(file.fail())
+    {
+        error.addMeesage("failed to write trace-file '" + filePath + "'");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief remove all events of the trace
+ */
+void
+GpuTracer::clear()
+{
+    m_pendingEvents.clear();
+    m_finishedEvents.clear();
+}
+
+/**
+ * @brief escape a string for the usage within a json-string
+ *
+ * @param input string to escape
+ *
+ * @return escaped string
+ */
+const std::string
+GpuTracer::escape(const std::string &input) const
+{
+    std::string result;
+    for(const char c : input)
+    {
+        if(c == '"' || c == '\\') {
+            result.push_back('\\');
+        }
+        if(static_cast<uint8_t>(c) < 0x20) {
+            continue;
+        }
+        result.push_back(c);
+    }
+
+    return result;
+}
+
+}
@@ -0,0 +1,626 @@
+/**
+ * @file        gpu_work_splitter.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include <libKitsunemimiOpencl/gpu_work_splitter.h>
+
+#include <libKitsunemimiOpencl/gpu_interface.h>
+#include <libKitsunemimiCommon/logger.h>
+
+#include <thread>
+#include <chrono>
+
+namespace Kitsunemimi
+{
+
+/**
+ * @brief constructor
+ *
+ * @param interfaces interfaces of all devices, which should share the work
+ */
+GpuWorkSplitter::GpuWorkSplitter(const std::vector<GpuInterface*> &interfaces)
+    : m_parts(interfaces.size())
+{
+    for(uint64_t i = 0; i < interfaces.size(); i++) {
+        m_parts[i].interface = interfaces.at(i);
+    }
+}
+
+/**
+ * @brief destructor
+ */
+GpuWorkSplitter::~GpuWorkSplitter()
+{
+    close();
+}
+
+/**
+ * @brief register input-data, which are split over all devices
+ *
+ * @param name name of the buffer
+ * @param data pointer to the data on the host
+ * @param numberOfObjects number of objects, which is equal for all buffers of the splitter
+ * @param objectSize number of bytes of a single object
+ *
+ * @return false, if name already exist, splitter is already initialized or the number of objects
+ *         doesn't match with the other buffers, else true
+ */
+bool
+GpuWorkSplitter::addInput(const std::string &name,
+                          const void* data,
+                          const uint64_t numberOfObjects,
+                          const uint64_t objectSize)
+{
+    return addBuffer(name, const_cast<void*>(data), numberOfObjects, objectSize, false);
+}
+
+/**
+ * @brief register output-buffer, into which the results of all devices are gathered
+ *
+ * @param name name of the buffer
+ * @param data pointer to the target on the host
+ * @param numberOfObjects number of objects, which is equal for all buffers of the splitter
+ * @param objectSize number of bytes of a single object
+ *
+ * @return false, if name already exist, splitter is already initialized or the number of objects
+ *         doesn't match with the other buffers, else true
+ */
+bool
+GpuWorkSplitter::addOutput(const std::string &name,
+                           void* data,
+                           const uint64_t numberOfObjects,
+                           const uint64_t objectSize)
+{
+    return addBuffer(name, data, numberOfObjects, objectSize, true);
+}
+
+/**
+ * @brief initialize splitter by compiling the kernel on all devices, measuring the throughput of
+ *        each device and creating the buffer for the partitions. The buffer are bound to the
+ *        kernel in the order, in which they were added. Each work-item of the kernel processes
+ *        the object get_global_id(0) of each buffer within the partition of its device. The
+ *        partitions are padded, so the kernel doesn't need a range-check.
+ *
+ * @param kernelName name of the kernel
+ * @param kernelCode source-code of the kernel
+ * @param error reference for error-output
+ * @param calibrationSize number of objects, which are processed by each device to measure the
+ *                        throughput
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuWorkSplitter::init(const std::string &kernelName,
+                      const std::string &kernelCode,
+                      ErrorContainer &error,
+                      const uint64_t calibrationSize)
+{
+    if(m_isInit)
+    {
+        error.addMeesage("work-splitter is already initialized");
+        return false;
+    }
+
+    if(m_parts.size() == 0)
+    {
+        error.addMeesage("work-splitter has no device");
+        return false;
+    }
+
+    if(m_buffers.size() == 0)
+    {
+        error.addMeesage("work-splitter has no buffer");
+        return false;
+    }
+
+    m_kernelName = kernelName;
+
+    // the buffer of the parts are created from the pools of the interfaces, which requires the
+    // context of each interface
+    for(DevicePart &part : m_parts)
+    {
+        if(part.interface->initContext(error) == false) {
+            return false;
+        }
+    }
+
+    // compile kernel for each device
+    for(DevicePart &part : m_parts)
+    {
+        part.localSize = std::min(part.interface->getMaxWorkGroupSize(),
+                                  part.interface->getMaxWorkItemSize().x);
+        part.localSize = std::min(part.localSize, static_cast<uint64_t>(256));
+
+        if(part.interface->addKernel(part.data, kernelName, kernelCode, error) == false)
+        {
+            close();
+            return false;
+        }
+    }
+
+    // measure throughput of each device with the same part of the input, where the first run
+    // is only a warm-up
+    const uint64_t sampleSize = std::min(calibrationSize, m_numberOfObjects);
+    for(DevicePart &part : m_parts)
+    {
+        if(preparePart(part, 0, sampleSize, error) == false)
+        {
+            close();
+            return false;
+        }
+    }
+
+    if(runAllParts(false, error) == false
+            || runAllParts(false, error) == false)
+    {
+        error.addMeesage("work-splitter failed to measure the throughput of the devices");
+        close();
+        return false;
+    }
+
+    for(DevicePart &part : m_parts) {
+        releasePart(part);
+    }
+
+    // create partitions based on the measured throughput
+    if(preparePartitions(error) == false)
+    {
+        close();
+        return false;
+    }
+
+    m_isInit = true;
+
+    return true;
+}
+
+/**
+ * @brief process all data by running the partitions on all devices at the same time and gather
+ *        the results into the output-buffer. The throughput of each device is measured again
+ *        for the next call of rebalance.
+ *
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuWorkSplitter::run(ErrorContainer &error)
+{
+    if(m_isInit == false)
+    {
+        error.addMeesage("work-splitter is not initialized");
+        return false;
+    }
+
+    return runAllParts(true, error);
+}
+
+/**
+ * @brief resize the partitions based on the throughput, which was measured by the last run. Can
+ *        be used, when the load of the devices has changed since the initializing.
+ *
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuWorkSplitter::rebalance(ErrorContainer &error)
+{
+    if(m_isInit == false)
+    {
+        error.addMeesage("work-splitter is not initialized");
+        return false;
+    }
+
+    for(DevicePart &part : m_parts) {
+        releasePart(part);
+    }
+
+    if(preparePartitions(error) == false)
+    {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief free the buffer and kernels on all devices
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuWorkSplitter::close()
+{
+    bool result = true;
+    for(DevicePart &part : m_parts)
+    {
+        if(part.interface->closeDevice(part.data) == false) {
+            result = false;
+        }
+        part.data.clearKernel();
+        part.numberOfObjects = 0;
+        part.offset = 0;
+    }
+
+    m_isInit = false;
+
+    return result;
+}
+
+/**
+ * @brief get number of devices of the splitter
+ *
+ * @return number of devices
+ */
+uint64_t
+GpuWorkSplitter::getNumberOfDevices() const
+{
+    return m_parts.size();
+}
+
+/**
+ * @brief get number of objects, which are processed by a device
+ *
+ * @param deviceId position of the device in the list given to the constructor
+ *
+ * @return number of objects, or 0 if the id is invalid
+ */
+uint64_t
+GpuWorkSplitter::getPartitionSize(const uint64_t deviceId) const
+{
+    if(deviceId >= m_parts.size()) {
+        return 0;
+    }
+
+    return m_parts.at(deviceId).numberOfObjects;
+}
+
+/**
+ * @brief get last measured throughput of a device
+ *
+ * @param deviceId position of the device in the list given to the constructor
+ *
+ * @return number of objects per second, or 0.0 if the id is invalid
+ */
+double
+GpuWorkSplitter::getThroughput(const uint64_t deviceId) const
+{
+    if(deviceId >= m_parts.size()) {
+        return 0.0;
+    }
+
+    return m_parts.at(deviceId).throughput;
+}
+
+/**
+ * @brief register new buffer
+ *
+ * @param name name of the buffer
+ * @param data pointer to the data on the host
+ * @param numberOfObjects number of objects
+ * @param objectSize number of bytes of a single object
+ * @param isOutput true, if results are written into the buffer
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuWorkSplitter::addBuffer(const std::string &name,
+                           void* data,
+                           const uint64_t numberOfObjects,
+                           const uint64_t objectSize,
+                           const bool isOutput)
+{
+    // precheck
+    if(m_isInit
+            || data == nullptr
+            || numberOfObjects == 0
+            || objectSize == 0)
+    {
+        return false;
+    }
+
+    // all buffer must have the same number of objects
+    if(m_buffers.size() > 0
+            && m_numberOfObjects != numberOfObjects)
+    {
+        return false;
+    }
+
+    for(const SplitBuffer &buffer : m_buffers)
+    {
+        if(buffer.name == name) {
+            return false;
+        }
+    }
+
+    SplitBuffer newBuffer;
+    newBuffer.name = name;
+    newBuffer.data = static_cast<uint8_t*>(data);
+    newBuffer.objectSize = objectSize;
+    newBuffer.isOutput = isOutput;
+    m_buffers.push_back(newBuffer);
+
+    m_numberOfObjects = numberOfObjects;
+
+    return true;
+}
+
+/**
+ * @brief create the buffer of a device for its partition and bind them to the kernel. The
+ *        host-pointer of the buffer point directly into the data of the user, so no additional
+ *        host-memory is necessary.
+ *
+ * @param part device, which should be prepared
+ * @param offset first object of the partition
+ * @param numberOfObjects number of objects of the partition
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuWorkSplitter::preparePart(DevicePart &part,
+                             const uint64_t offset,
+                             const uint64_t numberOfObjects,
+                             ErrorContainer &error)
+{
+    part.offset = offset;
+    part.numberOfObjects = numberOfObjects;
+    if(numberOfObjects == 0) {
+        return true;
+    }
+
+    uint64_t paddedNumberOfObjects = numberOfObjects;
+    if(paddedNumberOfObjects % part.localSize != 0) {
+        paddedNumberOfObjects += part.localSize - (paddedNumberOfObjects % part.localSize);
+    }
+
+    part.data.numberOfWg.x = paddedNumberOfObjects / part.localSize;
+    part.data.threadsPerWg.x = part.localSize;
+
+    for(SplitBuffer &buffer : m_buffers)
+    {
+        part.data.addBuffer(buffer.name,
+                            paddedNumberOfObjects,
+                            buffer.objectSize,
+                            false,
+                            buffer.data + offset * buffer.objectSize);
+        GpuData::WorkerBuffer* workerBuffer = part.data.getBuffer(buffer.name);
+        if(part.interface->getBufferPool()->getDeviceBuffer(part.interface->m_context,
+                                                            workerBuffer->numberOfBytes,
+                                                            workerBuffer->clBuffer,
+                                                            error) == false)
+        {
+            error.addMeesage("failed to create buffer for work-splitter");
+            return false;
+        }
+
+        if(part.interface->bindKernelToBuffer(part.data, m_kernelName, buffer.name, error)
+                == false)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief split the objects over all devices in proportion to their measured throughput
+ *
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+GpuWorkSplitter::preparePartitions(ErrorContainer &error)
+{
+    double totalThroughput = 0.0;
+    for(const DevicePart &part : m_parts) {
+        totalThroughput += part.throughput;
+    }
+
+    // calculate size of the partitions, where the rest of the rounding is given to the
+    // fastest device
+    std::vector<uint64_t> sizes(m_parts.size(), 0);
+    uint64_t assigned = 0;
+    uint64_t fastest = 0;
+    for(uint64_t i = 0; i < m_parts.size(); i++)
+    {
+        if(totalThroughput > 0.0)
+        {
+            const double share = m_parts.at(i).throughput / totalThroughput;
+            sizes[i] = static_cast<uint64_t>(share * static_cast<double>(m_numberOfObjects));
+        }
+        else
+        {
+            sizes[i] = m_numberOfObjects / m_parts.size();
+        }
+
+        sizes[i] = std::min(sizes[i], m_numberOfObjects - assigned);
+        assigned += sizes[i];
+
+        if(m_parts.at(i).throughput > m_parts.at(fastest).throughput) {
+            fastest = i;
+        }
+    }
+    sizes[fastest] += m_numberOfObjects - assigned;
+
+    // create buffer for the partitions
+    uint64_t offset = 0;
+    for(uint64_t i = 0; i < m_parts.size(); i++)
+    {
+        LOG_DEBUG("work-splitter assigns "
+                  + std::to_string(sizes[i])
+                  + " objects to device "
+                  + m_parts.at(i).interface->getDeviceName());
+
+        if(preparePart(m_parts[i], offset, sizes[i], error) == false) {
+            return false;
+        }
+        offset += sizes[i];
+    }
+
+    return true;
+}
+
+/**
+ * @brief free the buffer of a device, but keep the compiled kernel
+ *
+ * @param part device, which should be released
+ */
+void
+GpuWorkSplitter::releasePart(DevicePart &part)
+{
+    part.interface->closeDevice(part.data);
+    part.numberOfObjects = 0;
+    part.offset = 0;
+}
+
+/**
+ * @brief process the partitions of all devices at the same time, with one host-thread for each
+ *        device, and wait until all are finished
+ *
+ * @param copyOutput true to copy the results back to the host
+ * @param error reference for error-output
+ *
+ * @return true, if all devices were successful, else false
+ */
+bool
+GpuWorkSplitter::runAllParts(const bool copyOutput,
+                             ErrorContainer &error)
+{
+    std::vector<std::thread> threads;
+    for(DevicePart &part : m_parts)
+    {
+        if(part.numberOfObjects == 0) {
+            continue;
+        }
+
+        part.success = true;
+        part.error = ErrorContainer();
+        threads.emplace_back([this, &part, copyOutput]()
+        {
+            runPart(part, copyOutput);
+
+            // each run starts new threads, so the queues of the old ones are removed
+            if(part.interface->releaseThreadQueue() == false)
+            {
+                part.error.addMeesage("failed to release queue of the thread");
+                part.success = false;
+            }
+        });
+    }
+
+    for(std::thread &thread : threads) {
+        thread.join();
+    }
+
+    bool result = true;
+    for(DevicePart &part : m_parts)
+    {
+        if(part.success == false)
+        {
+            error.addMeesage("work-splitter failed on device "
+                             + part.interface->getDeviceName()
+                             + ": "
+                             + part.error.toString());
+            result = false;
+        }
+    }
+
+    return result;
+}
+
+/**
+ * @brief process the partition of a single device and measure its throughput. Runs in its own
+ *        thread, so the result is written into the part.
+ *
+ * @param part device with the partition, which should be processed
+ * @param copyOutput true to copy the results back to the host
+ */
+void
+GpuWorkSplitter::runPart(DevicePart &part,
+                         const bool copyOutput)
+{
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    // upload input
+    for(SplitBuffer &buffer : m_buffers)
+    {
+        if(buffer.isOutput) {
+            continue;
+        }
+
+        if(part.interface->updateBufferOnDevice(part.data,
+                                                buffer.name,
+                                                part.error,
+                                                part.numberOfObjects) == false)
+        {
+            part.success = false;
+            return;
+        }
+    }
+
+    // process partition
+    GpuEvent runEvent;
+    if(part.interface->runAsync(part.data, m_kernelName, runEvent, part.error) == false)
+    {
+        part.success = false;
+        return;
+    }
+
+    // download only the valid part of the output
+    if(copyOutput)
+    {
+        for(SplitBuffer &buffer : m_buffers)
+        {
+            if(buffer.isOutput == false) {
+                continue;
+            }
+
+            if(part.interface->copyFromDevice(part.data,
+                                              buffer.name,
+                                              part.error,
+                                              part.numberOfObjects) == false)
+            {
+                part.success = false;
+                return;
+            }
+        }
+    }
+
+    if(runEvent.wait() == false)
+    {
+        part.error.addMeesage("failed to wait for the kernel");
+        part.success = false;
+        return;
+    }
+
+    const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    const double seconds = std::chrono::duration<double>(end - start).count();
+    if(seconds > 0.0) {
+        part.throughput = static_cast<double>(part.numberOfObjects) / seconds;
+    }
+}
+
+}
@@ -0,0 +1,89 @@
+/**
+ * @file        hash_helper.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef HASH_HELPER_H
+#define HASH_HELPER_H
+
+#include <string>
+#include <stdint.h>
+#include <stdio.h>
+
+namespace Kitsunemimi
+{
+
+/**
+ * @brief update a FNV-1a hash with a string. In contrast to std::hash the result is stable between
+ *        different builds and runs, so it can be used for persisted keys.
+ *
+ * @param hash hash-value to update
+ * @param input string to add to the hash
+ *
+ * @return updated hash-value
+ */
+inline uint64_t
+updateHash(uint64_t hash,
+           const std::string &input)
+{
+    for(const char c : input)
+    {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 0x100000001b3ULL;
+    }
+
+    // add separator to avoid equal hashes for shifted input-strings like "ab"+"c" and "a"+"bc"
+    hash ^= 0xFF;
+    hash *= 0x100000001b3ULL;
+
+    return hash;
+}
+
+/**
+ * @brief create a new FNV-1a hash of a string
+ *
+ * @param input string to hash
+ *
+ * @return hash-value
+ */
+inline uint64_t
+createHash(const std::string &input)
+{
+    return updateHash(0xcbf29ce484222325ULL, input);
+}
+
+/**
+ * @brief convert a hash-value into a hex-string, which can be used as file-name
+ *
+ * @param hash hash-value to convert
+ *
+ * @return hex-string with 16 characters
+ */
+inline const std::string
+hashToString(const uint64_t hash)
+{
+    char buffer[17];
+    snprintf(buffer, sizeof(buffer), "%016lx", static_cast<unsigned long>(hash));
+    return std::string(buffer);
+}
+
+}
+
+#endif // HASH_HELPER_H
@@ -0,0 +1,235 @@
+/**
+ * @file        program_cache.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include <libKitsunemimiOpencl/program_cache.h>
+
+#include <fstream>
+#include <filesystem>
+
+#include <hash_helper.h>
+#include <file_helper.h>
+#include <libKitsunemimiCommon/logger.h>
+
+namespace Kitsunemimi
+{
+
+/**
+ * @brief constructor
+ *
+ * @param cacheDirectory directory, where the compiled program-binaries are stored
+ */
+ProgramCache::ProgramCache(const std::string &cacheDirectory)
+{
+    m_cacheDirectory = cacheDirectory;
+}
+
+/**
+ * @brief create key to identify a compiled program within the cache
+ *
+ * @param device device, for which the program is compiled
+ * @param kernelCode source-code of the program
+ * @param buildOptions options, which are used for the compilation
+ *
+ * @return hash-string, which is unique for the combination of source, options, device and driver
+ */
+const std::string
+ProgramCache::createKey(const cl::Device &device,
+                        const std::string &kernelCode,
+                        const std::string &buildOptions)
+{
+    uint64_t hash = createHash(kernelCode);
+    hash = updateHash(hash, buildOptions);
+    hash = updateHash(hash, device.getInfo<CL_DEVICE_NAME>());
+    hash = updateHash(hash, device.getInfo<CL_DEVICE_VERSION>());
+    hash = updateHash(hash, device.getInfo<CL_DRIVER_VERSION>());
+
+    return hashToString(hash);
+}
+
+/**
+ * @brief try to create a program from a cached binary
+ *
+ * @param program reference for the resulting program
+ * @param context context, where the program should be created
+ * @param device device, for which the program should be built
+ * @param key key of the program within the cache
+ * @param buildOptions options, which are used for the compilation
+ *
+ * @return true, if a valid binary was found and successfully loaded, else false
+ */
+bool
+ProgramCache::loadProgram(cl::Program &program,
+                          const cl::Context &context,
+                          const cl::Device &device,
+                          const std::string &key,
+                          const std::string &buildOptions)
+{
+    const std::string filePath = getFilePath(key);
+
+    // read binary from disc
+    std::ifstream inputFile(filePath, std::ios::binary);
+    if(inputFile.is_open() == false)
+    {
+        m_misses++;
+        return false;
+    }
+
+    cl::Program::Binaries binaries(1);
+    binaries[0].assign(std::istreambuf_iterator<char>(inputFile),
+                       std::istreambuf_iterator<char>());
+    inputFile.close();
+
+    // load and build the binary. The driver rejects binaries of an older or different compiler,
+    // so in this case the cache-entry is stale and has to be replaced
+    try
+    {
+        std::vector<cl::Device> devices = {device};
+        std::vector<cl_int> binaryStatus;
+        program = cl::Program(context, devices, binaries, &binaryStatus);
+        if(binaryStatus.size() != 1
+                || binaryStatus.at(0) != CL_SUCCESS)
+        {
+            throw cl::Error(CL_INVALID_BINARY, "clCreateProgramWithBinary");
+        }
+
+        program.build(devices, buildOptions.c_str());
+    }
+    catch(const cl::Error &err)
+    {
+        LOG_DEBUG("cached program-binary '" + filePath + "' was rejected: "
+                  + std::string(err.what())
+                  + "("
+                  + std::to_string(err.err())
+                  + ")");
+
+        std::error_code ec;
+        std::filesystem::remove(filePath, ec);
+
+        m_misses++;
+        return false;
+    }
+
+    LOG_DEBUG("loaded program from cache-file: " + filePath);
+    m_hits++;
+
+    return true;
+}
+
+/**
+ * @brief write binary of a compiled program into the cache
+ *
+ * @param program successfully built program
+ * @param device device, for which the program was built
+ * @param key key of the program within the cache
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+ProgramCache::storeProgram(const cl::Program &program,
+                           const cl::Device &device,
+                           const std::string &key,
+                           ErrorContainer &error)
+{
+    const std::string filePath = getFilePath(key);
+
+    // a program within a context with multiple devices has one binary for each device, where
+    // only the one of the device, for which it was built, is filled
+    cl::Program::Binaries binaries;
+    uint64_t binaryPos = 0;
+    try
+    {
+        binaries = program.getInfo<CL_PROGRAM_BINARIES>();
+        const std::vector<cl::Device> devices = program.getInfo<CL_PROGRAM_DEVICES>();
+        for(uint64_t i = 0; i < devices.size(); i++)
+        {
+            if(devices.at(i)() == device()) {
+                binaryPos = i;
+            }
+        }
+    }
+    catch(const cl::Error &err)
+    {
+        error.addMeesage("failed to get binary of program: "
+                         + std::string(err.what())
+                         + "("
+                         + std::to_string(err.err())
+                         + ")");
+        return false;
+    }
+
+    if(binaryPos >= binaries.size()
+            || binaries.at(binaryPos).size() == 0)
+    {
+        error.addMeesage("OpenCL driver provides no program-binary for the cache");
+        return false;
+    }
+
+    // other processes can use the same cache-directory, so the file must never be incomplete
+    if(writeFileAtomic(filePath,
+                       binaries.at(binaryPos).data(),
+                       binaries.at(binaryPos).size(),
+                       error) == false)
+    {
+        error.addMeesage("failed to store program in the program-cache");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief get number of programs, which were successfully loaded from the cache
+ *
+ * @return number of cache-hits
+ */
+uint64_t
+ProgramCache::getNumberOfHits() const
+{
+    return m_hits;
+}
+
+/**
+ * @brief get number of programs, which had to be compiled from source
+ *
+ * @return number of cache-misses
+ */
+uint64_t
+ProgramCache::getNumberOfMisses() const
+{
+    return m_misses;
+}
+
+/**
+ * @brief get path of the cache-file for a specific key
+ *
+ * @param key key of the program within the cache
+ *
+ * @return file-path
+ */
+const std::string
+ProgramCache::getFilePath(const std::string &key)
+{
+    return m_cacheDirectory + "/" + key + ".bin";
+}
+
+}
@@ -19,9 +19,32 @@ INCLUDEPATH += $$PWD \
 HEADERS += \
     ../include/libKitsunemimiOpencl/gpu_interface.h \
     ../include/libKitsunemimiOpencl/gpu_handler.h \
-    ../include/libKitsunemimiOpencl/gpu_data.h
+    ../include/libKitsunemimiOpencl/gpu_data.h \
+    ../include/libKitsunemimiOpencl/gpu_event.h \
+    ../include/libKitsunemimiOpencl/gpu_command_graph.h \
+    ../include/libKitsunemimiOpencl/gpu_stream_executor.h \
+    ../include/libKitsunemimiOpencl/gpu_work_splitter.h \
+    ../include/libKitsunemimiOpencl/gpu_job_scheduler.h \
+    ../include/libKitsunemimiOpencl/program_cache.h \
+    ../include/libKitsunemimiOpencl/buffer_pool.h \
+    ../include/libKitsunemimiOpencl/gpu_profiler.h \
+    ../include/libKitsunemimiOpencl/gpu_tracer.h \
+    ../include/libKitsunemimiOpencl/work_group_tuner.h \
+    hash_helper.h \
+    file_helper.h \
+    event_helper.h
 
 SOURCES += \
     gpu_interface.cpp \
     gpu_handler.cpp \
-    gpu_data.cpp
+    gpu_data.cpp \
+    gpu_event.cpp \
+    gpu_command_graph.cpp \
+    gpu_stream_executor.cpp \
+    gpu_work_splitter.cpp \
+    gpu_job_scheduler.cpp \
+    program_cache.cpp \
+    buffer_pool.cpp \
+    gpu_profiler.cpp \
+    gpu_tracer.cpp \
+    work_group_tuner.cpp
@@ -0,0 +1,172 @@
+/**
+ * @file        work_group_tuner.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include <libKitsunemimiOpencl/work_group_tuner.h>
+
+#include <fstream>
+
+#include <hash_helper.h>
+#include <file_helper.h>
+
+namespace Kitsunemimi
+{
+
+/**
+ * @brief constructor
+ *
+ * @param directory directory, where the tuning-results are stored
+ */
+WorkGroupTuner::WorkGroupTuner(const std::string &directory)
+{
+    m_directory = directory;
+}
+
+/**
+ * @brief create hash of the parts of the key, which are fixed for a kernel, so it has to be
+ *        calculated only once per kernel and not for each launch
+ *
+ * @param device device, on which the kernel was tuned
+ * @param kernelCode source-code of the kernel
+ * @param kernelName name of the tuned kernel
+ *
+ * @return hash of kernel, device and driver
+ */
+uint64_t
+WorkGroupTuner::createKernelHash(const cl::Device &device,
+                                 const std::string &kernelCode,
+                                 const std::string &kernelName)
+{
+    uint64_t hash = createHash(kernelCode);
+    hash = updateHash(hash, kernelName);
+    hash = updateHash(hash, device.getInfo<CL_DEVICE_NAME>());
+    hash = updateHash(hash, device.getInfo<CL_DRIVER_VERSION>());
+
+    return hash;
+}
+
+/**
+ * @brief create key to identify a tuning-result
+ *
+ * @param kernelHash hash of kernel, device and driver, which was created by createKernelHash
+ * @param globalSize total number of threads in each dimension
+ * @param localSize threads per work-group, where only the y- and z-dimension are part of the key
+ *
+ * @return hash-string, which is unique for the combination of kernel, device, driver and sizes
+ */
+const std::string
+WorkGroupTuner::createKey(const uint64_t kernelHash,
+                          const WorkerDim &globalSize,
+                          const WorkerDim &localSize)
+{
+    uint64_t hash = updateHash(kernelHash, std::to_string(globalSize.x)
+                                           + "x" + std::to_string(globalSize.y)
+                                           + "x" + std::to_string(globalSize.z));
+    hash = updateHash(hash, std::to_string(localSize.y)
+                            + "x" + std::to_string(localSize.z));
+
+    return hashToString(hash);
+}
+
+/**
+ * @brief get a stored tuning-result
+ *
+ * @param key key of the tuning-result
+ * @param localSizeX reference for the resulting number of threads per work-group in x-direction
+ *
+ * @return true, if a result was found, else false
+ */
+bool
+WorkGroupTuner::loadResult(const std::string &key,
+                           uint64_t &localSizeX)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    // check results, which were already loaded or tuned in this process
+    std::map<std::string, uint64_t>::const_iterator it;
+    it = m_results.find(key);
+    if(it != m_results.end())
+    {
+        localSizeX = it->second;
+        return localSizeX != 0;
+    }
+
+    // read result from disc
+    uint64_t value = 0;
+    std::ifstream inputFile(getFilePath(key));
+    if(inputFile.is_open())
+    {
+        inputFile>>value;
+        if(inputFile.fail()) {
+            value = 0;
+        }
+    }
+
+    m_results.insert(std::make_pair(key, value));
+    localSizeX = value;
+
+    return localSizeX != 0;
+}
+
+/**
+ * @brief store a tuning-result
+ *
+ * @param key key of the tuning-result
+ * @param localSizeX number of threads per work-group in x-direction
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+WorkGroupTuner::storeResult(const std::string &key,
+                            const uint64_t localSizeX,
+                            ErrorContainer &error)
+{
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_results[key] = localSizeX;
+    }
+
+    // other processes can use the same directory, so the file must never be incomplete
+    const std::string content = std::to_string(localSizeX) + "\n";
+    if(writeFileAtomic(getFilePath(key), content.c_str(), content.size(), error) == false)
+    {
+        error.addMeesage("failed to store the tuning-result");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief get path of the file for a specific key
+ *
+ * @param key key of the tuning-result
+ *
+ * @return file-path
+ */
+const std::string
+WorkGroupTuner::getFilePath(const std::string &key)
+{
+    return m_directory + "/" + key + ".wg";
+}
+
+}
@@ -40,6 +40,9 @@ SimpleTest::SimpleTest()
     m_runTimeSlot.unitName = "ms";
     m_runTimeSlot.name = "run test";
 
+    m_runDeviceTimeSlot.unitName = "ms";
+    m_runDeviceTimeSlot.name = "run test on device";
+
     m_updateTimeSlot.unitName = "ms";
     m_updateTimeSlot.name = "update data on device";
 
@@ -49,6 +52,18 @@ SimpleTest::SimpleTest()
     m_cleanupTimeSlot.unitName = "ms";
     m_cleanupTimeSlot.name = "cleanup";
 
+    m_pipelineSingleQueueTimeSlot.unitName = "ms";
+    m_pipelineSingleQueueTimeSlot.name = "pipeline with single queue";
+
+    m_pipelineSeparateQueuesTimeSlot.unitName = "ms";
+    m_pipelineSeparateQueuesTimeSlot.name = "pipeline with separate queues";
+
+    m_pipelineSingleQueueOverlapTimeSlot.unitName = "ms";
+    m_pipelineSingleQueueOverlapTimeSlot.name = "pipeline-overlap with single queue";
+
+    m_pipelineSeparateQueuesOverlapTimeSlot.unitName = "ms";
+    m_pipelineSeparateQueuesOverlapTimeSlot.name = "pipeline-overlap with separate queues";
+
     m_oclHandler = new Kitsunemimi::GpuHandler();
     assert(m_oclHandler->m_interfaces.size() != 0);
 
@@ -72,14 +87,29 @@ SimpleTest::SimpleTest()
                     m_copyToHostTimeSlot.getDuration(MICRO_SECONDS) / 1000.0);
         m_cleanupTimeSlot.values.push_back(
                     m_cleanupTimeSlot.getDuration(MICRO_SECONDS) / 1000.0);
+
+        pipeline_test(false, m_pipelineSingleQueueTimeSlot, m_pipelineSingleQueueOverlapTimeSlot);
+        pipeline_test(true,
+                      m_pipelineSeparateQueuesTimeSlot,
+                      m_pipelineSeparateQueuesOverlapTimeSlot);
+
+        m_pipelineSingleQueueTimeSlot.values.push_back(
+                    m_pipelineSingleQueueTimeSlot.getDuration(MICRO_SECONDS) / 1000.0);
+        m_pipelineSeparateQueuesTimeSlot.values.push_back(
+                    m_pipelineSeparateQueuesTimeSlot.getDuration(MICRO_SECONDS) / 1000.0);
     }
 
     addToResult(m_copyToDeviceTimeSlot);
     addToResult(m_initKernelTimeSlot);
     addToResult(m_runTimeSlot);
+    addToResult(m_runDeviceTimeSlot);
     addToResult(m_updateTimeSlot);
     addToResult(m_copyToHostTimeSlot);
     addToResult(m_cleanupTimeSlot);
+    addToResult(m_pipelineSingleQueueTimeSlot);
+    addToResult(m_pipelineSeparateQueuesTimeSlot);
+    addToResult(m_pipelineSingleQueueOverlapTimeSlot);
+    addToResult(m_pipelineSeparateQueuesOverlapTimeSlot);
 
     printResult();
 }
@@ -99,14 +129,9 @@ SimpleTest::simple_test()
         "       )\n"
         "{\n"
         "    __local float temp[512];\n"
-        "    size_t globalId_x = get_global_id(0);\n"
         "    int localId_x = get_local_id(0);\n"
-        "    size_t globalSize_x = get_global_size(0);\n"
-        "    size_t globalSize_y = get_global_size(1);\n"
-        "    \n"
-        "    size_t globalId = get_global_id(0) + get_global_size(0) * get_global_id(1);\n"
-        "    size_t testSize = 1 << 26;\n"
-        "    if (globalId < testSize)\n"
+        "    size_t globalId = get_global_id(0);\n"
+        "    if (globalId < TEST_SIZE)\n"
         "    {\n"
         "       temp[localId_x] = b[globalId];\n"
         "       c[globalId] = a[globalId] + b[globalId];"
@@ -116,14 +141,11 @@ SimpleTest::simple_test()
     Kitsunemimi::GpuHandler oclHandler;
     assert(oclHandler.initDevice(error));
     Kitsunemimi::GpuInterface* ocl = oclHandler.m_interfaces.at(m_id);
+    assert(ocl->enableProfiling(error));
 
     // create data-object
     Kitsunemimi::GpuData data;
 
-    data.numberOfWg.x = testSize / 512;
-    data.numberOfWg.y = 2;
-    data.threadsPerWg.x = 256;
-
     // init empty buffer
     data.addBuffer("x", testSize, sizeof(float), false);
     data.addBuffer("y", testSize, sizeof(float), false);
@@ -146,15 +168,22 @@ SimpleTest::simple_test()
     m_copyToDeviceTimeSlot.stopTimer();
 
     m_initKernelTimeSlot.startTimer();
-    assert(ocl->addKernel(data, "add", kernelCode, error));
+    // size is given at compile-time, so the kernel doesn't have to read it at runtime
+    Kitsunemimi::KernelBuildOptions options;
+    options.defines["TEST_SIZE"] = std::to_string(testSize);
+    options.flags.push_back("-cl-mad-enable");
+    assert(ocl->addKernel(data, "add", kernelCode, options, error));
     assert(ocl->bindKernelToBuffer(data, "add", "x", error));
     assert(ocl->bindKernelToBuffer(data, "add", "y", error));
     assert(ocl->bindKernelToBuffer(data, "add", "z", error));
     m_initKernelTimeSlot.stopTimer();
 
-    // run
+    // run with worker-dimensions calculated from the number of objects
+    Kitsunemimi::WorkerDim problemSize;
+    problemSize.x = testSize;
+
     m_runTimeSlot.startTimer();
-    assert(ocl->run(data, "add", error));
+    assert(ocl->launch(data, "add", problemSize, error));
     m_runTimeSlot.stopTimer();
 
     // copy output back
@@ -173,12 +202,127 @@ SimpleTest::simple_test()
     assert(ocl->updateBufferOnDevice(data, "x", error));
     m_updateTimeSlot.stopTimer();
 
+    // the timer only measures the enqueue by the host, so get the real time on the device
+    Kitsunemimi::ProfilingStats stats;
+    assert(ocl->getProfilingStats(Kitsunemimi::PROFILE_KERNEL, "add", stats, error));
+    m_runDeviceTimeSlot.values.push_back(stats.meanTime / 1000.0);
+
     // clear device
     m_cleanupTimeSlot.startTimer();
     assert(ocl->closeDevice(data));
     m_cleanupTimeSlot.stopTimer();
 }
 
+/**
+ * @brief process multiple independent batches, where each batch is uploaded, processed and copied
+ *        back. The upload of the next batch is enqueued before the download of the current one,
+ *        so with separate queues it can overlap with the kernel of the current batch. The overlap
+ *        is the sum of the execution-times of all operations on the device minus the time of the
+ *        whole pipeline, so it is only greater than 0, if operations were running at the same time.
+ *
+ * @param separateQueues true to use separate queues for transfers and kernels
+ * @param timeSlot timer-slot for the measurement
+ * @param overlapSlot timer-slot for the overlap of the operations on the device
+ */
+void
+SimpleTest::pipeline_test(const bool separateQueues,
+                          TimerSlot &timeSlot,
+                          TimerSlot &overlapSlot)
+{
+    const size_t batchSize = 1 << 22;
+    const uint32_t numberOfBatches = 8;
+    ErrorContainer error;
+
+    const std::string kernelCode =
+        "__kernel void add(\n"
+        "       __global const float* a,\n"
+        "       __global const float* b,\n"
+        "       __global float* c\n"
+        "       )\n"
+        "{\n"
+        "    size_t globalId = get_global_id(0);\n"
+        "    float value = a[globalId];\n"
+        "    for(int i = 0; i < 64; i++) {\n"
+        "        value = value * 0.5f + b[globalId];\n"
+        "    }\n"
+        "    c[globalId] = value;\n"
+        "}\n";
+
+    Kitsunemimi::GpuHandler oclHandler;
+    assert(oclHandler.initDevice(error));
+    Kitsunemimi::GpuInterface* ocl = oclHandler.m_interfaces.at(m_id);
+    if(separateQueues) {
+        assert(ocl->enableSeparateQueues(1, error));
+    }
+    assert(ocl->enableProfiling(error));
+
+    // prepare all batches
+    std::vector<Kitsunemimi::GpuData*> batches;
+    for(uint32_t i = 0; i < numberOfBatches; i++)
+    {
+        Kitsunemimi::GpuData* data = new Kitsunemimi::GpuData();
+        data->numberOfWg.x = batchSize / 256;
+        data->threadsPerWg.x = 256;
+
+        data->addBuffer("x", batchSize, sizeof(float), false);
+        data->addBuffer("y", batchSize, sizeof(float), false);
+        data->addBuffer("z", batchSize, sizeof(float), false);
+
+        float* a = static_cast<float*>(data->getBufferData("x"));
+        float* b = static_cast<float*>(data->getBufferData("y"));
+        for(uint32_t j = 0; j < batchSize; j++)
+        {
+            a[j] = 1.0f;
+            b[j] = 2.0f;
+        }
+
+        assert(ocl->initCopyToDevice(*data, error));
+        assert(ocl->addKernel(*data, "add", kernelCode, error));
+        assert(ocl->bindKernelToBuffer(*data, "add", "x", error));
+        assert(ocl->bindKernelToBuffer(*data, "add", "y", error));
+        assert(ocl->bindKernelToBuffer(*data, "add", "z", error));
+
+        batches.push_back(data);
+    }
+
+    // process all batches, where the upload of the next batch is enqueued before the download of
+    // the current batch, so it doesn't have to wait for the kernel of the current batch
+    ocl->resetProfiling();
+    timeSlot.startTimer();
+    std::vector<Kitsunemimi::GpuEvent> events(numberOfBatches);
+    Kitsunemimi::GpuEvent updateEvent;
+    assert(ocl->updateBufferOnDeviceAsync(*batches[0], "x", updateEvent, error));
+    for(uint32_t i = 0; i < numberOfBatches; i++)
+    {
+        Kitsunemimi::GpuEvent runEvent;
+        assert(ocl->runAsync(*batches[i], "add", runEvent, error));
+        if(i + 1 < numberOfBatches) {
+            assert(ocl->updateBufferOnDeviceAsync(*batches[i + 1], "x", updateEvent, error));
+        }
+        assert(ocl->copyFromDeviceAsync(*batches[i], "z", events[i], error));
+    }
+    assert(Kitsunemimi::GpuEvent::waitForAll(events));
+    timeSlot.stopTimer();
+
+    // sum of the execution-times on the device in microseconds
+    double deviceTime = 0.0;
+    Kitsunemimi::ProfilingStats stats;
+    assert(ocl->getProfilingStats(Kitsunemimi::PROFILE_WRITE, "x", stats, error));
+    deviceTime += stats.meanTime * static_cast<double>(stats.count);
+    assert(ocl->getProfilingStats(Kitsunemimi::PROFILE_KERNEL, "add", stats, error));
+    deviceTime += stats.meanTime * static_cast<double>(stats.count);
+    assert(ocl->getProfilingStats(Kitsunemimi::PROFILE_READ, "z", stats, error));
+    deviceTime += stats.meanTime * static_cast<double>(stats.count);
+    overlapSlot.values.push_back((deviceTime - timeSlot.getDuration(MICRO_SECONDS)) / 1000.0);
+
+    // cleanup
+    for(Kitsunemimi::GpuData* data : batches)
+    {
+        assert(ocl->closeDevice(*data));
+        delete data;
+    }
+}
+
 void
 SimpleTest::chooseDevice()
 {
@@ -41,13 +41,21 @@ public:
     SimpleTest();
 
     void simple_test();
+    void pipeline_test(const bool separateQueues,
+                       TimerSlot &timeSlot,
+                       TimerSlot &overlapSlot);
 
     TimerSlot m_copyToDeviceTimeSlot;
     TimerSlot m_initKernelTimeSlot;
     TimerSlot m_runTimeSlot;
+    TimerSlot m_runDeviceTimeSlot;
     TimerSlot m_updateTimeSlot;
     TimerSlot m_copyToHostTimeSlot;
     TimerSlot m_cleanupTimeSlot;
+    TimerSlot m_pipelineSingleQueueTimeSlot;
+    TimerSlot m_pipelineSeparateQueuesTimeSlot;
+    TimerSlot m_pipelineSingleQueueOverlapTimeSlot;
+    TimerSlot m_pipelineSeparateQueuesOverlapTimeSlot;
 
 private:
     uint32_t m_id = 0xFFFFFFFF;
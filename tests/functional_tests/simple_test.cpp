@@ -24,6 +24,16 @@
 
 #include <libKitsunemimiOpencl/gpu_interface.h>
 #include <libKitsunemimiOpencl/gpu_handler.h>
+#include <libKitsunemimiOpencl/gpu_command_graph.h>
+#include <libKitsunemimiOpencl/gpu_stream_executor.h>
+#include <libKitsunemimiOpencl/gpu_work_splitter.h>
+#include <libKitsunemimiOpencl/gpu_job_scheduler.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
 
 namespace Kitsunemimi
 {
@@ -32,6 +42,29 @@ SimpleTest::SimpleTest()
     : Kitsunemimi::CompareTestHelper("SimpleTest")
 {
     simple_test();
+    program_cache_test();
+    multi_kernel_test();
+    async_test();
+    command_graph_test();
+    partial_copy_test();
+    stream_executor_test();
+    pinned_memory_test();
+    map_test();
+    buffer_pool_test();
+    arena_test();
+    handle_test();
+    profiling_test();
+    tracing_test();
+    workgroup_tuning_test();
+    launch_test();
+    work_splitter_test();
+    job_scheduler_test();
+    shared_context_test();
+    device_filter_test();
+    async_build_test();
+    build_options_test();
+    kernel_argument_test();
+    per_thread_queue_test();
 }
 
 void
@@ -137,4 +170,1696 @@ SimpleTest::simple_test()
     TEST_EQUAL(ocl->closeDevice(data), true)
 }
 
+void
+SimpleTest::program_cache_test()
+{
+    ErrorContainer error;
+    const std::string kernelCode =
+        "__kernel void copy(\n"
+        "       __global const float* a,\n"
+        "       __global float* b\n"
+        "       )\n"
+        "{\n"
+        "    size_t globalId = get_global_id(0);\n"
+        "    b[globalId] = a[globalId];\n"
+        "}\n";
+
+    const std::string cacheDir = "/tmp/libKitsunemimiOpencl_cache_test";
+    std::filesystem::remove_all(cacheDir);
+
+    Kitsunemimi::GpuHandler oclHandler;
+    assert(oclHandler.initDevice(error));
+    Kitsunemimi::GpuInterface* ocl = oclHandler.m_interfaces.at(0);
+
+    TEST_EQUAL(ocl->enableProgramCache(cacheDir, error), true)
+
+    // first compilation has to miss the cache
+    Kitsunemimi::GpuData data1;
+    TEST_EQUAL(ocl->addKernel(data1, "copy", kernelCode, error), true)
+    TEST_EQUAL(ocl->getNumberOfProgramCacheHits(), 0)
+    TEST_EQUAL(ocl->getNumberOfProgramCacheMisses(), 1)
+
+    // only the final file is left in the directory and no temporary file
+    uint64_t numberOfFiles = 0;
+    bool foundTempFile = false;
+    for(const auto &entry : std::filesystem::directory_iterator(cacheDir))
+    {
+        numberOfFiles++;
+        if(entry.path().filename().string().find(".tmp") != std::string::npos) {
+            foundTempFile = true;
+        }
+    }
+    TEST_EQUAL(numberOfFiles, 1)
+    TEST_EQUAL(foundTempFile, false)
+
+    // second compilation of the same source by another interface, which doesn't have the
+    // program in memory, has to be loaded from the cache
+    Kitsunemimi::GpuHandler otherHandler;
+    assert(otherHandler.initDevice(error));
+    Kitsunemimi::GpuInterface* otherOcl = otherHandler.m_interfaces.at(0);
+    TEST_EQUAL(otherOcl->enableProgramCache(cacheDir, error), true)
+
+    Kitsunemimi::GpuData data2;
+    TEST_EQUAL(otherOcl->addKernel(data2, "copy", kernelCode, error), true)
+    TEST_EQUAL(otherOcl->getNumberOfProgramCacheHits(), 1)
+    TEST_EQUAL(otherOcl->getNumberOfProgramCacheMisses(), 0)
+
+    // parallel builds of the same new source are compiled only once, so there is only one miss
+    const std::string otherCode = kernelCode + "\n// other source\n";
+    Kitsunemimi::GpuData data3;
+    Kitsunemimi::GpuData data4;
+    TEST_EQUAL(ocl->addKernelAsync(data3, "copy", otherCode, error), true)
+    TEST_EQUAL(ocl->addKernelAsync(data4, "copy", otherCode, error), true)
+    TEST_EQUAL(ocl->waitForKernels(data3, error), true)
+    TEST_EQUAL(ocl->waitForKernels(data4, error), true)
+    TEST_EQUAL(ocl->getNumberOfProgramCacheHits(), 0)
+    TEST_EQUAL(ocl->getNumberOfProgramCacheMisses(), 2)
+    TEST_NOT_EQUAL(data4.getKernelHandle("copy").id, 0xFFFFFFFF)
+
+    std::filesystem::remove_all(cacheDir);
+}
+
+void
+SimpleTest::multi_kernel_test()
+{
+    const size_t testSize = 1 << 16;
+    ErrorContainer error;
+
+    // two kernels within the same source-code
+    const std::string kernelCode =
+        "__kernel void add(\n"
+        "       __global const float* a,\n"
+        "       __global float* b\n"
+        "       )\n"
+        "{\n"
+        "    size_t globalId = get_global_id(0);\n"
+        "    b[globalId] = a[globalId] + 1.0f;\n"
+        "}\n"
+        "__kernel void mult(\n"
+        "       __global const float* a,\n"
+        "       __global float* b\n"
+        "       )\n"
+        "{\n"
+        "    size_t globalId = get_global_id(0);\n"
+        "    b[globalId] = b[globalId] * a[globalId];\n"
+        "}\n";
+
+    Kitsunemimi::GpuHandler oclHandler;
+    assert(oclHandler.initDevice(error));
+    Kitsunemimi::GpuInterface* ocl = oclHandler.m_interfaces.at(0);
+
+    Kitsunemimi::GpuData data;
+    data.numberOfWg.x = testSize / 64;
+    data.threadsPerWg.x = 64;
+
+    data.addBuffer("a", testSize, sizeof(float), false);
+    data.addBuffer("b", testSize, sizeof(float), false);
+    float* a = static_cast<float*>(data.getBufferData("a"));
+    for(uint32_t i = 0; i < testSize; i++) {
+        a[i] = 3.0f;
+    }
+
+    TEST_EQUAL(ocl->initCopyToDevice(data, error), true)
+    TEST_EQUAL(ocl->addKernels(data, kernelCode, error), true)
+    TEST_EQUAL(ocl->addKernels(data, kernelCode, error), false)
+    TEST_EQUAL(ocl->bindKernelToBuffer(data, "add", "a", error), true)
+    TEST_EQUAL(ocl->bindKernelToBuffer(data, "add", "b", error), true)
+    TEST_EQUAL(ocl->bindKernelToBuffer(data, "mult", "a", error), true)
+    TEST_EQUAL(ocl->bindKernelToBuffer(data, "mult", "b", error), true)
+
+    // run both kernels after each other: (3 + 1) * 3
+    TEST_EQUAL(ocl->run(data, "add", error), true)
+    TEST_EQUAL(ocl->run(data, "mult", error), true)
+    TEST_EQUAL(ocl->copyFromDevice(data, "b", error), true)
+
+    float* outputValues = static_cast<float*>(data.getBufferData("b"));
+    TEST_EQUAL(outputValues[42], 12.0f)
+
+    TEST_EQUAL(ocl->closeDevice(data), true)
+}
+
+void
+SimpleTest::async_test()
+{
+    const size_t testSize = 1 << 16;
+    ErrorContainer error;
+
+    const std::string kernelCode =
+        "__kernel void add(\n"
+        "       __global const float* a,\n"
+        "       __global float* b\n"
+        "       )\n"
+        "{\n"
+        "    size_t globalId = get_global_id(0);\n"
+        "    b[globalId] = a[globalId] + 1.0f;\n"
+        "}\n";
+
+    Kitsunemimi::GpuHandler oclHandler;
+    assert(oclHandler.initDevice(error));
+    Kitsunemimi::GpuInterface* ocl = oclHandler.m_interfaces.at(0);
+
+    Kitsunemimi::GpuData data;
+    data.numberOfWg.x = testSize / 64;
+    data.threadsPerWg.x = 64;
+
+    data.addBuffer("a", testSize, sizeof(float), false);
+    data.addBuffer("b", testSize, sizeof(float), false);
+    float* a = static_cast<float*>(data.getBufferData("a"));
+    for(uint32_t i = 0; i < testSize; i++) {
+        a[i] = 1.0f;
+    }
+
+    TEST_EQUAL(ocl->initCopyToDevice(data, error), true)
+    TEST_EQUAL(ocl->addKernel(data, "add", kernelCode, error), true)
+    TEST_EQUAL(ocl->bindKernelToBuffer(data, "add", "a", error), true)
+    TEST_EQUAL(ocl->bindKernelToBuffer(data, "add", "b", error), true)
+
+    // unused events have nothing to wait for
+    Kitsunemimi::GpuEvent emptyEvent;
+    TEST_EQUAL(emptyEvent.isFinished(), true)
+    TEST_EQUAL(emptyEvent.wait(), true)
+
+    for(uint32_t i = 0; i < testSize; i++) {
+        a[i] = 4.0f;
+    }
+
+    std::vector<Kitsunemimi::GpuEvent> events(3);
+    TEST_EQUAL(ocl->updateBufferOnDeviceAsync(data, "a", events[0], error), true)
+    TEST_EQUAL(ocl->runAsync(data, "add", events[1], error), true)
+    TEST_EQUAL(ocl->copyFromDeviceAsync(data, "b", events[2], error), true)
+    TEST_EQUAL(events[2].isActive(), true)
+    TEST_EQUAL(Kitsunemimi::GpuEvent::waitForAll(events), true)
+    TEST_EQUAL(events[2].isFinished(), true)
+
+    float* outputValues = static_cast<float*>(data.getBufferData("b"));
+    TEST_EQUAL(outputValues[42], 5.0f)
+
+    TEST_EQUAL(ocl->closeDevice(data), true)
+}
+
+void
+SimpleTest::command_graph_test()
+{
+    const size_t testSize = 1 << 16;
+    ErrorContainer error;
+
+    const std::string kernelCode =
+        "__kernel void add(\n"
+        "       __global const float* a,\n"
+        "       __global float* b\n"
+        "       )\n"
+        "{\n"
+        "    size_t globalId = get_global_id(0);\n"
+        "    b[globalId] = a[globalId] + 1.0f;\n"
+        "}\n"
+        "__kernel void mult(\n"
+        "       __global const float* a,\n"
+        "       __global float* b\n"
+        "       )\n"
+        "{\n"
+        "    size_t globalId = get_global_id(0);\n"
+        "    b[globalId] = b[globalId] * a[globalId];\n"
+        "}\n";
+
+    Kitsunemimi::GpuHandler oclHandler;
+    assert(oclHandler.initDevice(error));
+    Kitsunemimi::GpuInterface* ocl = oclHandler.m_interfaces.at(0);
+
+    Kitsunemimi::GpuData data;
+    data.numberOfWg.x = testSize / 64;
+    data.threadsPerWg.x = 64;
+
+    data.addBuffer("a", testSize, sizeof(float), false);
+    data.addBuffer("b", testSize, sizeof(float), false);
+    float* a = static_cast<float*>(data.getBufferData("a"));
+
+    TEST_EQUAL(ocl->initCopyToDevice(data, error), true)
+    TEST_EQUAL(ocl->addKernels(data, kernelCode, error), true)
+    TEST_EQUAL(ocl->bindKernelToBuffer(data, "add", "a", error), true)
+    TEST_EQUAL(ocl->bindKernelToBuffer(data, "add", "b", error), true)
+    TEST_EQUAL(ocl->bindKernelToBuffer(data, "mult", "a", error), true)
+    TEST_EQUAL(ocl->bindKernelToBuffer(data, "mult", "b", error), true)
+
+    // record graph
+    Kitsunemimi::GpuCommandGraph graph(ocl, &data);
+    const uint32_t update = graph.addUpdate("a", error);
+    const uint32_t add = graph.addRun("add", error, {update});
+    const uint32_t mult = graph.addRun("mult", error, {add});
+    TEST_NOT_EQUAL(graph.addCopyFromDevice("b", error, {mult}),
+                   Kitsunemimi::GpuCommandGraph::INVALID_STEP)
+    TEST_EQUAL(graph.addRun("fail", error), Kitsunemimi::GpuCommandGraph::INVALID_STEP)
+    TEST_EQUAL(graph.addRun("add", error, {42}), Kitsunemimi::GpuCommandGraph::INVALID_STEP)
+    TEST_EQUAL(graph.getNumberOfSteps(), 4)
+
+    // replay graph multiple times with different input
+    float* outputValues = static_cast<float*>(data.getBufferData("b"));
+    for(uint32_t run = 1; run <= 3; run++)
+    {
+        for(uint32_t i = 0; i < testSize; i++) {
+            a[i] = static_cast<float>(run);
+        }
+
+        TEST_EQUAL(graph.launchAndWait(error), true)
+        TEST_EQUAL(outputValues[42], static_cast<float>((run + 1) * run))
+    }
+
+    TEST_EQUAL(ocl->closeDevice(data), true)
+
+    // skipped update of a host-pointer-buffer keeps the dependency between the kernels
+    Kitsunemimi::GpuData hostData;
+    hostData.numberOfWg.x = testSize / 64;
+    hostData.threadsPerWg.x = 64;
+
+    hostData.addBuffer("a", testSize, sizeof(float), true);
+    hostData.addBuffer("b", testSize, sizeof(float), false);
+    a = static_cast<float*>(hostData.getBufferData("a"));
+    for(uint32_t i = 0; i < testSize; i++) {
+        a[i] = 2.0f;
+    }
+
+    TEST_EQUAL(ocl->initCopyToDevice(hostData, error), true)
+    TEST_EQUAL(ocl->addKernels(hostData, kernelCode, error), true)
+    TEST_EQUAL(ocl->bindKernelToBuffer(hostData, "add", "a", error), true)
+    TEST_EQUAL(ocl->bindKernelToBuffer(hostData, "add", "b", error), true)
+    TEST_EQUAL(ocl->bindKernelToBuffer(hostData, "mult", "a", error), true)
+    TEST_EQUAL(ocl->bindKernelToBuffer(hostData, "mult", "b", error), true)
+
+    Kitsunemimi::GpuCommandGraph hostGraph(ocl, &hostData);
+    const uint32_t hostAdd = hostGraph.addRun("add", error);
+    const uint32_t hostUpdate = hostGraph.addUpdate("a", error, {hostAdd});
+    const uint32_t hostMult = hostGraph.addRun("mult", error, {hostUpdate});
+    TEST_NOT_EQUAL(hostGraph.addCopyFromDevice("b", error, {hostMult}),
+                   Kitsunemimi::GpuCommandGraph::INVALID_STEP)
+
+    TEST_EQUAL(hostGraph.launchAndWait(error), true)
+    outputValues = static_cast<float*>(hostData.getBufferData("b"));
+    TEST_EQUAL(outputValues[42], 6.0f)
+
+    TEST_EQUAL(ocl->closeDevice(hostData), true)
+}
+
+void
+SimpleTest::partial_copy_test()
+{
+    const size_t width = 64;
+    const size_t height = 64;
+    ErrorContainer error;
+
+    Kitsunemimi::GpuHandler oclHandler;
+    assert(oclHandler.initDevice(error));
+    Kitsunemimi::GpuInterface* ocl = oclHandler.m_interfaces.at(0);
+
+    Kitsunemimi::GpuData data;
+    data.addBuffer("matrix", width * height, sizeof(float), false);
+    float* matrix = static_cast<float*>(data.getBufferData("matrix"));
+    for(uint32_t i = 0; i < width * height; i++) {
+        matrix[i] = 1.0f;
+    }
+
+    TEST_EQUAL(ocl->initCopyToDevice(data, error), true)
+
+    // update a tile of 8x4 values within the matrix
+    Kitsunemimi::BufferRegion tile;
+    tile.origin = {16, 8, 0};
+    tile.size = {8, 4, 1};
+    tile.rowPitch = width;
+    for(uint32_t i = 0; i < width * height; i++) {
+        matrix[i] = 2.0f;
+    }
+    TEST_EQUAL(ocl->updateRegionOnDevice(data, "matrix", tile, error), true)
+
+    // read back only the tile
+    for(uint32_t i = 0; i < width * height; i++) {
+        matrix[i] = 0.0f;
+    }
+    TEST_EQUAL(ocl->copyRegionFromDevice(data, "matrix", tile, error), true)
+    TEST_EQUAL(matrix[8 * width + 16], 2.0f)
+    TEST_EQUAL(matrix[11 * width + 23], 2.0f)
+    TEST_EQUAL(matrix[11 * width + 24], 0.0f)
+    TEST_EQUAL(matrix[12 * width + 16], 0.0f)
+
+    // read back only a single row before the tile
+    TEST_EQUAL(ocl->copyFromDevice(data, "matrix", error, width, 7 * width), true)
+    TEST_EQUAL(matrix[7 * width + 16], 1.0f)
+    TEST_EQUAL(matrix[6 * width + 16], 0.0f)
+    TEST_EQUAL(matrix[8 * width], 0.0f)
+
+    // check invalid ranges
+    TEST_EQUAL(ocl->copyFromDevice(data, "matrix", error, width, width * height), false)
+    tile.origin = {60, 8, 0};
+    TEST_EQUAL(ocl->copyRegionFromDevice(data, "matrix", tile, error), false)
+
+    TEST_EQUAL(ocl->closeDevice(data), true)
+}
+
+void
+SimpleTest::stream_executor_test()
+{
+    const size_t testSize = 100000;
+    ErrorContainer error;
+
+    const std::string kernelCode =
+        "__kernel void mult(\n"
+        "       __global const float* a,\n"
+        "       __global float* b\n"
+        "       )\n"
+        "{\n"
+        "    size_t globalId = get_global_id(0);\n"
+        "    b[globalId] = a[globalId] * 2.0f;\n"
+        "}\n";
+
+    Kitsunemimi::GpuHandler oclHandler;
+    assert(oclHandler.initDevice(error));
+    Kitsunemimi::GpuInterface* ocl = oclHandler.m_interfaces.at(0);
+
+    std::vector<float> input(testSize);
+    std::vector<float> output(testSize, 0.0f);
+    for(uint32_t i = 0; i < testSize; i++) {
+        input[i] = static_cast<float>(i % 100);
+    }
+
+    Kitsunemimi::GpuStreamExecutor executor(ocl);
+    TEST_EQUAL(executor.addInput("a", input.data(), testSize, sizeof(float)), true)
+    TEST_EQUAL(executor.addInput("a", input.data(), testSize, sizeof(float)), false)
+    TEST_EQUAL(executor.addOutput("b", output.data(), testSize - 1, sizeof(float)), false)
+    TEST_EQUAL(executor.addOutput("b", output.data(), testSize, sizeof(float)), true)
+
+    // force small chunks to get multiple chunks and a padded last chunk
+    TEST_EQUAL(executor.init("mult", kernelCode, error, 4096), true)
+    TEST_EQUAL(executor.getNumberOfChunks() > 1, true)
+    TEST_EQUAL(executor.run(error), true)
+
+    TEST_EQUAL(output[42], 84.0f)
+    TEST_EQUAL(output[testSize - 1], 198.0f)
+
+    TEST_EQUAL(executor.close(), true)
+    TEST_EQUAL(ocl->useSeparateQueues(), false)
+
+    // same with overlapping transfers and kernels
+    TEST_EQUAL(ocl->enableSeparateQueues(1, error), true)
+    std::fill(output.begin(), output.end(), 0.0f);
+    TEST_EQUAL(executor.init("mult", kernelCode, error, 4096), true)
+    TEST_EQUAL(executor.run(error), true)
+
+    TEST_EQUAL(output[42], 84.0f)
+    TEST_EQUAL(output[testSize - 1], 198.0f)
+
+    TEST_EQUAL(executor.close(), true)
+}
+
+void
+SimpleTest::pinned_memory_test()
+{
+    const size_t testSize = 1 << 16;
+    ErrorContainer error;
+
+    const std::string kernelCode =
+        "__kernel void add(\n"
+        "       __global const float* a,\n"
+        "       __global float* b\n"
+        "       )\n"
+        "{\n"
+        "    size_t globalId = get_global_id(0);\n"
+        "    b[globalId] = a[globalId] + 1.0f;\n"
+        "}\n";
+
+    Kitsunemimi::GpuHandler oclHandler;
+    assert(oclHandler.initDevice(error));
+    Kitsunemimi::GpuInterface* ocl = oclHandler.m_interfaces.at(0);
+
+    void* firstPointer = nullptr;
+    for(uint32_t cycle = 0; cycle < 2; cycle++)
+    {
+        Kitsunemimi::GpuData data;
+        data.numberOfWg.x = testSize / 64;
+        data.threadsPerWg.x = 64;
+
+        TEST_EQUAL(ocl->addPinnedBuffer(data, "a", testSize, sizeof(float), error), true)
+        TEST_EQUAL(ocl->addPinnedBuffer(data, "a", testSize, sizeof(float), error), false)
+        TEST_EQUAL(ocl->addPinnedBuffer(data, "b", testSize, sizeof(float), error), true)
+
+        // pinned memory has to be reused in the second cycle
+        float* a = static_cast<float*>(data.getBufferData("a"));
+        if(cycle == 0) {
+            firstPointer = a;
+        } else {
+            TEST_EQUAL(firstPointer == a || firstPointer == data.getBufferData("b"), true)
+        }
+
+        for(uint32_t i = 0; i < testSize; i++) {
+            a[i] = static_cast<float>(cycle);
+        }
+
+        TEST_EQUAL(ocl->initCopyToDevice(data, error), true)
+        TEST_EQUAL(ocl->addKernel(data, "add", kernelCode, error), true)
+        TEST_EQUAL(ocl->bindKernelToBuffer(data, "add", "a", error), true)
+        TEST_EQUAL(ocl->bindKernelToBuffer(data, "add", "b", error), true)
+        TEST_EQUAL(ocl->run(data, "add", error), true)
+        TEST_EQUAL(ocl->copyFromDevice(data, "b", error), true)
+
+        float* outputValues = static_cast<float*>(data.getBufferData("b"));
+        TEST_EQUAL(outputValues[42], static_cast<float>(cycle + 1))
+
+        TEST_EQUAL(ocl->closeDevice(data), true)
+    }
+}
+
+void
+SimpleTest::map_test()
+{
+    const size_t testSize = 1 << 16;
+    ErrorContainer error;
+
+    const std::string kernelCode =
+        "__kernel void add(\n"
+        "       __global const float* a,\n"
+        "       __global float* b\n"
+        "       )\n"
+        "{\n"
+        "    size_t globalId = get_global_id(0);\n"
+        "    b[globalId] = a[globalId] + 1.0f;\n"
+        "}\n";
+
+    Kitsunemimi::GpuHandler oclHandler;
+    assert(oclHandler.initDevice(error));
+    Kitsunemimi::GpuInterface* ocl = oclHandler.m_interfaces.at(0);
+
+    Kitsunemimi::GpuData data;
+    data.numberOfWg.x = testSize / 64;
+    data.threadsPerWg.x = 64;
+
+    data.addBuffer("a", testSize, sizeof(float), true);
+    data.addBuffer("b", testSize, sizeof(float), true);
+
+    TEST_EQUAL(ocl->initCopyToDevice(data, error), true)
+    TEST_EQUAL(ocl->addKernel(data, "add", kernelCode, error), true)
+    TEST_EQUAL(ocl->bindKernelToBuffer(data, "add", "a", error), true)
+    TEST_EQUAL(ocl->bindKernelToBuffer(data, "add", "b", error), true)
+
+    // write input over the mapped memory
+    float* a = static_cast<float*>(ocl->mapBuffer(data, "a", Kitsunemimi::MAP_WRITE_INVALIDATE, error));
+    TEST_NOT_EQUAL(a, nullptr)
+    TEST_EQUAL(ocl->mapBuffer(data, "a", Kitsunemimi::MAP_READ, error) == nullptr, true)
+    for(uint32_t i = 0; i < testSize; i++) {
+        a[i] = 2.0f;
+    }
+    TEST_EQUAL(ocl->unmapBuffer(data, "a", error), true)
+    TEST_EQUAL(ocl->unmapBuffer(data, "a", error), false)
+
+    TEST_EQUAL(ocl->run(data, "add", error), true)
+
+    // read output over the mapped memory
+    float* b = static_cast<float*>(ocl->mapBuffer(data, "b", Kitsunemimi::MAP_READ, error));
+    TEST_NOT_EQUAL(b, nullptr)
+    TEST_EQUAL(b[42], 3.0f)
+    TEST_EQUAL(ocl->unmapBuffer(data, "b", error), true)
+
+    // update and copy over the host-pointer of the buffer
+    float* hostA = static_cast<float*>(data.getBufferData("a"));
+    for(uint32_t i = 0; i < testSize; i++) {
+        hostA[i] = 5.0f;
+    }
+    TEST_EQUAL(ocl->updateBufferOnDevice(data, "a", error), true)
+    TEST_EQUAL(ocl->run(data, "add", error), true)
+    TEST_EQUAL(ocl->copyFromDevice(data, "b", error), true)
+
+    float* outputValues = static_cast<float*>(data.getBufferData("b"));
+    TEST_EQUAL(outputValues[42], 6.0f)
+
+    // still mapped buffer are unmapped by closing
+    TEST_NOT_EQUAL(ocl->mapBuffer(data, "a", Kitsunemimi::MAP_READ, error), nullptr)
+    TEST_EQUAL(ocl->closeDevice(data), true)
+}
+
+void
+SimpleTest::buffer_pool_test()
+{
+    const size_t testSize = 1 << 16;
+    ErrorContainer error;
+
+    const std::string kernelCode =
+        "__kernel void add(\n"
+        "       __global const float* a,\n"
+        "       __global float* b\n"
+        "       )\n"
+        "{\n"
+        "    size_t globalId = get_global_id(0);\n"
+        "    b[globalId] = a[globalId] + 1.0f;\n"
+        "}\n";
+
+    Kitsunemimi::GpuHandler oclHandler;
+    assert(oclHandler.initDevice(error));
+    Kitsunemimi::GpuInterface* ocl = oclHandler.m_interfaces.at(0);
+    Kitsunemimi::BufferPool* pool = ocl->getBufferPool();
+
+    void* firstPointer = nullptr;
+    for(uint32_t cycle = 0; cycle < 2; cycle++)
+    {
+        Kitsunemimi::GpuData data(pool);
+        data.numberOfWg.x = testSize / 64;
+        data.threadsPerWg.x = 64;
+
+        data.addBuffer("a", testSize, sizeof(float), false);
+        data.addBuffer("b", testSize, sizeof(float), false);
+
+        // memory of the first cycle has to be reused in the second cycle
+        float* a = static_cast<float*>(data.getBufferData("a"));
+        if(cycle == 0) {
+            firstPointer = a;
+        } else {
+            TEST_EQUAL(firstPointer == a || firstPointer == data.getBufferData("b"), true)
+        }
+
+        for(uint32_t i = 0; i < testSize; i++) {
+            a[i] = static_cast<float>(cycle);
+        }
+
+        TEST_EQUAL(ocl->initCopyToDevice(data, error), true)
+        TEST_EQUAL(pool->getNumberOfPooledDeviceBuffers(), 0)
+        TEST_EQUAL(ocl->addKernel(data, "add", kernelCode, error), true)
+        TEST_EQUAL(ocl->bindKernelToBuffer(data, "add", "a", error), true)
+        TEST_EQUAL(ocl->bindKernelToBuffer(data, "add", "b", error), true)
+        TEST_EQUAL(ocl->run(data, "add", error), true)
+        TEST_EQUAL(ocl->copyFromDevice(data, "b", error), true)
+
+        float* outputValues = static_cast<float*>(data.getBufferData("b"));
+        TEST_EQUAL(outputValues[42], static_cast<float>(cycle + 1))
+
+        TEST_EQUAL(ocl->closeDevice(data), true)
+        TEST_EQUAL(pool->getNumberOfPooledDeviceBuffers(), 2)
+        TEST_EQUAL(pool->getNumberOfPooledHostBuffers(), 2)
+    }
+
+    // host-memory of data-objects without pool is freed and doesn't grow the pool
+    const uint64_t hostBytes = pool->getNumberOfPooledHostBytes();
+    const uint64_t deviceBytes = pool->getNumberOfPooledDeviceBytes();
+    for(uint32_t cycle = 0; cycle < 4; cycle++)
+    {
+        Kitsunemimi::GpuData data;
+        data.numberOfWg.x = testSize / 64;
+        data.threadsPerWg.x = 64;
+        data.addBuffer("a", testSize, sizeof(float), false);
+        data.addBuffer("b", testSize, sizeof(float), false);
+
+        TEST_EQUAL(ocl->initCopyToDevice(data, error), true)
+        TEST_EQUAL(ocl->closeDevice(data), true)
+        TEST_EQUAL(pool->getNumberOfPooledHostBytes(), hostBytes)
+        TEST_EQUAL(pool->getNumberOfPooledDeviceBytes(), deviceBytes)
+    }
+
+    // limit and trim
+    pool->setLimits(testSize * sizeof(float), 0);
+    TEST_EQUAL(pool->getNumberOfPooledHostBuffers(), 1)
+    pool->trim();
+    TEST_EQUAL(pool->getNumberOfPooledHostBytes(), 0)
+    TEST_EQUAL(pool->getNumberOfPooledDeviceBytes(), 0)
+    TEST_EQUAL(pool->getNumberOfPooledDeviceBuffers(), 0)
+}
+
+void
+SimpleTest::arena_test()
+{
+    const size_t testSize = 1 << 10;
+    ErrorContainer error;
+
+    const std::string kernelCode =
+        "__kernel void scale(\n"
+        "       __global const float* factor,\n"
+        "       __global const float* a,\n"
+        "       __global float* b\n"
+        "       )\n"
+        "{\n"
+        "    size_t globalId = get_global_id(0);\n"
+        "    b[globalId] = a[globalId] * factor[0];\n"
+        "}\n";
+
+    Kitsunemimi::GpuHandler oclHandler;
+    assert(oclHandler.initDevice(error));
+    Kitsunemimi::GpuInterface* ocl = oclHandler.m_interfaces.at(0);
+
+    Kitsunemimi::GpuData data;
+    data.numberOfWg.x = testSize / 64;
+    data.threadsPerWg.x = 64;
+
+    std::vector<Kitsunemimi::ArenaEntry> entries(3);
+    entries[0].name = "factor";
+    entries[0].numberOfObjects = 1;
+    entries[0].objectSize = sizeof(float);
+    entries[1].name = "a";
+    entries[1].numberOfObjects = testSize;
+    entries[1].objectSize = sizeof(float);
+    entries[2].name = "b";
+    entries[2].numberOfObjects = testSize;
+    entries[2].objectSize = sizeof(float);
+
+    TEST_EQUAL(ocl->addArena(data, "params", entries, error), true)
+    TEST_EQUAL(ocl->addArena(data, "params2", entries, error), false)
+
+    float* factor = static_cast<float*>(data.getBufferData("factor"));
+    float* a = static_cast<float*>(data.getBufferData("a"));
+    factor[0] = 2.0f;
+    for(uint32_t i = 0; i < testSize; i++) {
+        a[i] = 3.0f;
+    }
+
+    TEST_EQUAL(ocl->initCopyToDevice(data, error), true)
+    TEST_EQUAL(ocl->addKernel(data, "scale", kernelCode, error), true)
+    TEST_EQUAL(ocl->bindKernelToBuffer(data, "scale", "factor", error), true)
+    TEST_EQUAL(ocl->bindKernelToBuffer(data, "scale", "a", error), true)
+    TEST_EQUAL(ocl->bindKernelToBuffer(data, "scale", "b", error), true)
+    TEST_EQUAL(ocl->run(data, "scale", error), true)
+    TEST_EQUAL(ocl->copyFromDevice(data, "b", error), true)
+
+    float* outputValues = static_cast<float*>(data.getBufferData("b"));
+    TEST_EQUAL(outputValues[42], 6.0f)
+
+    // update adjacent buffer with one transfer
+    factor[0] = 3.0f;
+    for(uint32_t i = 0; i < testSize; i++) {
+        a[i] = 4.0f;
+    }
+    TEST_EQUAL(ocl->updateBuffersOnDevice(data, {"a", "factor"}, error), true)
+    TEST_EQUAL(ocl->updateBuffersOnDevice(data, {"c"}, error), false)
+    TEST_EQUAL(ocl->run(data, "scale", error), true)
+    TEST_EQUAL(ocl->copyFromDevice(data, "b", error), true)
+    TEST_EQUAL(outputValues[42], 12.0f)
+
+    TEST_EQUAL(ocl->closeDevice(data), true)
+}
+
+void
+SimpleTest::handle_test()
+{
+    const size_t testSize = 1 << 16;
+    ErrorContainer error;
+
+    const std::string kernelCode =
+        "__kernel void add(\n"
+        "       __global const float* a,\n"
+        "       __global float* b\n"
+        "       )\n"
+        "{\n"
+        "    size_t globalId = get_global_id(0);\n"
+        "    b[globalId] = a[globalId] + 1.0f;\n"
+        "}\n";
+
+    Kitsunemimi::GpuHandler oclHandler;
+    assert(oclHandler.initDevice(error));
+    Kitsunemimi::GpuInterface* ocl = oclHandler.m_interfaces.at(0);
+
+    Kitsunemimi::GpuData data;
+    data.numberOfWg.x = testSize / 64;
+    data.threadsPerWg.x = 64;
+
+    data.addBuffer("a", testSize, sizeof(float), false);
+    data.addBuffer("b", testSize, sizeof(float), false);
+
+    TEST_EQUAL(ocl->initCopyToDevice(data, error), true)
+    TEST_EQUAL(ocl->addKernel(data, "add", kernelCode, error), true)
+    TEST_EQUAL(ocl->bindKernelToBuffer(data, "add", "a", error), true)
+    TEST_EQUAL(ocl->bindKernelToBuffer(data, "add", "b", error), true)
+
+    // get handles
+    const Kitsunemimi::BufferHandle handleA = data.getBufferHandle("a");
+    const Kitsunemimi::BufferHandle handleB = data.getBufferHandle("b");
+    const Kitsunemimi::KernelHandle handleAdd = data.getKernelHandle("add");
+    TEST_EQUAL(data.getBufferHandle("a").id, handleA.id)
+    TEST_NOT_EQUAL(handleA.id, handleB.id)
+    TEST_EQUAL(data.getBufferHandle("c").id, 0xFFFFFFFF)
+    TEST_EQUAL(data.getKernelHandle("sub").id, 0xFFFFFFFF)
+
+    // run loop only with handles
+    float* a = static_cast<float*>(data.getBufferData("a"));
+    float* outputValues = static_cast<float*>(data.getBufferData("b"));
+    for(uint32_t cycle = 0; cycle < 3; cycle++)
+    {
+        a[42] = static_cast<float>(cycle);
+        TEST_EQUAL(ocl->updateBufferOnDevice(data, handleA, error), true)
+        TEST_EQUAL(ocl->run(data, handleAdd, error), true)
+        TEST_EQUAL(ocl->copyFromDevice(data, handleB, error), true)
+        TEST_EQUAL(outputValues[42], static_cast<float>(cycle + 1))
+    }
+
+    // handles of buffer are invalid after closing
+    TEST_EQUAL(ocl->closeDevice(data), true)
+    TEST_EQUAL(ocl->copyFromDevice(data, handleB, error), false)
+}
+
+void
+SimpleTest::profiling_test()
+{
+    const size_t testSize = 1 << 16;
+    ErrorContainer error;
+
+    const std::string kernelCode =
+        "__kernel void add(\n"
+        "       __global const float* a,\n"
+        "       __global float* b\n"
+        "       )\n"
+        "{\n"
+        "    size_t globalId = get_global_id(0);\n"
+        "    b[globalId] = a[globalId] + 1.0f;\n"
+        "}\n";
+
+    Kitsunemimi::GpuHandler oclHandler;
+    assert(oclHandler.initDevice(error));
+    Kitsunemimi::GpuInterface* ocl = oclHandler.m_interfaces.at(0);
+
+    Kitsunemimi::ProfilingStats stats;
+    TEST_EQUAL(ocl->getProfilingStats(Kitsunemimi::PROFILE_KERNEL, "add", stats, error), false)
+    TEST_EQUAL(ocl->enableProfiling(error), true)
+
+    Kitsunemimi::GpuData data;
+    data.numberOfWg.x = testSize / 64;
+    data.threadsPerWg.x = 64;
+
+    data.addBuffer("a", testSize, sizeof(float), false);
+    data.addBuffer("b", testSize, sizeof(float), false);
+
+    TEST_EQUAL(ocl->initCopyToDevice(data, error), true)
+    TEST_EQUAL(ocl->addKernel(data, "add", kernelCode, error), true)
+    TEST_EQUAL(ocl->bindKernelToBuffer(data, "add", "a", error), true)
+    TEST_EQUAL(ocl->bindKernelToBuffer(data, "add", "b", error), true)
+
+    for(uint32_t i = 0; i < 10; i++)
+    {
+        TEST_EQUAL(ocl->updateBufferOnDevice(data, "a", error), true)
+        TEST_EQUAL(ocl->run(data, "add", error), true)
+        TEST_EQUAL(ocl->copyFromDevice(data, "b", error), true)
+    }
+
+    // kernel
+    TEST_EQUAL(ocl->getProfilingStats(Kitsunemimi::PROFILE_KERNEL, "add", stats, error), true)
+    TEST_EQUAL(stats.count, 10)
+    TEST_EQUAL(stats.minTime <= stats.p50Time, true)
+    TEST_EQUAL(stats.p50Time <= stats.p99Time, true)
+
+    // transfers, including the initial copy
+    TEST_EQUAL(ocl->getProfilingStats(Kitsunemimi::PROFILE_WRITE, "a", stats, error), true)
+    TEST_EQUAL(stats.count, 11)
+    TEST_EQUAL(ocl->getProfilingStats(Kitsunemimi::PROFILE_READ, "b", stats, error), true)
+    TEST_EQUAL(stats.count, 10)
+    TEST_EQUAL(stats.numberOfBytes, 10 * testSize * sizeof(float))
+    TEST_EQUAL(stats.bytesPerSecond > 0.0, true)
+
+    ocl->resetProfiling();
+    TEST_EQUAL(ocl->getProfilingStats(Kitsunemimi::PROFILE_KERNEL, "add", stats, error), false)
+
+    TEST_EQUAL(ocl->closeDevice(data), true)
+}
+
+void
+SimpleTest::tracing_test()
+{
+    const size_t testSize = 1 << 16;
+    const std::string traceFile = "/tmp/libKitsunemimiOpencl_trace_test.json";
+    ErrorContainer error;
+
+    const std::string kernelCode =
+        "__kernel void add(\n"
+        "       __global const float* a,\n"
+        "       __global float* b\n"
+        "       )\n"
+        "{\n"
+        "    size_t globalId = get_global_id(0);\n"
+        "    b[globalId] = a[globalId] + 1.0f;\n"
+        "}\n";
+
+    Kitsunemimi::GpuHandler oclHandler;
+    assert(oclHandler.initDevice(error));
+    Kitsunemimi::GpuInterface* ocl = oclHandler.m_interfaces.at(0);
+
+    TEST_EQUAL(ocl->writeTrace(traceFile, error), false)
+    TEST_EQUAL(ocl->enableTracing(error), true)
+
+    Kitsunemimi::GpuData data;
+    data.numberOfWg.x = testSize / 64;
+    data.threadsPerWg.x = 64;
+
+    data.addBuffer("a", testSize, sizeof(float), false);
+    data.addBuffer("b", testSize, sizeof(float), false);
+
+    TEST_EQUAL(ocl->initCopyToDevice(data, error), true)
+    TEST_EQUAL(ocl->addKernel(data, "add", kernelCode, error), true)
+    TEST_EQUAL(ocl->bindKernelToBuffer(data, "add", "a", error), true)
+    TEST_EQUAL(ocl->bindKernelToBuffer(data, "add", "b", error), true)
+    TEST_EQUAL(ocl->updateBufferOnDevice(data, "a", error), true)
+    TEST_EQUAL(ocl->run(data, "add", error), true)
+    TEST_EQUAL(ocl->copyFromDevice(data, "b", error), true)
+
+    TEST_EQUAL(ocl->writeTrace(traceFile, error), true)
+
+    // check content of the trace
+    std::ifstream file(traceFile);
+    std::stringstream content;
+    content<<file.rdbuf();
+    const std::string trace = content.str();
+    TEST_NOT_EQUAL(trace.find("\"initCopyToDevice a\""), std::string::npos)
+    TEST_NOT_EQUAL(trace.find("\"updateBufferOnDevice a\""), std::string::npos)
+    TEST_NOT_EQUAL(trace.find("\"run add\""), std::string::npos)
+    TEST_NOT_EQUAL(trace.find("\"copyFromDevice b\""), std::string::npos)
+
+    TEST_EQUAL(ocl->closeDevice(data), true)
+    std::filesystem::remove(traceFile);
+}
+
+
+void
+SimpleTest::workgroup_tuning_test()
+{
+    const size_t testSize = 1 << 16;
+    const std::string tuningDir = "/tmp/libKitsunemimiOpencl_tuning_test";
+    std::filesystem::remove_all(tuningDir);
+    Kitsunemimi::ErrorContainer error;
+
+    const std::string kernelCode =
+        "__kernel void add(\n"
+        "       __global const float* a,\n"
+        "       __global float* b\n"
+        "       )\n"
+        "{\n"
+        "    size_t globalId = get_global_id(0);\n"
+        "    b[globalId] = a[globalId] + 1.0f;\n"
+        "}\n";
+
+    Kitsunemimi::GpuHandler oclHandler;
+    assert(oclHandler.initDevice(error));
+    Kitsunemimi::GpuInterface* ocl = oclHandler.m_interfaces.at(0);
+
+    TEST_EQUAL(ocl->enableWorkGroupTuning(tuningDir, error), true)
+
+    Kitsunemimi::GpuData data;
+    data.numberOfWg.x = testSize;
+    data.threadsPerWg.x = 1;
+
+    data.addBuffer("a", testSize, sizeof(float), false);
+    data.addBuffer("b", testSize, sizeof(float), false);
+
+    float* a = static_cast<float*>(data.getBufferData("a"));
+    for(uint32_t i = 0; i < testSize; i++) {
+        a[i] = 1.0f;
+    }
+
+    TEST_EQUAL(ocl->initCopyToDevice(data, error), true)
+    TEST_EQUAL(ocl->addKernel(data, "add", kernelCode, error), true)
+    TEST_EQUAL(ocl->bindKernelToBuffer(data, "add", "a", error), true)
+    TEST_EQUAL(ocl->bindKernelToBuffer(data, "add", "b", error), true)
+
+    TEST_EQUAL(ocl->tuneWorkGroupSize(data, "unknown", error), false)
+    TEST_EQUAL(ocl->tuneWorkGroupSize(data, "add", error), true)
+
+    // total number of threads must be unchanged
+    TEST_EQUAL(data.numberOfWg.x * data.threadsPerWg.x, testSize)
+    const uint64_t tunedSize = data.threadsPerWg.x;
+
+    // second data-object gets the stored result
+    Kitsunemimi::GpuData data2;
+    data2.numberOfWg.x = testSize;
+    data2.threadsPerWg.x = 1;
+    data2.addBuffer("a", testSize, sizeof(float), false);
+    data2.addBuffer("b", testSize, sizeof(float), false);
+
+    TEST_EQUAL(ocl->initCopyToDevice(data2, error), true)
+    TEST_EQUAL(ocl->addKernel(data2, "add", kernelCode, error), true)
+    TEST_EQUAL(ocl->bindKernelToBuffer(data2, "add", "a", error), true)
+    TEST_EQUAL(ocl->bindKernelToBuffer(data2, "add", "b", error), true)
+    TEST_EQUAL(ocl->tuneWorkGroupSize(data2, "add", error), true)
+    TEST_EQUAL(data2.threadsPerWg.x, tunedSize)
+
+    // the stored result is also applied, when the range is calculated for the same sizes
+    Kitsunemimi::WorkerDim problemSize;
+    problemSize.x = testSize;
+    TEST_EQUAL(ocl->calculateRange(data2, "add", problemSize, error), true)
+    TEST_EQUAL(data2.threadsPerWg.x, tunedSize)
+    TEST_EQUAL(data2.numberOfWg.x * data2.threadsPerWg.x, testSize)
+
+    // run with the tuned size
+    TEST_EQUAL(ocl->updateBufferOnDevice(data, "a", error), true)
+    TEST_EQUAL(ocl->run(data, "add", error), true)
+    TEST_EQUAL(ocl->copyFromDevice(data, "b", error), true)
+
+    float* b = static_cast<float*>(data.getBufferData("b"));
+    TEST_EQUAL(b[0], 2.0f)
+    TEST_EQUAL(b[testSize - 1], 2.0f)
+
+    TEST_EQUAL(ocl->closeDevice(data), true)
+    TEST_EQUAL(ocl->closeDevice(data2), true)
+    std::filesystem::remove_all(tuningDir);
+}
+
+
+void
+SimpleTest::launch_test()
+{
+    const size_t testSize = 1000;
+    Kitsunemimi::ErrorContainer error;
+
+    // the problem-size is no multiple of the work-group size, so the kernel has to ignore the
+    // padding work-items
+    const std::string kernelCode =
+        "__kernel void add(\n"
+        "       __global const float* a,\n"
+        "       __global float* b\n"
+        "       )\n"
+        "{\n"
+        "    size_t globalId = get_global_id(0);\n"
+        "    if(globalId < 1000)\n"
+        "        b[globalId] = a[globalId] + 1.0f;\n"
+        "}\n";
+
+    Kitsunemimi::GpuHandler oclHandler;
+    assert(oclHandler.initDevice(error));
+    Kitsunemimi::GpuInterface* ocl = oclHandler.m_interfaces.at(0);
+
+    Kitsunemimi::GpuData data;
+    data.addBuffer("a", testSize, sizeof(float), false);
+    data.addBuffer("b", testSize, sizeof(float), false);
+
+    float* a = static_cast<float*>(data.getBufferData("a"));
+    for(uint32_t i = 0; i < testSize; i++) {
+        a[i] = static_cast<float>(i);
+    }
+
+    TEST_EQUAL(ocl->initCopyToDevice(data, error), true)
+    TEST_EQUAL(ocl->addKernel(data, "add", kernelCode, error), true)
+    TEST_EQUAL(ocl->bindKernelToBuffer(data, "add", "a", error), true)
+    TEST_EQUAL(ocl->bindKernelToBuffer(data, "add", "b", error), true)
+
+    // check calculated range
+    Kitsunemimi::WorkerDim problemSize;
+    problemSize.x = testSize;
+    TEST_EQUAL(ocl->calculateRange(data, "add", problemSize, error), true)
+    TEST_EQUAL(data.numberOfWg.x * data.threadsPerWg.x >= testSize, true)
+    TEST_EQUAL((data.numberOfWg.x - 1) * data.threadsPerWg.x < testSize, true)
+    TEST_EQUAL(data.threadsPerWg.y, 1)
+    TEST_EQUAL(data.threadsPerWg.z, 1)
+
+    Kitsunemimi::WorkerDim emptySize;
+    emptySize.x = 0;
+    TEST_EQUAL(ocl->calculateRange(data, "add", emptySize, error), false)
+    TEST_EQUAL(ocl->launch(data, "unknown", problemSize, error), false)
+
+    // process the problem in two parts with an offset for the second part
+    Kitsunemimi::WorkerDim halfSize;
+    halfSize.x = testSize / 2;
+    Kitsunemimi::WorkerDim offset = {0, 0, 0};
+    offset.x = testSize / 2;
+
+    TEST_EQUAL(ocl->updateBufferOnDevice(data, "a", error), true)
+    TEST_EQUAL(ocl->launch(data, "add", halfSize, error), true)
+    TEST_EQUAL(ocl->launch(data, "add", halfSize, error, offset), true)
+    TEST_EQUAL(data.globalOffset.x, testSize / 2)
+    TEST_EQUAL(ocl->copyFromDevice(data, "b", error), true)
+
+    float* b = static_cast<float*>(data.getBufferData("b"));
+    TEST_EQUAL(b[0], 1.0f)
+    TEST_EQUAL(b[testSize / 2 - 1], static_cast<float>(testSize / 2))
+    TEST_EQUAL(b[testSize / 2], static_cast<float>(testSize / 2 + 1))
+    TEST_EQUAL(b[testSize - 1], static_cast<float>(testSize))
+
+    TEST_EQUAL(ocl->closeDevice(data), true)
+}
+
+
+void
+SimpleTest::work_splitter_test()
+{
+    const size_t testSize = 100000;
+    ErrorContainer error;
+
+    const std::string kernelCode =
+        "__kernel void mult(\n"
+        "       __global const float* a,\n"
+        "       __global float* b\n"
+        "       )\n"
+        "{\n"
+        "    size_t globalId = get_global_id(0);\n"
+        "    b[globalId] = a[globalId] * 2.0f;\n"
+        "}\n";
+
+    Kitsunemimi::GpuHandler oclHandler;
+    assert(oclHandler.initDevice(error));
+
+    // use a second interface for the first device, so the work is split even on systems with
+    // only one device
+    Kitsunemimi::GpuInterface secondInterface(oclHandler.m_interfaces.at(0)->m_device);
+    std::vector<Kitsunemimi::GpuInterface*> interfaces = oclHandler.m_interfaces;
+    interfaces.push_back(&secondInterface);
+
+    std::vector<float> input(testSize);
+    std::vector<float> output(testSize, 0.0f);
+    for(uint32_t i = 0; i < testSize; i++) {
+        input[i] = static_cast<float>(i % 100);
+    }
+
+    Kitsunemimi::GpuWorkSplitter splitter(interfaces);
+    TEST_EQUAL(splitter.run(error), false)
+    TEST_EQUAL(splitter.addInput("a", input.data(), testSize, sizeof(float)), true)
+    TEST_EQUAL(splitter.addOutput("b", output.data(), testSize - 1, sizeof(float)), false)
+    TEST_EQUAL(splitter.addOutput("b", output.data(), testSize, sizeof(float)), true)
+
+    TEST_EQUAL(splitter.init("mult", kernelCode, error), true)
+    TEST_EQUAL(splitter.getNumberOfDevices(), interfaces.size())
+
+    // all objects must be assigned to the devices
+    uint64_t total = 0;
+    for(uint64_t i = 0; i < splitter.getNumberOfDevices(); i++)
+    {
+        total += splitter.getPartitionSize(i);
+        TEST_EQUAL(splitter.getThroughput(i) > 0.0, true)
+    }
+    TEST_EQUAL(total, testSize)
+
+    TEST_EQUAL(splitter.run(error), true)
+    TEST_EQUAL(output[42], 84.0f)
+    TEST_EQUAL(output[testSize - 1], 198.0f)
+
+    // run again with partitions based on the last run
+    std::fill(output.begin(), output.end(), 0.0f);
+    TEST_EQUAL(splitter.rebalance(error), true)
+    TEST_EQUAL(splitter.run(error), true)
+    TEST_EQUAL(output[0], 0.0f)
+    TEST_EQUAL(output[testSize / 2], 2.0f * static_cast<float>((testSize / 2) % 100))
+    TEST_EQUAL(output[testSize - 1], 198.0f)
+
+    TEST_EQUAL(splitter.close(), true)
+}
+
+
+void
+SimpleTest::job_scheduler_test()
+{
+    const size_t testSize = 4096;
+    const uint32_t numberOfJobs = 8;
+    ErrorContainer error;
+
+    const std::string kernelCode =
+        "__kernel void mult(\n"
+        "       __global const float* a,\n"
+        "       __global float* b\n"
+        "       )\n"
+        "{\n"
+        "    size_t globalId = get_global_id(0);\n"
+        "    b[globalId] = a[globalId] * 2.0f;\n"
+        "}\n";
+
+    Kitsunemimi::GpuHandler oclHandler;
+    assert(oclHandler.initDevice(error));
+
+    // use a second interface for the first device, so there are at least two queues
+    Kitsunemimi::GpuInterface secondInterface(oclHandler.m_interfaces.at(0)->m_device);
+    std::vector<Kitsunemimi::GpuInterface*> interfaces = oclHandler.m_interfaces;
+    interfaces.push_back(&secondInterface);
+
+    std::vector<Kitsunemimi::GpuData> jobs(numberOfJobs);
+    for(uint32_t j = 0; j < numberOfJobs; j++)
+    {
+        jobs[j].numberOfWg.x = testSize / 64;
+        jobs[j].threadsPerWg.x = 64;
+        jobs[j].addBuffer("a", testSize, sizeof(float), false);
+        jobs[j].addBuffer("b", testSize, sizeof(float), false);
+
+        float* a = static_cast<float*>(jobs[j].getBufferData("a"));
+        for(uint32_t i = 0; i < testSize; i++) {
+            a[i] = static_cast<float>(j);
+        }
+    }
+
+    Kitsunemimi::GpuJobScheduler scheduler(interfaces);
+    TEST_EQUAL(scheduler.submit(jobs[0], error), false)
+    TEST_EQUAL(scheduler.init("mult", kernelCode, {"a"}, {"b"}, error), true)
+    TEST_EQUAL(scheduler.getDeviceOfJob(jobs[0]), -1)
+
+    for(uint32_t j = 0; j < numberOfJobs; j++) {
+        TEST_EQUAL(scheduler.submit(jobs[j], error), true)
+    }
+    TEST_EQUAL(scheduler.waitForAll(error), true)
+
+    std::vector<int64_t> devices;
+    for(uint32_t j = 0; j < numberOfJobs; j++)
+    {
+        float* b = static_cast<float*>(jobs[j].getBufferData("b"));
+        TEST_EQUAL(b[testSize - 1], 2.0f * static_cast<float>(j))
+        TEST_NOT_EQUAL(scheduler.getDeviceOfJob(jobs[j]), -1)
+        devices.push_back(scheduler.getDeviceOfJob(jobs[j]));
+    }
+
+    // second run with new input stays on the same devices
+    for(uint32_t j = 0; j < numberOfJobs; j++)
+    {
+        float* a = static_cast<float*>(jobs[j].getBufferData("a"));
+        a[0] = 100.0f;
+        TEST_EQUAL(scheduler.submit(jobs[j], error), true)
+    }
+    TEST_EQUAL(scheduler.waitForAll(error), true)
+
+    uint64_t processed = 0;
+    for(uint64_t i = 0; i < interfaces.size(); i++) {
+        processed += scheduler.getNumberOfProcessedJobs(i);
+    }
+    TEST_EQUAL(processed, 2 * numberOfJobs)
+
+    for(uint32_t j = 0; j < numberOfJobs; j++)
+    {
+        float* b = static_cast<float*>(jobs[j].getBufferData("b"));
+        TEST_EQUAL(b[0], 200.0f)
+        TEST_EQUAL(scheduler.getDeviceOfJob(jobs[j]), devices[j])
+    }
+
+    TEST_EQUAL(scheduler.close(), true)
+}
+
+
+void
+SimpleTest::shared_context_test()
+{
+    const size_t testSize = 1 << 16;
+    ErrorContainer error;
+
+    Kitsunemimi::GpuHandler oclHandler;
+    assert(oclHandler.initDevice(error, true));
+    Kitsunemimi::GpuInterface* ocl = oclHandler.m_interfaces.at(0);
+
+    // all interfaces of the same platform share their context
+    if(oclHandler.m_interfaces.size() > 1)
+    {
+        Kitsunemimi::GpuInterface* other = oclHandler.m_interfaces.at(1);
+        TEST_EQUAL(ocl->sharesContext(*other),
+                   ocl->m_device.getInfo<CL_DEVICE_PLATFORM>()
+                   == other->m_device.getInfo<CL_DEVICE_PLATFORM>())
+    }
+
+    // interface with its own context for the same device
+    Kitsunemimi::GpuInterface separateInterface(ocl->m_device);
+    TEST_EQUAL(ocl->sharesContext(*ocl), true)
+    TEST_EQUAL(ocl->sharesContext(separateInterface), false)
+
+    Kitsunemimi::GpuData source;
+    source.addBuffer("a", testSize, sizeof(float), false);
+    float* a = static_cast<float*>(source.getBufferData("a"));
+    for(uint32_t i = 0; i < testSize; i++) {
+        a[i] = static_cast<float>(i);
+    }
+    TEST_EQUAL(ocl->initCopyToDevice(source, error), true)
+
+    // copy within the same context
+    Kitsunemimi::GpuData sameContext;
+    sameContext.addBuffer("b", testSize, sizeof(float), false);
+    TEST_EQUAL(ocl->initCopyToDevice(sameContext, error), true)
+    TEST_EQUAL(ocl->copyToInterface(source, "a", *ocl, sameContext, "c", error), false)
+    TEST_EQUAL(ocl->copyToInterface(source, "a", *ocl, sameContext, "b", error), true)
+    TEST_EQUAL(ocl->copyFromDevice(sameContext, "b", error), true)
+    float* b = static_cast<float*>(sameContext.getBufferData("b"));
+    TEST_EQUAL(b[42], 42.0f)
+    TEST_EQUAL(b[testSize - 1], static_cast<float>(testSize - 1))
+
+    // copy into another context through the host
+    Kitsunemimi::GpuData otherContext;
+    otherContext.addBuffer("c", testSize, sizeof(float), false);
+    TEST_EQUAL(separateInterface.initCopyToDevice(otherContext, error), true)
+    TEST_EQUAL(ocl->copyToInterface(source, "a", separateInterface, otherContext, "c", error),
+               true)
+    float* c = static_cast<float*>(otherContext.getBufferData("c"));
+    c[42] = 0.0f;
+    TEST_EQUAL(separateInterface.copyFromDevice(otherContext, "c", error), true)
+    TEST_EQUAL(c[42], 42.0f)
+
+    // target too small
+    Kitsunemimi::GpuData smallData;
+    smallData.addBuffer("d", testSize / 2, sizeof(float), false);
+    TEST_EQUAL(ocl->initCopyToDevice(smallData, error), true)
+    TEST_EQUAL(ocl->copyToInterface(source, "a", *ocl, smallData, "d", error), false)
+
+    TEST_EQUAL(ocl->closeDevice(source), true)
+    TEST_EQUAL(ocl->closeDevice(sameContext), true)
+    TEST_EQUAL(ocl->closeDevice(smallData), true)
+    TEST_EQUAL(separateInterface.closeDevice(otherContext), true)
+}
+
+
+void
+SimpleTest::device_filter_test()
+{
+    ErrorContainer error;
+
+    // interfaces get their context not before the first use
+    Kitsunemimi::GpuHandler allHandler;
+    assert(allHandler.initDevice(error));
+    Kitsunemimi::GpuInterface* ocl = allHandler.m_interfaces.at(0);
+    TEST_EQUAL(ocl->isInitialized(), false)
+    TEST_NOT_EQUAL(ocl->getDeviceName(), "")
+    TEST_EQUAL(ocl->isInitialized(), false)
+
+    Kitsunemimi::GpuData data;
+    data.addBuffer("a", 1024, sizeof(float), false);
+    TEST_EQUAL(ocl->initCopyToDevice(data, error), true)
+    TEST_EQUAL(ocl->isInitialized(), true)
+    TEST_EQUAL(ocl->closeDevice(data), true)
+
+    // select by name
+    Kitsunemimi::DeviceFilter nameFilter;
+    nameFilter.name = ocl->getDeviceName();
+    Kitsunemimi::GpuHandler nameHandler;
+    TEST_EQUAL(nameHandler.initDevice(nameFilter, error), true)
+    for(Kitsunemimi::GpuInterface* interface : nameHandler.m_interfaces) {
+        TEST_EQUAL(interface->getDeviceName(), ocl->getDeviceName())
+    }
+
+    // limit number of devices
+    Kitsunemimi::DeviceFilter limitFilter;
+    limitFilter.maxNumberOfDevices = 1;
+    Kitsunemimi::GpuHandler limitHandler;
+    TEST_EQUAL(limitHandler.initDevice(limitFilter, error), true)
+    TEST_EQUAL(limitHandler.m_interfaces.size(), 1)
+
+    // filter without matching device
+    Kitsunemimi::DeviceFilter memoryFilter;
+    memoryFilter.minGlobalMemory = 0xFFFFFFFFFFFFFFFF;
+    Kitsunemimi::GpuHandler memoryHandler;
+    TEST_EQUAL(memoryHandler.initDevice(memoryFilter, error), false)
+    TEST_EQUAL(memoryHandler.m_interfaces.size(), 0)
+}
+
+
+void
+SimpleTest::async_build_test()
+{
+    const size_t testSize = 1 << 16;
+    const uint32_t numberOfKernels = 8;
+    ErrorContainer error;
+
+    Kitsunemimi::GpuHandler oclHandler;
+    assert(oclHandler.initDevice(error));
+    Kitsunemimi::GpuInterface* ocl = oclHandler.m_interfaces.at(0);
+
+    Kitsunemimi::GpuData data;
+    data.numberOfWg.x = testSize / 64;
+    data.threadsPerWg.x = 64;
+    data.addBuffer("a", testSize, sizeof(float), false);
+    data.addBuffer("b", testSize, sizeof(float), false);
+
+    float* a = static_cast<float*>(data.getBufferData("a"));
+    for(uint32_t i = 0; i < testSize; i++) {
+        a[i] = 1.0f;
+    }
+
+    // compile multiple kernels at the same time, where each kernel adds a different value
+    for(uint32_t k = 0; k < numberOfKernels; k++)
+    {
+        const std::string kernelName = "add" + std::to_string(k);
+        const std::string kernelCode =
+            "__kernel void " + kernelName + "(\n"
+            "       __global const float* a,\n"
+            "       __global float* b\n"
+            "       )\n"
+            "{\n"
+            "    size_t globalId = get_global_id(0);\n"
+            "    b[globalId] = a[globalId] + " + std::to_string(k) + ".0f;\n"
+            "}\n";
+        TEST_EQUAL(ocl->addKernelAsync(data, kernelName, kernelCode, error), true)
+    }
+
+    TEST_EQUAL(ocl->waitForKernels(data, error), true)
+    for(uint32_t k = 0; k < numberOfKernels; k++) {
+        TEST_NOT_EQUAL(data.getKernelHandle("add" + std::to_string(k)).id, 0xFFFFFFFF)
+    }
+
+    TEST_EQUAL(ocl->initCopyToDevice(data, error), true)
+    TEST_EQUAL(ocl->bindKernelToBuffer(data, "add5", "a", error), true)
+    TEST_EQUAL(ocl->bindKernelToBuffer(data, "add5", "b", error), true)
+    TEST_EQUAL(ocl->run(data, "add5", error), true)
+    TEST_EQUAL(ocl->copyFromDevice(data, "b", error), true)
+
+    float* b = static_cast<float*>(data.getBufferData("b"));
+    TEST_EQUAL(b[42], 6.0f)
+
+    // broken kernel is reported by the wait
+    const std::string brokenCode = "__kernel void broken(__global float* a) { a[0] = x; }\n";
+    ErrorContainer buildError;
+    TEST_EQUAL(ocl->addKernelAsync(data, "broken", brokenCode, buildError), true)
+    TEST_EQUAL(ocl->waitForKernels(data, buildError), false)
+    TEST_EQUAL(data.getKernelHandle("broken").id, 0xFFFFFFFF)
+
+    // nothing left to wait for
+    TEST_EQUAL(ocl->waitForKernels(data, error), true)
+
+    TEST_EQUAL(ocl->closeDevice(data), true)
+}
+
+
+void
+SimpleTest::build_options_test()
+{
+    const size_t testSize = 1 << 16;
+    ErrorContainer error;
+
+    // kernel without hard-coded values, which are given by defines at compile-time
+    const std::string kernelCode =
+        "__kernel void scale(\n"
+        "       __global const float* a,\n"
+        "       __global float* b\n"
+        "       )\n"
+        "{\n"
+        "    size_t globalId = get_global_id(0);\n"
+        "#ifdef USE_OFFSET\n"
+        "    b[globalId] = a[globalId] * FACTOR + 1.0f;\n"
+        "#else\n"
+        "    b[globalId] = a[globalId] * FACTOR;\n"
+        "#endif\n"
+        "}\n";
+
+    Kitsunemimi::GpuHandler oclHandler;
+    assert(oclHandler.initDevice(error));
+    Kitsunemimi::GpuInterface* ocl = oclHandler.m_interfaces.at(0);
+
+    Kitsunemimi::GpuData data;
+    data.numberOfWg.x = testSize / 64;
+    data.threadsPerWg.x = 64;
+    data.addBuffer("a", testSize, sizeof(float), false);
+    data.addBuffer("b", testSize, sizeof(float), false);
+
+    float* a = static_cast<float*>(data.getBufferData("a"));
+    for(uint32_t i = 0; i < testSize; i++) {
+        a[i] = 2.0f;
+    }
+    TEST_EQUAL(ocl->initCopyToDevice(data, error), true)
+
+    // first variant
+    Kitsunemimi::KernelBuildOptions options;
+    options.defines["FACTOR"] = "3.0f";
+    options.flags.push_back("-cl-mad-enable");
+    TEST_EQUAL(ocl->addKernel(data, "scale", kernelCode, options, error), true)
+    TEST_EQUAL(ocl->getNumberOfProgramVariants(), 1)
+
+    TEST_EQUAL(ocl->bindKernelToBuffer(data, "scale", "a", error), true)
+    TEST_EQUAL(ocl->bindKernelToBuffer(data, "scale", "b", error), true)
+    TEST_EQUAL(ocl->run(data, "scale", error), true)
+    TEST_EQUAL(ocl->copyFromDevice(data, "b", error), true)
+
+    float* b = static_cast<float*>(data.getBufferData("b"));
+    TEST_EQUAL(b[42], 6.0f)
+
+    // same options reuse the already build program
+    Kitsunemimi::GpuData sameData;
+    TEST_EQUAL(ocl->addKernel(sameData, "scale", kernelCode, options, error), true)
+    TEST_EQUAL(ocl->getNumberOfProgramVariants(), 1)
+    TEST_EQUAL(ocl->closeDevice(sameData), true)
+
+    // other options result in a new variant with other behavior
+    Kitsunemimi::GpuData otherData;
+    otherData.numberOfWg.x = testSize / 64;
+    otherData.threadsPerWg.x = 64;
+    otherData.addBuffer("a", testSize, sizeof(float), false, a);
+    otherData.addBuffer("b", testSize, sizeof(float), false);
+    TEST_EQUAL(ocl->initCopyToDevice(otherData, error), true)
+
+    Kitsunemimi::KernelBuildOptions otherOptions;
+    otherOptions.defines["FACTOR"] = "4.0f";
+    otherOptions.defines["USE_OFFSET"] = "";
+    TEST_EQUAL(ocl->addKernel(otherData, "scale", kernelCode, otherOptions, error), true)
+    TEST_EQUAL(ocl->getNumberOfProgramVariants(), 2)
+
+    TEST_EQUAL(ocl->bindKernelToBuffer(otherData, "scale", "a", error), true)
+    TEST_EQUAL(ocl->bindKernelToBuffer(otherData, "scale", "b", error), true)
+    TEST_EQUAL(ocl->run(otherData, "scale", error), true)
+    TEST_EQUAL(ocl->copyFromDevice(otherData, "b", error), true)
+
+    float* otherB = static_cast<float*>(otherData.getBufferData("b"));
+    TEST_EQUAL(otherB[42], 9.0f)
+
+    // defines with whitespace would break the option-string and are rejected
+    Kitsunemimi::KernelBuildOptions invalidOptions;
+    invalidOptions.defines["FACTOR"] = "3.0f + 1.0f";
+    Kitsunemimi::GpuData invalidData;
+    ErrorContainer optionError;
+    TEST_EQUAL(ocl->addKernel(invalidData, "scale", kernelCode, invalidOptions, optionError), false)
+    TEST_EQUAL(ocl->addKernels(invalidData, kernelCode, invalidOptions, optionError), false)
+    TEST_EQUAL(ocl->getNumberOfProgramVariants(), 2)
+
+    // all kernels of a source with options, which are equal to an existing variant
+    Kitsunemimi::GpuData allData;
+    TEST_EQUAL(ocl->addKernels(allData, kernelCode, otherOptions, error), true)
+    TEST_EQUAL(ocl->getNumberOfProgramVariants(), 2)
+    TEST_EQUAL(ocl->closeDevice(allData), true)
+
+    TEST_EQUAL(ocl->closeDevice(otherData), true)
+    TEST_EQUAL(ocl->closeDevice(data), true)
+}
+
+
+void
+SimpleTest::kernel_argument_test()
+{
+    const size_t testSize = 1 << 16;
+    ErrorContainer error;
+
+    struct Params
+    {
+        float factor = 0.0f;
+        uint32_t count = 0;
+    };
+
+    // kernel with buffer, a scalar and a struct as arguments
+    const std::string kernelCode =
+        "typedef struct\n"
+        "{\n"
+        "    float factor;\n"
+        "    uint count;\n"
+        "} Params;\n"
+        "\n"
+        "__kernel void step(\n"
+        "       __global const float* a,\n"
+        "       __global float* b,\n"
+        "       const float offset,\n"
+        "       const Params params\n"
+        "       )\n"
+        "{\n"
+        "    size_t globalId = get_global_id(0);\n"
+        "    if (globalId < params.count) {\n"
+        "        b[globalId] = a[globalId] * params.factor + offset;\n"
+        "    }\n"
+        "}\n";
+
+    Kitsunemimi::GpuHandler oclHandler;
+    assert(oclHandler.initDevice(error));
+    Kitsunemimi::GpuInterface* ocl = oclHandler.m_interfaces.at(0);
+
+    Kitsunemimi::GpuData data;
+    data.numberOfWg.x = testSize / 64;
+    data.threadsPerWg.x = 64;
+    data.addBuffer("a", testSize, sizeof(float), false);
+    data.addBuffer("b", testSize, sizeof(float), false);
+
+    float* a = static_cast<float*>(data.getBufferData("a"));
+    for(uint32_t i = 0; i < testSize; i++) {
+        a[i] = 2.0f;
+    }
+
+    TEST_EQUAL(ocl->initCopyToDevice(data, error), true)
+    TEST_EQUAL(ocl->addKernel(data, "step", kernelCode, error), true)
+    TEST_EQUAL(ocl->bindKernelToBuffer(data, "step", "a", error), true)
+    TEST_EQUAL(ocl->bindKernelToBuffer(data, "step", "b", error), true)
+
+    Params params;
+    params.factor = 3.0f;
+    params.count = testSize;
+    TEST_EQUAL(ocl->setKernelArgument(data, "step", "offset", 1.0f, error), true)
+    TEST_EQUAL(ocl->setKernelArgument(data, "step", "params", params, error), true)
+
+    TEST_EQUAL(ocl->run(data, "step", error), true)
+    TEST_EQUAL(ocl->copyFromDevice(data, "b", error), true)
+
+    float* b = static_cast<float*>(data.getBufferData("b"));
+    TEST_EQUAL(b[42], 7.0f)
+
+    // update the values between two runs without new binding
+    params.factor = 4.0f;
+    TEST_EQUAL(ocl->setKernelArgument(data, "step", "offset", 2.0f, error), true)
+    TEST_EQUAL(ocl->setKernelArgument(data, "step", "params", params, error), true)
+    TEST_EQUAL(ocl->run(data, "step", error), true)
+    TEST_EQUAL(ocl->copyFromDevice(data, "b", error), true)
+    TEST_EQUAL(b[42], 10.0f)
+
+    // value with other size and name of a buffer are rejected
+    ErrorContainer argError;
+    TEST_EQUAL(ocl->setKernelArgument(data, "step", "offset", 2.0, argError), false)
+    TEST_EQUAL(ocl->setKernelArgument(data, "step", "a", 2.0f, argError), false)
+    TEST_EQUAL(ocl->setKernelArgument(data, "fail", "offset", 2.0f, argError), false)
+
+    TEST_EQUAL(ocl->closeDevice(data), true)
+
+    // kernel with local memory between the buffer and a value-argument
+    const std::string localKernelCode =
+        "__kernel void scale(\n"
+        "       __global const float* a,\n"
+        "       __global float* b,\n"
+        "       __local float* tmp,\n"
+        "       const float factor\n"
+        "       )\n"
+        "{\n"
+        "    size_t globalId = get_global_id(0);\n"
+        "    size_t localId = get_local_id(0);\n"
+        "    tmp[localId] = a[globalId];\n"
+        "    barrier(CLK_LOCAL_MEM_FENCE);\n"
+        "    b[globalId] = tmp[localId] * factor;\n"
+        "}\n";
+
+    Kitsunemimi::GpuData localData;
+    localData.numberOfWg.x = testSize / 64;
+    localData.threadsPerWg.x = 64;
+    localData.addBuffer("a", testSize, sizeof(float), false);
+    localData.addBuffer("b", testSize, sizeof(float), false);
+
+    a = static_cast<float*>(localData.getBufferData("a"));
+    for(uint32_t i = 0; i < testSize; i++) {
+        a[i] = 2.0f;
+    }
+
+    TEST_EQUAL(ocl->initCopyToDevice(localData, error), true)
+    TEST_EQUAL(ocl->addKernel(localData, "scale", localKernelCode, error), true)
+    TEST_EQUAL(ocl->bindKernelToBuffer(localData, "scale", "a", error), true)
+    TEST_EQUAL(ocl->bindKernelToBuffer(localData, "scale", "b", error), true)
+    TEST_EQUAL(ocl->setLocalMemory(localData, "scale", 64 * sizeof(float), error), true)
+    TEST_EQUAL(ocl->setKernelArgument(localData, "scale", "factor", 3.0f, error), true)
+
+    TEST_EQUAL(ocl->run(localData, "scale", error), true)
+    TEST_EQUAL(ocl->copyFromDevice(localData, "b", error), true)
+    b = static_cast<float*>(localData.getBufferData("b"));
+    TEST_EQUAL(b[42], 6.0f)
+
+    // update the value by the handle of the kernel
+    const Kitsunemimi::KernelHandle handle = localData.getKernelHandle("scale");
+    TEST_EQUAL(ocl->setKernelArgument(localData, handle, "factor", 5.0f, error), true)
+    TEST_EQUAL(ocl->run(localData, handle, error), true)
+    TEST_EQUAL(ocl->copyFromDevice(localData, "b", error), true)
+    TEST_EQUAL(b[42], 10.0f)
+
+    TEST_EQUAL(ocl->setKernelArgument(localData, handle, "factor", 2.0, argError), false)
+    TEST_EQUAL(ocl->setKernelArgument(localData,
+                                      Kitsunemimi::KernelHandle(),
+                                      "factor",
+                                      2.0f,
+                                      argError), false)
+
+    TEST_EQUAL(ocl->closeDevice(localData), true)
+}
+
+
+void
+SimpleTest::per_thread_queue_test()
+{
+    const size_t testSize = 1 << 16;
+    const uint32_t numberOfThreads = 4;
+    ErrorContainer error;
+
+    const std::string kernelCode =
+        "__kernel void add(\n"
+        "       __global const float* a,\n"
+        "       __global float* b,\n"
+        "       const float value\n"
+        "       )\n"
+        "{\n"
+        "    size_t globalId = get_global_id(0);\n"
+        "    b[globalId] = a[globalId] + value;\n"
+        "}\n";
+
+    Kitsunemimi::GpuHandler oclHandler;
+    assert(oclHandler.initDevice(error));
+    Kitsunemimi::GpuInterface* ocl = oclHandler.m_interfaces.at(0);
+
+    TEST_EQUAL(ocl->enablePerThreadQueues(error), true)
+    TEST_EQUAL(ocl->usePerThreadQueues(), true)
+    TEST_EQUAL(ocl->enableSeparateQueues(1, error), false)
+
+    // shared data-object, which is only read by the threads
+    Kitsunemimi::GpuData sharedData;
+    sharedData.addBuffer("shared", testSize, sizeof(float), false);
+
+    // each thread uses the same interface with its own data-object and queue
+    std::vector<float> results(numberOfThreads, 0.0f);
+    std::vector<uint8_t> handleValid(numberOfThreads, 0);
+    std::vector<std::thread> threads;
+    for(uint32_t t = 0; t < numberOfThreads; t++)
+    {
+        threads.emplace_back([&, t]()
+        {
+            handleValid[t] = sharedData.getBufferHandle("shared").id != 0xFFFFFFFF
+                             && sharedData.getBufferData("shared") != nullptr;
+
+            ErrorContainer threadError;
+            Kitsunemimi::GpuData data;
+            data.numberOfWg.x = testSize / 64;
+            data.threadsPerWg.x = 64;
+            data.addBuffer("a", testSize, sizeof(float), false);
+            data.addBuffer("b", testSize, sizeof(float), false);
+
+            float* a = static_cast<float*>(data.getBufferData("a"));
+            for(uint32_t i = 0; i < testSize; i++) {
+                a[i] = static_cast<float>(t);
+            }
+
+            if(ocl->initCopyToDevice(data, threadError) == false
+                    || ocl->addKernel(data, "add", kernelCode, threadError) == false
+                    || ocl->bindKernelToBuffer(data, "add", "a", threadError) == false
+                    || ocl->bindKernelToBuffer(data, "add", "b", threadError) == false)
+            {
+                return;
+            }
+
+            // only the value-argument changes between the runs
+            for(uint32_t run = 0; run < 10; run++)
+            {
+                const float value = static_cast<float>(run);
+                if(ocl->setKernelArgument(data, "add", "value", value, threadError) == false
+                        || ocl->run(data, "add", threadError) == false
+                        || ocl->copyFromDevice(data, "b", threadError) == false)
+                {
+                    return;
+                }
+            }
+
+            const float* b = static_cast<const float*>(data.getBufferData("b"));
+            results[t] = b[42];
+
+            ocl->closeDevice(data);
+        });
+    }
+
+    for(std::thread &thread : threads) {
+        thread.join();
+    }
+
+    // source-code was compiled only once and each thread got its own queue
+    TEST_EQUAL(ocl->getNumberOfProgramVariants(), 1)
+    TEST_EQUAL(ocl->getNumberOfThreadQueues(), numberOfThreads)
+    for(uint32_t t = 0; t < numberOfThreads; t++)
+    {
+        TEST_EQUAL(handleValid[t], 1)
+        TEST_EQUAL(results[t], static_cast<float>(t) + 9.0f)
+    }
+
+    // queue of a thread can be removed again
+    bool released = false;
+    uint64_t numberOfQueues = 0;
+    std::thread releaseThread([&]()
+    {
+        ErrorContainer threadError;
+        Kitsunemimi::GpuData data;
+        data.addBuffer("a", testSize, sizeof(float), false);
+        if(ocl->initCopyToDevice(data, threadError) == false) {
+            return;
+        }
+        numberOfQueues = ocl->getNumberOfThreadQueues();
+        ocl->closeDevice(data);
+        released = ocl->releaseThreadQueue();
+    });
+    releaseThread.join();
+
+    TEST_EQUAL(released, true)
+    TEST_EQUAL(numberOfQueues, numberOfThreads + 1)
+    TEST_EQUAL(ocl->getNumberOfThreadQueues(), numberOfThreads)
+
+    TEST_EQUAL(ocl->closeDevice(sharedData), true)
+}
+
 }
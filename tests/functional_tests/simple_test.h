@@ -40,6 +40,29 @@ public:
     SimpleTest();
 
     void simple_test();
+    void program_cache_test();
+    void multi_kernel_test();
+    void async_test();
+    void command_graph_test();
+    void partial_copy_test();
+    void stream_executor_test();
+    void pinned_memory_test();
+    void map_test();
+    void buffer_pool_test();
+    void arena_test();
+    void handle_test();
+    void profiling_test();
+    void tracing_test();
+    void workgroup_tuning_test();
+    void launch_test();
+    void work_splitter_test();
+    void job_scheduler_test();
+    void shared_context_test();
+    void device_filter_test();
+    void async_build_test();
+    void build_options_test();
+    void kernel_argument_test();
+    void per_thread_queue_test();
 };
 
 }
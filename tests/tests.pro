@@ -5,6 +5,7 @@ CONFIG += c++17
 
 SUBDIRS = \
     functional_tests \
-    benchmark_tests
+    benchmark_tests \
+    throughput_benchmark
 
 tests.depends = src
@@ -0,0 +1,210 @@
+/**
+ * @file        main.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+
+#include <libKitsunemimiCommon/logger.h>
+#include <throughput_benchmark.h>
+
+/**
+ * @brief print usage of the benchmark
+ */
+void
+printHelp()
+{
+    std::cout<<"usage: throughput_benchmark [options]\n"
+             <<"\n"
+             <<"    --device-type <all|cpu|gpu>    type of the device (default: all)\n"
+             <<"    --device <id>                  id within the matching devices (default: 0)\n"
+             <<"    --min-size <bytes>             smallest buffer-size (default: 4096)\n"
+             <<"    --max-size <bytes>             biggest buffer-size (default: 1073741824)\n"
+             <<"    --max-total <bytes>            memory-limit for all threads together\n"
+             <<"    --threads <n,n,...>            thread-counts (default: 1,2,4,8)\n"
+             <<"    --latency-iterations <n>       kernel-launches per thread (default: 1000)\n"
+             <<"    --compile-runs <n>             number of compilations (default: 5)\n"
+             <<"    --e2e-size <bytes>             buffer-size for end-to-end runs\n"
+             <<"    --e2e-iterations <n>           end-to-end iterations per thread\n"
+             <<"    --output <path>                json-file (default: stdout)\n"
+             <<std::endl;
+}
+
+/**
+ * @brief parse comma-separated list of thread-counts
+ *
+ * @param input string to parse
+ * @param threadCounts reference for the result
+ *
+ * @return false, if the list is empty or contains invalid values, else true
+ */
+bool
+parseThreadCounts(const std::string &input,
+                  std::vector<uint32_t> &threadCounts)
+{
+    threadCounts.clear();
+
+    std::stringstream stream(input);
+    std::string part;
+    while(std::getline(stream, part, ','))
+    {
+        const uint32_t value = static_cast<uint32_t>(std::stoul(part));
+        if(value == 0) {
+            return false;
+        }
+        threadCounts.push_back(value);
+    }
+
+    return threadCounts.size() > 0;
+}
+
+/**
+ * @brief parse arguments of the command-line into the config
+ *
+ * @param argc number of arguments
+ * @param argv arguments
+ * @param config reference for the resulting config
+ *
+ * @return false, if an argument is invalid, else true
+ */
+bool
+parseArguments(int argc,
+               char* argv[],
+               Kitsunemimi::BenchmarkConfig &config)
+{
+    for(int i = 1; i < argc; i++)
+    {
+        const std::string name = argv[i];
+        if(i + 1 >= argc)
+        {
+            std::cerr<<"missing value for argument '"<<name<<"'"<<std::endl;
+            return false;
+        }
+        const std::string value = argv[++i];
+
+        try
+        {
+            if(name == "--device-type") {
+                config.deviceType = value;
+            } else if(name == "--device") {
+                config.deviceId = static_cast<uint32_t>(std::stoul(value));
+            } else if(name == "--min-size") {
+                config.minBufferSize = std::stoull(value);
+            } else if(name == "--max-size") {
+                config.maxBufferSize = std::stoull(value);
+            } else if(name == "--max-total") {
+                config.maxTotalSize = std::stoull(value);
+            } else if(name == "--threads")
+            {
+                if(parseThreadCounts(value, config.threadCounts) == false)
+                {
+                    std::cerr<<"invalid thread-counts '"<<value<<"'"<<std::endl;
+                    return false;
+                }
+            }
+            else if(name == "--latency-iterations") {
+                config.latencyIterations = static_cast<uint32_t>(std::stoul(value));
+            } else if(name == "--compile-runs") {
+                config.compileRuns = static_cast<uint32_t>(std::stoul(value));
+            } else if(name == "--e2e-size") {
+                config.endToEndSize = std::stoull(value);
+            } else if(name == "--e2e-iterations") {
+                config.endToEndIterations = static_cast<uint32_t>(std::stoul(value));
+            } else if(name == "--output") {
+                config.outputPath = value;
+            }
+            else
+            {
+                std::cerr<<"unknown argument '"<<name<<"'"<<std::endl;
+                return false;
+            }
+        }
+        catch(const std::exception &)
+        {
+            std::cerr<<"invalid value '"<<value<<"' for argument '"<<name<<"'"<<std::endl;
+            return false;
+        }
+    }
+
+    // buffer must contain at least one float and one page
+    if(config.minBufferSize < 4096
+            || config.minBufferSize > config.maxBufferSize
+            || config.endToEndSize < sizeof(float))
+    {
+        std::cerr<<"invalid buffer-sizes"<<std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+int
+main(int argc, char* argv[])
+{
+    for(int i = 1; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+        if(arg == "--help" || arg == "-h")
+        {
+            printHelp();
+            return 0;
+        }
+    }
+
+    Kitsunemimi::BenchmarkConfig config;
+    if(parseArguments(argc, argv, config) == false)
+    {
+        printHelp();
+        return 1;
+    }
+
+    // debug-output would mix up with the json-output
+    Kitsunemimi::initConsoleLogger(false);
+
+    Kitsunemimi::ErrorContainer error;
+    Kitsunemimi::ThroughputBenchmark benchmark(config);
+    if(benchmark.run(error) == false)
+    {
+        std::cerr<<"benchmark failed:\n"<<error.toString()<<std::endl;
+        return 1;
+    }
+
+    const std::string result = benchmark.toJson();
+    if(config.outputPath.size() == 0)
+    {
+        std::cout<<result;
+        return 0;
+    }
+
+    std::ofstream outputFile(config.outputPath);
+    outputFile<<result;
+    outputFile.close();
+    if(outputFile.fail())
+    {
+        std::cerr<<"failed to write result to '"<<config.outputPath<<"'"<<std::endl;
+        return 1;
+    }
+
+    return 0;
+}
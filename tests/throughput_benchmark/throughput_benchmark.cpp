@@ -0,0 +1,747 @@
+/**
+ * @file        throughput_benchmark.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "throughput_benchmark.h"
+
+#include <libKitsunemimiOpencl/gpu_interface.h>
+#include <libKitsunemimiOpencl/gpu_handler.h>
+
+#include <thread>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+
+namespace Kitsunemimi
+{
+
+/**
+ * @brief constructor
+ *
+ * @param numberOfThreads number of threads, which have to reach the barrier
+ */
+ThroughputBenchmark::PhaseBarrier::PhaseBarrier(const uint32_t numberOfThreads)
+{
+    m_numberOfThreads = numberOfThreads;
+}
+
+/**
+ * @brief block until all threads reached the barrier
+ *
+ * @return false, if the barrier was aborted by a failed thread, else true
+ */
+bool
+ThroughputBenchmark::PhaseBarrier::wait()
+{
+    std::unique_lock<std::mutex> lock(m_lock);
+    if(m_aborted) {
+        return false;
+    }
+
+    const uint64_t generation = m_generation;
+    m_waiting++;
+    if(m_waiting == m_numberOfThreads)
+    {
+        m_waiting = 0;
+        m_generation++;
+        m_cv.notify_all();
+        return true;
+    }
+
+    m_cv.wait(lock, [&] { return m_generation != generation || m_aborted; });
+
+    return m_aborted == false;
+}
+
+/**
+ * @brief release all waiting threads, because one thread failed and will not reach the barrier
+ */
+void
+ThroughputBenchmark::PhaseBarrier::abort()
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_aborted = true;
+    m_cv.notify_all();
+}
+
+/**
+ * @brief constructor
+ *
+ * @param config configuration of the benchmark
+ */
+ThroughputBenchmark::ThroughputBenchmark(const BenchmarkConfig &config)
+{
+    m_config = config;
+}
+
+/**
+ * @brief destructor
+ */
+ThroughputBenchmark::~ThroughputBenchmark()
+{
+    if(m_handler != nullptr) {
+        delete m_handler;
+    }
+}
+
+/**
+ * @brief run all measurements. The progress is written to stderr, so stdout only contains the
+ *        json-output.
+ *
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+ThroughputBenchmark::run(ErrorContainer &error)
+{
+    if(initDevice(error) == false) {
+        return false;
+    }
+
+    std::cerr<<"benchmark device: "<<m_interface->getDeviceName()<<std::endl;
+
+    std::cerr<<"measure compile-time"<<std::endl;
+    if(measureCompileTime(error) == false) {
+        return false;
+    }
+
+    for(const uint32_t threads : m_config.threadCounts)
+    {
+        std::cerr<<"measure launch-latency with "<<threads<<" threads"<<std::endl;
+        if(measureLatency(threads, error) == false) {
+            return false;
+        }
+    }
+
+    // sweep buffer-sizes and thread-counts, as long as the buffer fit into the device
+    const uint64_t maxAlloc = m_interface->getMaxMemAllocSize();
+    const uint64_t maxTotal = std::min(m_config.maxTotalSize,
+                                       m_interface->getGlobalMemorySize() / 2);
+    for(uint64_t size = m_config.minBufferSize; size <= m_config.maxBufferSize; size *= 4)
+    {
+        for(const uint32_t threads : m_config.threadCounts)
+        {
+            // each thread requires a source- and a target-buffer
+            SkippedRun skipped;
+            skipped.bufferSize = size;
+            skipped.threads = threads;
+            if(size > maxAlloc) {
+                skipped.reason = "buffer-size exceeds maximum allocation-size of the device";
+            } else if(2 * size * threads > maxTotal) {
+                skipped.reason = "total buffer-size exceeds memory-limit";
+            }
+
+            if(skipped.reason.size() > 0)
+            {
+                m_skippedRuns.push_back(skipped);
+                continue;
+            }
+
+            std::cerr<<"measure bandwidth for "<<size<<" bytes with "
+                     <<threads<<" threads"<<std::endl;
+            if(measureBandwidth(size, threads, error) == false) {
+                return false;
+            }
+        }
+    }
+
+    for(const uint32_t threads : m_config.threadCounts)
+    {
+        std::cerr<<"measure end-to-end iterations with "<<threads<<" threads"<<std::endl;
+        if(measureEndToEnd(threads, error) == false) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief convert all results into a json-string
+ *
+ * @return json-string
+ */
+const std::string
+ThroughputBenchmark::toJson() const
+{
+    std::ostringstream out;
+    out<<std::fixed<<std::setprecision(3);
+
+    out<<"{\n";
+    out<<"    \"device\": {\n";
+    if(m_interface != nullptr)
+    {
+        std::string name = m_interface->getDeviceName();
+        name.erase(std::remove(name.begin(), name.end(), '"'), name.end());
+        out<<"        \"name\": \""<<name<<"\",\n";
+        out<<"        \"global_memory_bytes\": "<<m_interface->getGlobalMemorySize()<<",\n";
+        out<<"        \"max_alloc_bytes\": "<<m_interface->getMaxMemAllocSize()<<"\n";
+    }
+    out<<"    },\n";
+
+    out<<"    \"compile\": {\n";
+    out<<"        \"runs\": "<<m_compileResult.runs<<",\n";
+    out<<"        \"mean_ms\": "<<m_compileResult.meanMs<<",\n";
+    out<<"        \"min_ms\": "<<m_compileResult.minMs<<"\n";
+    out<<"    },\n";
+
+    out<<"    \"launch_latency\": [";
+    for(uint64_t i = 0; i < m_latencyResults.size(); i++)
+    {
+        const LatencyResult &result = m_latencyResults.at(i);
+        out<<(i == 0 ? "\n" : ",\n");
+        out<<"        {\"threads\": "<<result.threads
+           <<", \"iterations\": "<<result.iterations
+           <<", \"mean_us\": "<<result.meanUs
+           <<", \"min_us\": "<<result.minUs<<"}";
+    }
+    out<<"\n    ],\n";
+
+    out<<"    \"bandwidth\": [";
+    for(uint64_t i = 0; i < m_bandwidthResults.size(); i++)
+    {
+        const BandwidthResult &result = m_bandwidthResults.at(i);
+        out<<(i == 0 ? "\n" : ",\n");
+        out<<"        {\"size_bytes\": "<<result.bufferSize
+           <<", \"threads\": "<<result.threads
+           <<", \"iterations\": "<<result.iterations
+           <<", \"h2d_gbps\": "<<result.hostToDevice
+           <<", \"d2h_gbps\": "<<result.deviceToHost
+           <<", \"d2d_gbps\": "<<result.deviceToDevice<<"}";
+    }
+    out<<"\n    ],\n";
+
+    out<<"    \"end_to_end\": [";
+    for(uint64_t i = 0; i < m_endToEndResults.size(); i++)
+    {
+        const EndToEndResult &result = m_endToEndResults.at(i);
+        out<<(i == 0 ? "\n" : ",\n");
+        out<<"        {\"threads\": "<<result.threads
+           <<", \"size_bytes\": "<<result.bufferSize
+           <<", \"iterations\": "<<result.iterations
+           <<", \"iterations_per_second\": "<<result.iterationsPerSecond<<"}";
+    }
+    out<<"\n    ],\n";
+
+    out<<"    \"skipped\": [";
+    for(uint64_t i = 0; i < m_skippedRuns.size(); i++)
+    {
+        const SkippedRun &skipped = m_skippedRuns.at(i);
+        out<<(i == 0 ? "\n" : ",\n");
+        out<<"        {\"size_bytes\": "<<skipped.bufferSize
+           <<", \"threads\": "<<skipped.threads
+           <<", \"reason\": \""<<skipped.reason<<"\"}";
+    }
+    out<<"\n    ]\n";
+    out<<"}\n";
+
+    return out.str();
+}
+
+/**
+ * @brief select device by the configured type and id and enable per-thread queues, so the
+ *        threads of the benchmark don't share a single queue
+ *
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+ThroughputBenchmark::initDevice(ErrorContainer &error)
+{
+    DeviceFilter filter;
+    if(m_config.deviceType == "cpu") {
+        filter.deviceType = CL_DEVICE_TYPE_CPU;
+    } else if(m_config.deviceType == "gpu") {
+        filter.deviceType = CL_DEVICE_TYPE_GPU;
+    } else if(m_config.deviceType != "all")
+    {
+        error.addMeesage("unknown device-type '" + m_config.deviceType + "'");
+        return false;
+    }
+
+    m_handler = new GpuHandler();
+    if(m_handler->initDevice(filter, error) == false) {
+        return false;
+    }
+
+    if(m_config.deviceId >= m_handler->m_interfaces.size())
+    {
+        error.addMeesage("no device with id " + std::to_string(m_config.deviceId) + " found");
+        return false;
+    }
+
+    m_interface = m_handler->m_interfaces.at(m_config.deviceId);
+
+    return m_interface->enablePerThreadQueues(error);
+}
+
+/**
+ * @brief measure the time to compile a kernel from source. Each run gets another define, so
+ *        neither the program-variants of the interface nor a cache of the driver can be used.
+ *
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+ThroughputBenchmark::measureCompileTime(ErrorContainer &error)
+{
+    const std::string kernelCode =
+        "__kernel void compute(\n"
+        "       __global const float* a,\n"
+        "       __global float* b\n"
+        "       )\n"
+        "{\n"
+        "    size_t globalId = get_global_id(0);\n"
+        "    float value = a[globalId];\n"
+        "    for(int i = 0; i < 16; i++) {\n"
+        "        value = value * 0.5f + sin(value) * BENCHMARK_RUN;\n"
+        "    }\n"
+        "    b[globalId] = value;\n"
+        "}\n";
+
+    const std::string salt = std::to_string(
+                std::chrono::steady_clock::now().time_since_epoch().count());
+
+    double sum = 0.0;
+    double minimum = 0.0;
+    for(uint32_t i = 0; i < m_config.compileRuns; i++)
+    {
+        KernelBuildOptions options;
+        options.defines["BENCHMARK_RUN"] = std::to_string(i + 1) + ".0f";
+        options.defines["BENCHMARK_SALT"] = salt;
+
+        GpuData data;
+        const TimePoint start = std::chrono::steady_clock::now();
+        if(m_interface->addKernel(data, "compute", kernelCode, options, error) == false) {
+            return false;
+        }
+        const TimePoint end = std::chrono::steady_clock::now();
+        m_interface->closeDevice(data);
+
+        const double duration = getDuration(start, end) * 1000.0;
+        sum += duration;
+        if(i == 0 || duration < minimum) {
+            minimum = duration;
+        }
+    }
+
+    m_compileResult.runs = m_config.compileRuns;
+    if(m_config.compileRuns > 0)
+    {
+        m_compileResult.meanMs = sum / m_config.compileRuns;
+        m_compileResult.minMs = minimum;
+    }
+
+    return true;
+}
+
+/**
+ * @brief measure the round-trip time from the enqueue of an empty kernel until its end is
+ *        visible on the host
+ *
+ * @param numberOfThreads number of threads, which launch kernels at the same time
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+ThroughputBenchmark::measureLatency(const uint32_t numberOfThreads,
+                                    ErrorContainer &error)
+{
+    const std::string kernelCode = "__kernel void empty() {}\n";
+    const uint32_t iterations = m_config.latencyIterations;
+
+    std::vector<double> means(numberOfThreads, 0.0);
+    std::vector<double> minimums(numberOfThreads, 0.0);
+
+    auto worker = [&](const uint32_t threadId, ErrorContainer &threadError) -> bool
+    {
+        GpuData data;
+        data.numberOfWg = {1, 1, 1};
+        data.threadsPerWg = {1, 1, 1};
+        if(m_interface->addKernel(data, "empty", kernelCode, threadError) == false) {
+            return false;
+        }
+
+        // warm-up, which creates the queue of the thread
+        GpuEvent warmUp;
+        if(m_interface->runAsync(data, "empty", warmUp, threadError) == false
+                || warmUp.wait() == false)
+        {
+            return false;
+        }
+
+        double sum = 0.0;
+        double minimum = 0.0;
+        for(uint32_t i = 0; i < iterations; i++)
+        {
+            const TimePoint start = std::chrono::steady_clock::now();
+            GpuEvent event;
+            if(m_interface->runAsync(data, "empty", event, threadError) == false
+                    || event.wait() == false)
+            {
+                return false;
+            }
+            const double duration = getDuration(start, std::chrono::steady_clock::now());
+
+            sum += duration;
+            if(i == 0 || duration < minimum) {
+                minimum = duration;
+            }
+        }
+
+        if(iterations > 0)
+        {
+            means[threadId] = (sum / iterations) * 1000000.0;
+            minimums[threadId] = minimum * 1000000.0;
+        }
+
+        return m_interface->closeDevice(data);
+    };
+
+    if(runThreads(numberOfThreads, worker, error) == false) {
+        return false;
+    }
+
+    LatencyResult result;
+    result.threads = numberOfThreads;
+    result.iterations = iterations;
+    for(uint32_t i = 0; i < numberOfThreads; i++)
+    {
+        result.meanUs += means[i] / numberOfThreads;
+        if(i == 0 || minimums[i] < result.minUs) {
+            result.minUs = minimums[i];
+        }
+    }
+    m_latencyResults.push_back(result);
+
+    return true;
+}
+
+/**
+ * @brief measure the bandwidth of transfers from host to device, device to host and within the
+ *        device. All threads start each transfer-type together and the bandwidth is the sum of
+ *        all threads.
+ *
+ * @param bufferSize number of bytes of each transfer
+ * @param numberOfThreads number of threads, which transfer their own buffer at the same time
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+ThroughputBenchmark::measureBandwidth(const uint64_t bufferSize,
+                                      const uint32_t numberOfThreads,
+                                      ErrorContainer &error)
+{
+    const uint64_t numberOfObjects = bufferSize / sizeof(float);
+    const uint32_t iterations = getNumberOfIterations(bufferSize);
+    const uint32_t numberOfPhases = 3;
+
+    PhaseBarrier barrier(numberOfThreads);
+    std::vector<TimePoint> timestamps(numberOfPhases + 1);
+
+    auto worker = [&](const uint32_t threadId, ErrorContainer &threadError) -> bool
+    {
+        // the memory is reused by the next measurement with the same buffer-size
+        GpuData data(m_interface->getBufferPool());
+        data.addBuffer("source", numberOfObjects, sizeof(float), false);
+        data.addBuffer("target", numberOfObjects, sizeof(float), false);
+        if(m_interface->initCopyToDevice(data, threadError) == false)
+        {
+            barrier.abort();
+            m_interface->closeDevice(data);
+            return false;
+        }
+
+        for(uint32_t phase = 0; phase < numberOfPhases; phase++)
+        {
+            if(barrier.wait() == false)
+            {
+                m_interface->closeDevice(data);
+                return false;
+            }
+            if(threadId == 0) {
+                timestamps[phase] = std::chrono::steady_clock::now();
+            }
+
+            bool success = true;
+            for(uint32_t i = 0; i < iterations && success; i++)
+            {
+                GpuEvent event;
+                if(phase == 0)
+                {
+                    success = m_interface->updateBufferOnDeviceAsync(data,
+                                                                     "source",
+                                                                     event,
+                                                                     threadError)
+                              && event.wait();
+                }
+                else if(phase == 1)
+                {
+                    success = m_interface->copyFromDeviceAsync(data, "target", event, threadError)
+                              && event.wait();
+                }
+                else
+                {
+                    // copy on the queue of the thread, so the threads don't wait for each other
+                    success = m_interface->copyBufferOnDeviceAsync(data,
+                                                                   "source",
+                                                                   "target",
+                                                                   event,
+                                                                   threadError)
+                              && event.wait();
+                }
+            }
+
+            if(success == false)
+            {
+                barrier.abort();
+                m_interface->closeDevice(data);
+                return false;
+            }
+        }
+
+        const bool finished = barrier.wait();
+        if(finished && threadId == 0) {
+            timestamps[numberOfPhases] = std::chrono::steady_clock::now();
+        }
+
+        return m_interface->closeDevice(data) && finished;
+    };
+
+    if(runThreads(numberOfThreads, worker, error) == false) {
+        return false;
+    }
+
+    const double totalBytes = static_cast<double>(bufferSize) * iterations * numberOfThreads;
+
+    BandwidthResult result;
+    result.bufferSize = bufferSize;
+    result.threads = numberOfThreads;
+    result.iterations = iterations;
+    result.hostToDevice = totalBytes / getDuration(timestamps[0], timestamps[1]) / 1e9;
+    result.deviceToHost = totalBytes / getDuration(timestamps[1], timestamps[2]) / 1e9;
+    result.deviceToDevice = totalBytes / getDuration(timestamps[2], timestamps[3]) / 1e9;
+    m_bandwidthResults.push_back(result);
+
+    return true;
+}
+
+/**
+ * @brief measure complete iterations of upload, kernel-run and download, like a serving thread
+ *        would process its requests
+ *
+ * @param numberOfThreads number of threads, which are processing iterations at the same time
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+ThroughputBenchmark::measureEndToEnd(const uint32_t numberOfThreads,
+                                     ErrorContainer &error)
+{
+    const std::string kernelCode =
+        "__kernel void add_one(\n"
+        "       __global const float* input,\n"
+        "       __global float* output,\n"
+        "       const ulong size\n"
+        "       )\n"
+        "{\n"
+        "    size_t globalId = get_global_id(0);\n"
+        "    if(globalId < size) {\n"
+        "        output[globalId] = input[globalId] + 1.0f;\n"
+        "    }\n"
+        "}\n";
+
+    const uint64_t numberOfObjects = m_config.endToEndSize / sizeof(float);
+    const uint32_t iterations = m_config.endToEndIterations;
+
+    PhaseBarrier barrier(numberOfThreads);
+    TimePoint start;
+    TimePoint end;
+
+    auto worker = [&](const uint32_t threadId, ErrorContainer &threadError) -> bool
+    {
+        GpuData data;
+        data.addBuffer("input", numberOfObjects, sizeof(float), false);
+        data.addBuffer("output", numberOfObjects, sizeof(float), false);
+
+        WorkerDim problemSize;
+        problemSize.x = numberOfObjects;
+        const uint64_t size = numberOfObjects;
+
+        bool success = m_interface->initCopyToDevice(data, threadError)
+                       && m_interface->addKernel(data, "add_one", kernelCode, threadError)
+                       && m_interface->bindKernelToBuffer(data, "add_one", "input", threadError)
+                       && m_interface->bindKernelToBuffer(data, "add_one", "output", threadError)
+                       && m_interface->setKernelArgument(data, "add_one", "size", size, threadError)
+                       && m_interface->calculateRange(data, "add_one", problemSize, threadError);
+        if(success == false)
+        {
+            barrier.abort();
+            m_interface->closeDevice(data);
+            return false;
+        }
+
+        if(barrier.wait() == false)
+        {
+            m_interface->closeDevice(data);
+            return false;
+        }
+        if(threadId == 0) {
+            start = std::chrono::steady_clock::now();
+        }
+
+        // all operations of the thread are in the same in-order queue, so only the download
+        // has to be waited for
+        for(uint32_t i = 0; i < iterations && success; i++)
+        {
+            GpuEvent updateEvent;
+            GpuEvent runEvent;
+            GpuEvent copyEvent;
+            success = m_interface->updateBufferOnDeviceAsync(data,
+                                                             "input",
+                                                             updateEvent,
+                                                             threadError)
+                      && m_interface->runAsync(data, "add_one", runEvent, threadError)
+                      && m_interface->copyFromDeviceAsync(data, "output", copyEvent, threadError)
+                      && copyEvent.wait();
+        }
+
+        if(success == false)
+        {
+            barrier.abort();
+            m_interface->closeDevice(data);
+            return false;
+        }
+
+        const bool finished = barrier.wait();
+        if(finished && threadId == 0) {
+            end = std::chrono::steady_clock::now();
+        }
+
+        return m_interface->closeDevice(data) && finished;
+    };
+
+    if(runThreads(numberOfThreads, worker, error) == false) {
+        return false;
+    }
+
+    EndToEndResult result;
+    result.threads = numberOfThreads;
+    result.bufferSize = numberOfObjects * sizeof(float);
+    result.iterations = static_cast<uint64_t>(iterations) * numberOfThreads;
+    result.iterationsPerSecond = result.iterations / getDuration(start, end);
+    m_endToEndResults.push_back(result);
+
+    return true;
+}
+
+/**
+ * @brief run a function in multiple threads and wait for all of them
+ *
+ * @param numberOfThreads number of threads
+ * @param function function to run, which gets the id of the thread
+ * @param error reference for error-output, which gets the errors of all failed threads
+ *
+ * @return false, if at least one thread failed, else true
+ */
+bool
+ThroughputBenchmark::runThreads(const uint32_t numberOfThreads,
+                                const ThreadFunction &function,
+                                ErrorContainer &error)
+{
+    std::vector<ErrorContainer> errors(numberOfThreads);
+    std::vector<uint8_t> results(numberOfThreads, 0);
+    std::vector<std::thread> threads;
+
+    for(uint32_t i = 0; i < numberOfThreads; i++)
+    {
+        threads.emplace_back([&, i]()
+        {
+            results[i] = function(i, errors[i]);
+
+            // each measurement starts new threads, so the queues of the old ones are removed
+            if(m_interface->releaseThreadQueue() == false)
+            {
+                errors[i].addMeesage("failed to release queue of the thread");
+                results[i] = 0;
+            }
+        });
+    }
+
+    for(std::thread &thread : threads) {
+        thread.join();
+    }
+
+    bool success = true;
+    for(uint32_t i = 0; i < numberOfThreads; i++)
+    {
+        if(results[i] == 0)
+        {
+            error.addMeesage("benchmark-thread " + std::to_string(i) + " failed:\n"
+                             + errors[i].toString());
+            success = false;
+        }
+    }
+
+    return success;
+}
+
+/**
+ * @brief get number of transfers for a buffer-size, so small buffer are measured often enough
+ *        for a stable result and big buffer don't take too long
+ *
+ * @param bufferSize number of bytes of the buffer
+ *
+ * @return number of iterations
+ */
+uint32_t
+ThroughputBenchmark::getNumberOfIterations(const uint64_t bufferSize) const
+{
+    const uint64_t bytesPerMeasurement = 256ULL * 1024 * 1024;
+    const uint64_t iterations = bytesPerMeasurement / bufferSize;
+
+    return static_cast<uint32_t>(std::clamp(iterations,
+                                            static_cast<uint64_t>(3),
+                                            static_cast<uint64_t>(1000)));
+}
+
+/**
+ * @brief get time between two points
+ *
+ * @param start start-time
+ * @param end end-time
+ *
+ * @return duration in seconds
+ */
+double
+ThroughputBenchmark::getDuration(const TimePoint &start,
+                                 const TimePoint &end) const
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / 1e9;
+}
+
+}
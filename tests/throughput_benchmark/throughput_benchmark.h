@@ -0,0 +1,166 @@
+/**
+ * @file        throughput_benchmark.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef THROUGHPUT_BENCHMARK_H
+#define THROUGHPUT_BENCHMARK_H
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+#include <libKitsunemimiCommon/logger.h>
+
+namespace Kitsunemimi
+{
+class GpuHandler;
+class GpuInterface;
+
+struct BenchmarkConfig
+{
+    // device-selection (all, cpu or gpu) and index within the ranked matching devices
+    std::string deviceType = "all";
+    uint32_t deviceId = 0;
+
+    // range of the buffer-sizes in bytes, which is swept by multiplying with 4
+    uint64_t minBufferSize = 4ULL * 1024;
+    uint64_t maxBufferSize = 1024ULL * 1024 * 1024;
+    // maximum number of bytes, which are allocated by all threads together
+    uint64_t maxTotalSize = 2048ULL * 1024 * 1024;
+
+    std::vector<uint32_t> threadCounts = {1, 2, 4, 8};
+
+    uint32_t latencyIterations = 1000;
+    uint32_t compileRuns = 5;
+    uint64_t endToEndSize = 1024ULL * 1024;
+    uint32_t endToEndIterations = 200;
+
+    // path of the json-output (empty = stdout)
+    std::string outputPath = "";
+};
+
+class ThroughputBenchmark
+{
+public:
+    ThroughputBenchmark(const BenchmarkConfig &config);
+    ~ThroughputBenchmark();
+
+    bool run(ErrorContainer &error);
+    const std::string toJson() const;
+
+private:
+    struct CompileResult
+    {
+        uint32_t runs = 0;
+        double meanMs = 0.0;
+        double minMs = 0.0;
+    };
+
+    struct LatencyResult
+    {
+        uint32_t threads = 0;
+        uint32_t iterations = 0;
+        double meanUs = 0.0;
+        double minUs = 0.0;
+    };
+
+    struct BandwidthResult
+    {
+        uint64_t bufferSize = 0;
+        uint32_t threads = 0;
+        uint32_t iterations = 0;
+        double hostToDevice = 0.0;
+        double deviceToHost = 0.0;
+        double deviceToDevice = 0.0;
+    };
+
+    struct EndToEndResult
+    {
+        uint32_t threads = 0;
+        uint64_t bufferSize = 0;
+        uint64_t iterations = 0;
+        double iterationsPerSecond = 0.0;
+    };
+
+    struct SkippedRun
+    {
+        uint64_t bufferSize = 0;
+        uint32_t threads = 0;
+        std::string reason = "";
+    };
+
+    // simple reusable barrier to start and end the measured phases of all threads together
+    class PhaseBarrier
+    {
+    public:
+        PhaseBarrier(const uint32_t numberOfThreads);
+        bool wait();
+        void abort();
+
+    private:
+        std::mutex m_lock;
+        std::condition_variable m_cv;
+        uint32_t m_numberOfThreads = 0;
+        uint32_t m_waiting = 0;
+        uint64_t m_generation = 0;
+        bool m_aborted = false;
+    };
+
+    typedef std::chrono::steady_clock::time_point TimePoint;
+    typedef std::function<bool(const uint32_t, ErrorContainer&)> ThreadFunction;
+
+    BenchmarkConfig m_config;
+    GpuHandler* m_handler = nullptr;
+    GpuInterface* m_interface = nullptr;
+
+    CompileResult m_compileResult;
+    std::vector<LatencyResult> m_latencyResults;
+    std::vector<BandwidthResult> m_bandwidthResults;
+    std::vector<EndToEndResult> m_endToEndResults;
+    std::vector<SkippedRun> m_skippedRuns;
+
+    bool initDevice(ErrorContainer &error);
+
+    bool measureCompileTime(ErrorContainer &error);
+    bool measureLatency(const uint32_t numberOfThreads,
+                        ErrorContainer &error);
+    bool measureBandwidth(const uint64_t bufferSize,
+                          const uint32_t numberOfThreads,
+                          ErrorContainer &error);
+    bool measureEndToEnd(const uint32_t numberOfThreads,
+                         ErrorContainer &error);
+
+    bool runThreads(const uint32_t numberOfThreads,
+                    const ThreadFunction &function,
+                    ErrorContainer &error);
+
+    uint32_t getNumberOfIterations(const uint64_t bufferSize) const;
+    double getDuration(const TimePoint &start,
+                       const TimePoint &end) const;
+};
+
+}
+
+#endif // THROUGHPUT_BENCHMARK_H